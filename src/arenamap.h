@@ -0,0 +1,349 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_ARENAMAP_H
+#define BITCOIN_ARENAMAP_H
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Hash map for many small entries, such as the UTXO cache.
+ *
+ * std::unordered_map makes an allocation per entry and keeps a bucket pointer
+ * besides. Here, entries are constructed in chunks of 64, and looked up
+ * through an open addressing index of 8 bytes per slot, with linear probing.
+ * Each slot holds the entry's position and 32 bits of its hash, so that
+ * probing rarely touches other entries and growing the index doesn't need to
+ * hash them again.
+ *
+ * As with std::unordered_map, references to an entry stay valid until it is
+ * erased. Iteration goes through the chunks in order. Entries may be erased
+ * while iterating, but not inserted. Only the part of the std::unordered_map
+ * interface that is used with it is provided.
+ */
+template<typename K, typename T, typename Hash>
+class arenamap
+{
+public:
+    typedef K key_type;
+    typedef T mapped_type;
+    typedef std::pair<const K, T> value_type;
+    typedef size_t size_type;
+
+private:
+    static const uint32_t CHUNK_BITS = 6;
+    static const uint32_t CHUNK_SIZE = 1 << CHUNK_BITS;
+    //! Position of no entry, used for the end of iteration, empty slots and the end of the free list
+    static const uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    typedef typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type Storage;
+
+    struct Chunk {
+        //! Bit i is set if entry i is constructed
+        uint64_t live;
+        Storage entries[CHUNK_SIZE];
+    };
+
+    struct Slot {
+        uint32_t pos;
+        uint32_t hash;
+    };
+
+    Hash hasher;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::vector<Slot> index;
+    //! Number of positions handed out so far
+    uint32_t nEnd;
+    //! Erased positions are chained through their storage, from nFree
+    uint32_t nFree;
+    size_t nSize;
+
+    Storage& At(uint32_t pos) const { return chunks[pos >> CHUNK_BITS]->entries[pos & (CHUNK_SIZE - 1)]; }
+    value_type& Entry(uint32_t pos) const { return *reinterpret_cast<value_type*>(&At(pos)); }
+
+    uint32_t NextLive(uint32_t pos) const
+    {
+        while (pos < nEnd) {
+            uint64_t live = chunks[pos >> CHUNK_BITS]->live >> (pos & (CHUNK_SIZE - 1));
+            if (live == 0) {
+                pos = (pos | (CHUNK_SIZE - 1)) + 1;
+                continue;
+            }
+            while (!(live & 1)) {
+                live >>= 1;
+                pos++;
+            }
+            return pos;
+        }
+        return NONE;
+    }
+
+    uint32_t HashOf(const K& key) const { return (uint32_t)hasher(key); }
+
+    //! Slot of key, or NONE
+    size_t FindSlot(const K& key, uint32_t hash) const
+    {
+        if (index.empty()) return NONE;
+        const size_t mask = index.size() - 1;
+        for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+            const Slot& slot = index[i];
+            if (slot.pos == NONE) return NONE;
+            if (slot.hash == hash && Entry(slot.pos).first == key) return i;
+        }
+    }
+
+    void InsertSlot(uint32_t pos, uint32_t hash)
+    {
+        const size_t mask = index.size() - 1;
+        size_t i = hash & mask;
+        while (index[i].pos != NONE) {
+            i = (i + 1) & mask;
+        }
+        index[i].pos = pos;
+        index[i].hash = hash;
+    }
+
+    //! Empty slot i, moving back the slots after it that would otherwise not be found
+    void EraseSlot(size_t i)
+    {
+        const size_t mask = index.size() - 1;
+        for (size_t j = (i + 1) & mask; index[j].pos != NONE; j = (j + 1) & mask) {
+            size_t home = index[j].hash & mask;
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                index[i] = index[j];
+                i = j;
+            }
+        }
+        index[i].pos = NONE;
+    }
+
+    //! Grow the index so that it is at most three quarters full with n entries
+    void Reserve(size_t n)
+    {
+        size_t nSlots = index.empty() ? 16 : index.size();
+        while (n * 4 > nSlots * 3) {
+            nSlots *= 2;
+        }
+        if (nSlots == index.size()) return;
+        std::vector<Slot> old(nSlots, Slot{NONE, 0});
+        old.swap(index);
+        for (const Slot& slot : old) {
+            if (slot.pos != NONE) InsertSlot(slot.pos, slot.hash);
+        }
+    }
+
+    uint32_t Allocate()
+    {
+        if (nFree != NONE) {
+            uint32_t pos = nFree;
+            memcpy(&nFree, &At(pos), sizeof(nFree));
+            return pos;
+        }
+        assert(nEnd < NONE);
+        if ((nEnd & (CHUNK_SIZE - 1)) == 0) {
+            chunks.emplace_back(new Chunk);
+            chunks.back()->live = 0;
+        }
+        return nEnd++;
+    }
+
+    void Release(uint32_t pos)
+    {
+        memcpy(&At(pos), &nFree, sizeof(nFree));
+        nFree = pos;
+    }
+
+    void Destroy(uint32_t pos)
+    {
+        Entry(pos).~value_type();
+        chunks[pos >> CHUNK_BITS]->live &= ~((uint64_t)1 << (pos & (CHUNK_SIZE - 1)));
+        Release(pos);
+        nSize--;
+    }
+
+public:
+    template<bool Const>
+    class iterator_base
+    {
+        friend class arenamap;
+        template<bool> friend class iterator_base;
+        typedef typename std::conditional<Const, const arenamap, arenamap>::type map_type;
+
+        map_type* map;
+        uint32_t pos;
+
+        iterator_base(map_type* mapIn, uint32_t posIn) : map(mapIn), pos(posIn) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename arenamap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<Const, const value_type*, value_type*>::type pointer;
+        typedef typename std::conditional<Const, const value_type&, value_type&>::type reference;
+
+        iterator_base() : map(nullptr), pos(NONE) {}
+        //! Make a const_iterator from an iterator
+        template<bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+        iterator_base(const iterator_base<OtherConst>& it) : map(it.map), pos(it.pos) {}
+
+        reference operator*() const { return map->Entry(pos); }
+        pointer operator->() const { return &map->Entry(pos); }
+        iterator_base& operator++() { pos = map->NextLive(pos + 1); return *this; }
+        iterator_base operator++(int) { iterator_base copy(*this); ++*this; return copy; }
+        friend bool operator==(const iterator_base& a, const iterator_base& b) { return a.pos == b.pos; }
+        friend bool operator!=(const iterator_base& a, const iterator_base& b) { return a.pos != b.pos; }
+    };
+
+    typedef iterator_base<false> iterator;
+    typedef iterator_base<true> const_iterator;
+
+    arenamap() : nEnd(0), nFree(NONE), nSize(0) {}
+    ~arenamap() { clear(); }
+
+    arenamap(const arenamap&) = delete;
+    arenamap& operator=(const arenamap&) = delete;
+
+    iterator begin() { return iterator(this, NextLive(0)); }
+    const_iterator begin() const { return const_iterator(this, NextLive(0)); }
+    iterator end() { return iterator(this, NONE); }
+    const_iterator end() const { return const_iterator(this, NONE); }
+
+    size_t size() const { return nSize; }
+    bool empty() const { return nSize == 0; }
+
+    iterator find(const K& key)
+    {
+        size_t i = FindSlot(key, HashOf(key));
+        return iterator(this, i == NONE ? NONE : index[i].pos);
+    }
+
+    const_iterator find(const K& key) const
+    {
+        size_t i = FindSlot(key, HashOf(key));
+        return const_iterator(this, i == NONE ? NONE : index[i].pos);
+    }
+
+    size_t count(const K& key) const { return FindSlot(key, HashOf(key)) == NONE ? 0 : 1; }
+
+    T& at(const K& key)
+    {
+        iterator it = find(key);
+        if (it == end()) throw std::out_of_range("arenamap::at");
+        return it->second;
+    }
+
+    const T& at(const K& key) const
+    {
+        const_iterator it = find(key);
+        if (it == end()) throw std::out_of_range("arenamap::at");
+        return it->second;
+    }
+
+    /** Construct the value of key from args, unless key is present already */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+    {
+        const uint32_t hash = HashOf(key);
+        size_t i = FindSlot(key, hash);
+        if (i != NONE) return std::make_pair(iterator(this, index[i].pos), false);
+        Reserve(nSize + 1);
+        uint32_t pos = Allocate();
+        try {
+            new (&At(pos)) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        } catch (...) {
+            Release(pos);
+            throw;
+        }
+        chunks[pos >> CHUNK_BITS]->live |= (uint64_t)1 << (pos & (CHUNK_SIZE - 1));
+        InsertSlot(pos, hash);
+        nSize++;
+        return std::make_pair(iterator(this, pos), true);
+    }
+
+    template<typename KArg>
+    std::pair<iterator, bool> emplace(std::piecewise_construct_t, std::tuple<KArg> key, std::tuple<>)
+    {
+        return try_emplace(std::get<0>(key));
+    }
+
+    template<typename KArg, typename TArg>
+    std::pair<iterator, bool> emplace(std::piecewise_construct_t, std::tuple<KArg> key, std::tuple<TArg> value)
+    {
+        return try_emplace(std::get<0>(key), std::forward<TArg>(std::get<0>(value)));
+    }
+
+    template<typename TArg>
+    std::pair<iterator, bool> emplace(const K& key, TArg&& value)
+    {
+        return try_emplace(key, std::forward<TArg>(value));
+    }
+
+    T& operator[](const K& key) { return try_emplace(key).first->second; }
+
+    /** Erase the entry at it, returning the next one */
+    iterator erase(const_iterator it)
+    {
+        size_t i = FindSlot(it->first, HashOf(it->first));
+        assert(i != NONE && index[i].pos == it.pos);
+        EraseSlot(i);
+        Destroy(it.pos);
+        return iterator(this, NextLive(it.pos + 1));
+    }
+
+    size_t erase(const K& key)
+    {
+        size_t i = FindSlot(key, HashOf(key));
+        if (i == NONE) return 0;
+        uint32_t pos = index[i].pos;
+        EraseSlot(i);
+        Destroy(pos);
+        return 1;
+    }
+
+    /** Erase all entries, and free all memory */
+    void clear()
+    {
+        for (uint32_t pos = NextLive(0); pos != NONE; pos = NextLive(pos + 1)) {
+            Entry(pos).~value_type();
+        }
+        std::vector<std::unique_ptr<Chunk>>().swap(chunks);
+        std::vector<Slot>().swap(index);
+        nEnd = 0;
+        nFree = NONE;
+        nSize = 0;
+    }
+
+    void reserve(size_t n) { Reserve(n); }
+
+    void swap(arenamap& other)
+    {
+        std::swap(hasher, other.hasher);
+        chunks.swap(other.chunks);
+        index.swap(other.index);
+        std::swap(nEnd, other.nEnd);
+        std::swap(nFree, other.nFree);
+        std::swap(nSize, other.nSize);
+    }
+
+    //! Number of chunks allocated, and bytes in each, to account for memory usage
+    size_t chunk_count() const { return chunks.size(); }
+    static size_t chunk_bytes() { return sizeof(Chunk); }
+    //! Bytes allocated for the list of chunks and for the index
+    size_t chunk_list_bytes() const { return chunks.capacity() * sizeof(chunks[0]); }
+    size_t index_bytes() const { return index.capacity() * sizeof(Slot); }
+};
+
+#endif // BITCOIN_ARENAMAP_H
@@ -6,10 +6,34 @@
 #include "perf.h"
 
 #include <assert.h>
+#include <atomic>
+#include <cstdlib>
 #include <iostream>
 #include <iomanip>
+#include <new>
 #include <sys/time.h>
 
+static std::atomic<uint64_t> g_allocations(0);
+
+// Count every heap allocation, so benchmarks can report how many allocations one iteration makes
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+uint64_t benchmark::GetAllocationCount()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
 benchmark::BenchRunner::BenchmarkMap &benchmark::BenchRunner::benchmarks() {
     static std::map<std::string, benchmark::BenchFunction> benchmarks_map;
     return benchmarks_map;
@@ -31,7 +55,8 @@ benchmark::BenchRunner::RunAll(double elapsedTimeForOne)
 {
     perf_init();
     std::cout << "#Benchmark" << "," << "count" << "," << "min" << "," << "max" << "," << "average" << ","
-              << "min_cycles" << "," << "max_cycles" << "," << "average_cycles" << "\n";
+              << "min_cycles" << "," << "max_cycles" << "," << "average_cycles" << "," << "average_allocations" << ","
+              << "per_second" << "\n";
 
     for (const auto &p: benchmarks()) {
         State state(p.first, elapsedTimeForOne);
@@ -51,6 +76,7 @@ bool benchmark::State::KeepRunning()
     if (count == 0) {
         lastTime = beginTime = now = gettimedouble();
         lastCycles = beginCycles = nowCycles = perf_cpucycles();
+        beginAllocations = GetAllocationCount();
     }
     else {
         now = gettimedouble();
@@ -98,8 +124,10 @@ bool benchmark::State::KeepRunning()
     // Output results
     double average = (now-beginTime)/count;
     int64_t averageCycles = (nowCycles-beginCycles)/count;
+    double averageAllocations = (double)(GetAllocationCount() - beginAllocations) / count;
     std::cout << std::fixed << std::setprecision(15) << name << "," << count << "," << minTime << "," << maxTime << "," << average << ","
-              << minCycles << "," << maxCycles << "," << averageCycles << "\n";
+              << minCycles << "," << maxCycles << "," << averageCycles << "," << std::setprecision(2) << averageAllocations << ","
+              << 1 / average << "\n";
     std::cout.copyfmt(std::ios(nullptr));
 
     return false;
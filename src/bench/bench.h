@@ -48,6 +48,7 @@ namespace benchmark {
         uint64_t lastCycles;
         uint64_t minCycles;
         uint64_t maxCycles;
+        uint64_t beginAllocations;
     public:
         State(std::string _name, double _maxElapsed) : name(_name), maxElapsed(_maxElapsed), count(0) {
             minTime = std::numeric_limits<double>::max();
@@ -62,6 +63,9 @@ namespace benchmark {
 
     typedef std::function<void(State&)> BenchFunction;
 
+    /** Number of times operator new has been called so far */
+    uint64_t GetAllocationCount();
+
     class BenchRunner
     {
         typedef std::map<std::string, BenchFunction> BenchmarkMap;
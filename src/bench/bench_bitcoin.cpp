@@ -4,6 +4,9 @@
 
 #include "bench.h"
 
+#include "crypto/dag.h"
+#include "crypto/scrypt.h"
+#include "crypto/sph_autodetect.h"
 #include "crypto/sha256.h"
 #include "key.h"
 #include "validation.h"
@@ -14,6 +17,10 @@ int
 main(int argc, char** argv)
 {
     SHA256AutoDetect();
+    DAGAutoDetect();
+    CubeHashAutoDetect();
+    Lyra2AutoDetect();
+    scrypt_detect_avx2();
     RandomInit();
     ECC_Start();
     SetupEnvironment();
@@ -5,6 +5,7 @@
 #include "bench.h"
 #include "coins.h"
 #include "policy/policy.h"
+#include "random.h"
 #include "wallet/crypter.h"
 
 #include <vector>
@@ -84,4 +85,58 @@ static void CCoinsCaching(benchmark::State& state)
     }
 }
 
+// Fill a large cache with coins the way connecting blocks does, then look
+// them all up and spend them, as a benchmark of the cache's map itself.
+static void CCoinsCachingAddSpend(benchmark::State& state)
+{
+    static const int NUM_COINS = 100000;
+    FastRandomContext rng(true);
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(NUM_COINS);
+    for (int i = 0; i < NUM_COINS; i++) {
+        outpoints.emplace_back(rng.rand256(), rng.randrange(4));
+    }
+    const CTxOut txout(CENT, CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 1) << OP_EQUALVERIFY << OP_CHECKSIG);
+
+    while (state.KeepRunning()) {
+        CCoinsView coinsDummy;
+        CCoinsViewCache coins(&coinsDummy);
+        for (const COutPoint& outpoint : outpoints) {
+            coins.AddCoin(outpoint, Coin(txout, 1, false), false);
+        }
+        for (const COutPoint& outpoint : outpoints) {
+            bool found = coins.HaveCoinInCache(outpoint);
+            assert(found);
+        }
+        for (const COutPoint& outpoint : outpoints) {
+            coins.SpendCoin(outpoint);
+        }
+        assert(coins.GetCacheSize() == 0);
+    }
+}
+
+// Look up coins that are missing from a large cache, as for the inputs of
+// blocks that have to be read from the database.
+static void CCoinsCachingMiss(benchmark::State& state)
+{
+    static const int NUM_COINS = 100000;
+    FastRandomContext rng(true);
+    CCoinsView coinsDummy;
+    CCoinsViewCache coins(&coinsDummy);
+    const CTxOut txout(CENT, CScript() << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 1) << OP_EQUALVERIFY << OP_CHECKSIG);
+    for (int i = 0; i < NUM_COINS; i++) {
+        coins.AddCoin(COutPoint(rng.rand256(), 0), Coin(txout, 1, false), false);
+    }
+    const COutPoint missing(rng.rand256(), 0);
+
+    while (state.KeepRunning()) {
+        for (int i = 0; i < 1000; i++) {
+            bool found = coins.HaveCoinInCache(COutPoint(missing.hash, i));
+            assert(!found);
+        }
+    }
+}
+
 BENCHMARK(CCoinsCaching);
+BENCHMARK(CCoinsCachingAddSpend);
+BENCHMARK(CCoinsCachingMiss);
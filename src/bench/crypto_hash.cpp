@@ -14,6 +14,9 @@
 #include "crypto/sha1.h"
 #include "crypto/sha256.h"
 #include "crypto/sha512.h"
+#include "crypto/sph_blake.h"
+#include "crypto/sph_bmw.h"
+#include "crypto/sph_cubehash.h"
 
 /* Number of bytes to hash per iteration */
 static const uint64_t BUFFER_SIZE = 1000*1000;
@@ -52,6 +55,14 @@ static void SHA256_32b(benchmark::State& state)
     }
 }
 
+static void SHA256D64_1024(benchmark::State& state)
+{
+    std::vector<uint8_t> in(64 * 1024, 0);
+    while (state.KeepRunning()) {
+        SHA256D64(in.data(), in.data(), 1024);
+    }
+}
+
 static void SHA512(benchmark::State& state)
 {
     uint8_t hash[CSHA512::OUTPUT_SIZE];
@@ -60,6 +71,47 @@ static void SHA512(benchmark::State& state)
         CSHA512().Write(in.data(), in.size()).Finalize(hash);
 }
 
+// The sph hashes chained by lyra2re2, on 32 bytes as they are used there: BLAKE-256 and BMW-256 once per hash,
+// CubeHash-256 twice
+static void BLAKE256_32b(benchmark::State& state)
+{
+    std::vector<uint8_t> in(32,0);
+    sph_blake256_context ctx;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < 1000000; i++) {
+            sph_blake256_init(&ctx);
+            sph_blake256(&ctx, in.data(), in.size());
+            sph_blake256_close(&ctx, in.data());
+        }
+    }
+}
+
+static void BMW256_32b(benchmark::State& state)
+{
+    std::vector<uint8_t> in(32,0);
+    sph_bmw256_context ctx;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < 1000000; i++) {
+            sph_bmw256_init(&ctx);
+            sph_bmw256(&ctx, in.data(), in.size());
+            sph_bmw256_close(&ctx, in.data());
+        }
+    }
+}
+
+static void CubeHash256_32b(benchmark::State& state)
+{
+    std::vector<uint8_t> in(32,0);
+    sph_cubehash256_context ctx;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < 1000000; i++) {
+            sph_cubehash256_init(&ctx);
+            sph_cubehash256(&ctx, in.data(), in.size());
+            sph_cubehash256_close(&ctx, in.data());
+        }
+    }
+}
+
 static void SipHash_32b(benchmark::State& state)
 {
     uint256 x;
@@ -98,6 +150,10 @@ BENCHMARK(SHA256);
 BENCHMARK(SHA512);
 
 BENCHMARK(SHA256_32b);
+BENCHMARK(SHA256D64_1024);
+BENCHMARK(BLAKE256_32b);
+BENCHMARK(BMW256_32b);
+BENCHMARK(CubeHash256_32b);
 BENCHMARK(SipHash_32b);
 BENCHMARK(FastRandom_32bit);
 BENCHMARK(FastRandom_1bit);
@@ -0,0 +1,124 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "chainparams.h"
+#include "crypto/dag.h"
+#include "crypto/Lyra2RE.h"
+#include "pow.h"
+#include "primitives/block.h"
+
+#include <array>
+#include <vector>
+
+static CBlockHeader DAGBenchHeader()
+{
+    CBlockHeader header;
+    header.nVersion = 0x20000100;
+    header.nTime = 1500000000;
+    header.nBits = 0x1e0ffff0;
+    header.height = 5;
+    return header;
+}
+
+// Deriving a single DAG item from the epoch's cache, as done 128 times per light hash
+static void DAGGetNode(benchmark::State& state)
+{
+    CDAGSystem::GetNode(0, 5);
+    uint64_t i = 0;
+    uint32_t x = 0;
+    while (state.KeepRunning()) {
+        x += CDAGSystem::GetNode(i++, 5).GetNodePtr()[0];
+    }
+}
+
+// Light verification of a header against the epoch's cache
+static void HashimotoLight(benchmark::State& state)
+{
+    CBlockHeader header = DAGBenchHeader();
+    CDAGSystem::Hashimoto(header);
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        CDAGSystem::Hashimoto(header);
+    }
+}
+
+// Full light proof of work check of a header, including the hashMix comparison
+static void HashimotoCheckProofOfWork(benchmark::State& state)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    CBlockHeader header = DAGBenchHeader();
+    header.hashMix = CDAGSystem::Hashimoto(header).GetCmix();
+    while (state.KeepRunning()) {
+        CheckProofOfWork(header, chainParams->GetConsensus());
+    }
+}
+
+// Graph verification of a header against a small synthetic epoch, as done for every nonce by the miner
+static void FastHashimotoSynthetic(benchmark::State& state)
+{
+    // 256KiB of cache and 4MiB of graph are generated in about a second, instead of minutes for the real sizes
+    static const uint64_t GRAPH_BYTES = 4 * 1024 * 1024;
+    CBlockHeader header = DAGBenchHeader();
+    CDAGEpochRef dag = CDAGSystem::CreateEpoch(CDAGSystem::GetEpoch(header.height), 256 * 1024, GRAPH_BYTES);
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        CDAGSystem::FastHashimoto(header, *dag, GRAPH_BYTES / 32); // 32 byte graph items
+    }
+}
+
+// Generation of a 1MiB epoch cache from its seed, which scales linearly to the 8MiB and more of real epochs
+static void DAGCreateCache(benchmark::State& state)
+{
+    std::array<uint8_t, 32> seed{};
+    std::vector<uint32_t> cache;
+    while (state.KeepRunning()) {
+        seed[0]++;
+        CDAGSystem::CreateCacheInPlace(seed, 1024 * 1024, cache);
+    }
+}
+
+// lyra2re2 hash of a header, as done for every nonce before its DAG accesses
+static void Lyra2RE2HeaderHash(benchmark::State& state)
+{
+    CBlockHeader header = DAGBenchHeader();
+    uint256 hash;
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        lyra2re2_hash((const char*)&header, (char*)hash.begin());
+    }
+}
+
+// The same, with the first 64 header bytes absorbed once up front as ScanNonces does
+static void Lyra2RE2HeaderHashMidstate(benchmark::State& state)
+{
+    CBlockHeader header = DAGBenchHeader();
+    lyra2re2_midstate midstate;
+    lyra2re2_midstate_init(&midstate, (const char*)&header);
+    uint256 hash;
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        lyra2re2_hash_midstate(&midstate, (const char*)&header + 64, (char*)hash.begin());
+    }
+}
+
+// lyra2re2 hash of the 52 bytes of header hash, height and cmix that give the final hashimoto result
+static void Lyra2RE2Hash52(benchmark::State& state)
+{
+    std::array<uint8_t, 52> input{};
+    uint256 hash;
+    while (state.KeepRunning()) {
+        input[0]++;
+        lyra2re2_hash52((const char*)input.data(), (char*)hash.begin());
+    }
+}
+
+BENCHMARK(DAGGetNode);
+BENCHMARK(HashimotoLight);
+BENCHMARK(HashimotoCheckProofOfWork);
+BENCHMARK(FastHashimotoSynthetic);
+BENCHMARK(DAGCreateCache);
+BENCHMARK(Lyra2RE2HeaderHash);
+BENCHMARK(Lyra2RE2HeaderHashMidstate);
+BENCHMARK(Lyra2RE2Hash52);
@@ -0,0 +1,44 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "consensus/merkle.h"
+#include "random.h"
+#include "uint256.h"
+
+#include <vector>
+
+// Root of a 9001 leaf tree, about the number of transactions of a full block of small ones
+static void MerkleRoot(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    std::vector<uint256> leaves(9001);
+    for (uint256& leaf : leaves) {
+        leaf = rng.rand256();
+    }
+    while (state.KeepRunning()) {
+        bool mutated = false;
+        uint256 root = ComputeMerkleRoot(leaves, &mutated);
+        leaves[mutated] = root;
+    }
+}
+
+// Root of the same tree for a new coinbase, from the coinbase's cached branch
+static void MerkleRootFromBranch(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    std::vector<uint256> leaves(9001);
+    for (uint256& leaf : leaves) {
+        leaf = rng.rand256();
+    }
+    const std::vector<uint256> branch = ComputeMerkleBranch(leaves, 0);
+    uint256 leaf = leaves[0];
+    while (state.KeepRunning()) {
+        leaf = ComputeMerkleRootFromBranch(leaf, branch, 0);
+    }
+}
+
+BENCHMARK(MerkleRoot);
+BENCHMARK(MerkleRootFromBranch);
@@ -0,0 +1,40 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "crypto/scrypt.h"
+#include "primitives/block.h"
+
+#include <vector>
+
+// scrypt proof of work hash of a pre-DAG header with the portable implementation
+static void ScryptGeneric(benchmark::State& state)
+{
+    CBlockHeader header;
+    std::vector<char> scratchpad(SCRYPT_SCRATCHPAD_SIZE);
+    uint256 hash;
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        scrypt_1024_1_1_256_sp_generic((const char*)&header, (char*)hash.begin(), scratchpad.data());
+    }
+}
+
+#if defined(USE_SSE2)
+// The same with the SSE2 implementation
+static void ScryptSSE2(benchmark::State& state)
+{
+    CBlockHeader header;
+    std::vector<char> scratchpad(SCRYPT_SCRATCHPAD_SIZE);
+    uint256 hash;
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        scrypt_1024_1_1_256_sp_sse2((const char*)&header, (char*)hash.begin(), scratchpad.data());
+    }
+}
+#endif
+
+BENCHMARK(ScryptGeneric);
+#if defined(USE_SSE2)
+BENCHMARK(ScryptSSE2);
+#endif
@@ -34,7 +34,7 @@ size_t CCoinsViewBacked::EstimateSize() const { return base->EstimateSize(); }
 
 SaltedOutpointHasher::SaltedOutpointHasher() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
 
-CCoinsViewCache::CCoinsViewCache(CCoinsView *baseIn) : CCoinsViewBacked(baseIn), cachedCoinsUsage(0) {}
+CCoinsViewCache::CCoinsViewCache(CCoinsView *baseIn) : CCoinsViewBacked(baseIn), cachedCoinsUsage(0), nUseClock(0) {}
 
 size_t CCoinsViewCache::DynamicMemoryUsage() const {
     return memusage::DynamicUsage(cacheCoins) + cachedCoinsUsage;
@@ -42,21 +42,34 @@ size_t CCoinsViewCache::DynamicMemoryUsage() const {
 
 CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const {
     CCoinsMap::iterator it = cacheCoins.find(outpoint);
-    if (it != cacheCoins.end())
+    if (it != cacheCoins.end()) {
+        Touch(it->second);
         return it;
+    }
     Coin tmp;
     if (!base->GetCoin(outpoint, tmp))
         return cacheCoins.end();
-    CCoinsMap::iterator ret = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::forward_as_tuple(std::move(tmp))).first;
+    return EmplaceFetchedCoin(outpoint, std::move(tmp));
+}
+
+CCoinsMap::iterator CCoinsViewCache::EmplaceFetchedCoin(const COutPoint &outpoint, Coin&& coin) const {
+    CCoinsMap::iterator ret = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::forward_as_tuple(std::move(coin))).first;
     if (ret->second.coin.IsSpent()) {
         // The parent only has an empty entry for this outpoint; we can consider our
         // version as fresh.
         ret->second.flags = CCoinsCacheEntry::FRESH;
     }
     cachedCoinsUsage += ret->second.coin.DynamicMemoryUsage();
+    Touch(ret->second);
     return ret;
 }
 
+void CCoinsViewCache::CacheCoin(const COutPoint &outpoint, Coin&& coin) {
+    if (cacheCoins.find(outpoint) == cacheCoins.end()) {
+        EmplaceFetchedCoin(outpoint, std::move(coin));
+    }
+}
+
 bool CCoinsViewCache::GetCoin(const COutPoint &outpoint, Coin &coin) const {
     CCoinsMap::const_iterator it = FetchCoin(outpoint);
     if (it != cacheCoins.end()) {
@@ -85,6 +98,7 @@ void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possi
     it->second.coin = std::move(coin);
     it->second.flags |= CCoinsCacheEntry::DIRTY | (fresh ? CCoinsCacheEntry::FRESH : 0);
     cachedCoinsUsage += it->second.coin.DynamicMemoryUsage();
+    Touch(it->second);
 }
 
 void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, bool check) {
@@ -164,6 +178,7 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
                     // and already exist in the grandparent
                     if (it->second.flags & CCoinsCacheEntry::FRESH)
                         entry.flags |= CCoinsCacheEntry::FRESH;
+                    Touch(entry);
                 }
             } else {
                 // Assert that the child cache entry was not marked FRESH if the
@@ -186,6 +201,7 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlockIn
                     itUs->second.coin = std::move(it->second.coin);
                     cachedCoinsUsage += itUs->second.coin.DynamicMemoryUsage();
                     itUs->second.flags |= CCoinsCacheEntry::DIRTY;
+                    Touch(itUs->second);
                     // NOTE: It is possible the child has a FRESH flag here in
                     // the event the entry we found in the parent is pruned. But
                     // we must not copy that FRESH flag to the parent as that
@@ -205,6 +221,50 @@ bool CCoinsViewCache::Flush() {
     bool fOk = base->BatchWrite(cacheCoins, hashBlock);
     cacheCoins.clear();
     cachedCoinsUsage = 0;
+    nUseClock = 0;
+    return fOk;
+}
+
+bool CCoinsViewCache::FlushAndTrim(size_t nTargetUsage) {
+    if (nTargetUsage == 0 || cacheCoins.empty()) {
+        return Flush();
+    }
+
+    // Sort the unspent coins into buckets by last use, and add up the buckets
+    // from the most recent one while they fit in nTargetUsage.
+    static const unsigned int USE_BUCKETS = 256;
+    const uint64_t nBucketWidth = (uint64_t)nUseClock / USE_BUCKETS + 1;
+    const size_t nEntryOverhead = memusage::DynamicUsage(cacheCoins) / cacheCoins.size();
+    std::vector<size_t> vBucketUsage(USE_BUCKETS, 0);
+    for (const auto& entry : cacheCoins) {
+        if (!entry.second.coin.IsSpent()) {
+            vBucketUsage[entry.second.nLastUse / nBucketWidth] += nEntryOverhead + entry.second.coin.DynamicMemoryUsage();
+        }
+    }
+    uint64_t nKeepFrom = (uint64_t)nUseClock + 1;
+    size_t nKeepUsage = 0;
+    for (unsigned int i = USE_BUCKETS; i-- > 0 && nKeepUsage + vBucketUsage[i] <= nTargetUsage; ) {
+        nKeepUsage += vBucketUsage[i];
+        nKeepFrom = i * nBucketWidth;
+    }
+
+    // Copy the coins to keep as clean entries, and hand the whole map to the
+    // base, which only needs the dirty ones. Their uses count from the oldest
+    // one kept, to make room on the clock.
+    CCoinsMap mapKeep;
+    size_t nKeepCoinsUsage = 0;
+    for (const auto& entry : cacheCoins) {
+        if (!entry.second.coin.IsSpent() && entry.second.nLastUse >= nKeepFrom) {
+            CCoinsCacheEntry& kept = mapKeep.emplace(std::piecewise_construct, std::forward_as_tuple(entry.first), std::forward_as_tuple(Coin(entry.second.coin))).first->second;
+            kept.nLastUse = entry.second.nLastUse - nKeepFrom;
+            nKeepCoinsUsage += kept.coin.DynamicMemoryUsage();
+        }
+    }
+    bool fOk = base->BatchWrite(cacheCoins, hashBlock);
+    cacheCoins.clear();
+    cacheCoins.swap(mapKeep);
+    cachedCoinsUsage = nKeepCoinsUsage;
+    nUseClock = cacheCoins.empty() ? 0 : nUseClock - nKeepFrom;
     return fOk;
 }
 
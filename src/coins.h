@@ -7,6 +7,7 @@
 #define BITCOIN_COINS_H
 
 #include "primitives/transaction.h"
+#include "arenamap.h"
 #include "compressor.h"
 #include "core_memusage.h"
 #include "hash.h"
@@ -17,6 +18,7 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <limits>
 #include <unordered_map>
 
 /**
@@ -85,7 +87,7 @@ class SaltedOutpointHasher
 {
 private:
     /** Salt */
-    const uint64_t k0, k1;
+    uint64_t k0, k1;
 
 public:
     SaltedOutpointHasher();
@@ -104,6 +106,7 @@ struct CCoinsCacheEntry
 {
     Coin coin; // The actual cached data.
     unsigned char flags;
+    uint32_t nLastUse; // The cache's use clock when this entry was last looked up or changed.
 
     enum Flags {
         DIRTY = (1 << 0), // This cache entry is potentially different from the version in the parent view.
@@ -115,11 +118,11 @@ struct CCoinsCacheEntry
          */
     };
 
-    CCoinsCacheEntry() : flags(0) {}
-    explicit CCoinsCacheEntry(Coin&& coin_) : coin(std::move(coin_)), flags(0) {}
+    CCoinsCacheEntry() : flags(0), nLastUse(0) {}
+    explicit CCoinsCacheEntry(Coin&& coin_) : coin(std::move(coin_)), flags(0), nLastUse(0) {}
 };
 
-typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
+typedef arenamap<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher> CCoinsMap;
 
 /** Cursor for iterating over CoinsView state */
 class CCoinsViewCursor
@@ -191,6 +194,7 @@ public:
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
     void SetBackend(CCoinsView &viewIn);
+    CCoinsView* GetBackend() const { return base; }
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     CCoinsViewCursor *Cursor() const override;
     size_t EstimateSize() const override;
@@ -211,6 +215,9 @@ protected:
     /* Cached dynamic memory usage for the inner Coin objects. */
     mutable size_t cachedCoinsUsage;
 
+    /* Ticks on every use of an entry, to tell which ones were used most recently. Saturates instead of wrapping. */
+    mutable uint32_t nUseClock;
+
 public:
     CCoinsViewCache(CCoinsView *baseIn);
 
@@ -231,6 +238,13 @@ public:
      */
     bool HaveCoinInCache(const COutPoint &outpoint) const;
 
+    /**
+     * Add a coin read from the backing view, as a lookup through this cache
+     * would have, unless the outpoint is cached already. This lets lookups be
+     * made ahead of time, in parallel, and their results added afterwards.
+     */
+    void CacheCoin(const COutPoint &outpoint, Coin&& coin);
+
     /**
      * Return a reference to Coin in the cache, or a pruned one if not found. This is
      * more efficient than GetCoin.
@@ -263,6 +277,14 @@ public:
      */
     bool Flush();
 
+    /**
+     * Push the modifications applied to this cache to its base like Flush, but
+     * keep the most recently used unspent coins cached, as clean entries, up
+     * to nTargetUsage bytes. Coins used at about the same time are kept or
+     * evicted together, so somewhat less than nTargetUsage may be kept.
+     */
+    bool FlushAndTrim(size_t nTargetUsage);
+
     /**
      * Removes the UTXO with the given outpoint from the cache, if it is
      * not modified.
@@ -290,6 +312,12 @@ public:
 
 private:
     CCoinsMap::iterator FetchCoin(const COutPoint &outpoint) const;
+    CCoinsMap::iterator EmplaceFetchedCoin(const COutPoint &outpoint, Coin&& coin) const;
+
+    void Touch(CCoinsCacheEntry &entry) const {
+        if (nUseClock != std::numeric_limits<uint32_t>::max()) nUseClock++;
+        entry.nLastUse = nUseClock;
+    }
 
     /**
      * By making the copy constructor private, we prevent accidentally using it when one intends to create a cache on top of a base cache.
@@ -12,8 +12,17 @@
 #include "primitives/block.h"
 #include "uint256.h"
 
-uint256 ComputeMerkleRoot(const std::vector<uint256>& leaves, bool* mutated = nullptr);
-std::vector<uint256> ComputeMerkleBranch(const std::vector<uint256>& leaves, uint32_t position);
+/*
+ * The tree is hashed a level at a time, so that all the inner nodes of a level
+ * go through SHA256D64 in one call.
+ */
+uint256 ComputeMerkleRoot(std::vector<uint256> hashes, bool* mutated = nullptr);
+std::vector<uint256> ComputeMerkleBranch(std::vector<uint256> hashes, uint32_t position);
+/*
+ * Compute the Merkle root from a leaf and its branch, in log2(n) hashes. With
+ * the branch of the coinbase (position 0), which doesn't depend on the
+ * coinbase itself, this is how miners update the root for a new extra nonce.
+ */
 uint256 ComputeMerkleRootFromBranch(const uint256& leaf, const std::vector<uint256>& branch, uint32_t position);
 
 /*
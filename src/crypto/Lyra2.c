@@ -24,6 +24,67 @@
 #include "Lyra2.h"
 #include "Sponge.h"
 
+static const lyra2_impl portable = {
+    absorbBlock,
+    absorbBlockBlake2Safe,
+    squeeze,
+    reducedSqueezeRow0,
+    reducedDuplexRow1,
+    reducedDuplexRowSetup,
+    reducedDuplexRow,
+    NULL
+};
+
+/* Set by LYRA2_set_impl */
+static const lyra2_impl *impl = &portable;
+
+void LYRA2_set_impl(const lyra2_impl *newImpl) {
+    impl = newImpl ? newImpl : &portable;
+}
+
+/**
+ * Writes the password, salt and basil padded with 10*1 into in, which needs room for the returned number of
+ * blocks. See LYRA2_scratch for the parameters.
+ *
+ * @return The number of blocks of BLOCK_LEN_BLAKE2_SAFE_INT64 words written
+ */
+uint64_t LYRA2_pad_input(uint64_t *in, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols) {
+    //First, we clean enough blocks for the password, salt, basil and padding
+    uint64_t nBlocksInput = ((saltlen + pwdlen + 6 * sizeof (uint64_t)) / BLOCK_LEN_BLAKE2_SAFE_BYTES) + 1;
+    byte *ptrByte = (byte*) in;
+    memset(ptrByte, 0, nBlocksInput * BLOCK_LEN_BLAKE2_SAFE_BYTES);
+
+    //Prepends the password
+    memcpy(ptrByte, pwd, pwdlen);
+    ptrByte += pwdlen;
+
+    //Concatenates the salt
+    memcpy(ptrByte, salt, saltlen);
+    ptrByte += saltlen;
+
+    //Concatenates the basil: every integer passed as parameter, in the order they are provided by the interface
+    memcpy(ptrByte, &kLen, sizeof (uint64_t));
+    ptrByte += sizeof (uint64_t);
+    memcpy(ptrByte, &pwdlen, sizeof (uint64_t));
+    ptrByte += sizeof (uint64_t);
+    memcpy(ptrByte, &saltlen, sizeof (uint64_t));
+    ptrByte += sizeof (uint64_t);
+    memcpy(ptrByte, &timeCost, sizeof (uint64_t));
+    ptrByte += sizeof (uint64_t);
+    memcpy(ptrByte, &nRows, sizeof (uint64_t));
+    ptrByte += sizeof (uint64_t);
+    memcpy(ptrByte, &nCols, sizeof (uint64_t));
+    ptrByte += sizeof (uint64_t);
+
+    //Now comes the padding
+    *ptrByte = 0x80; //first byte of padding: right after the password
+    ptrByte = (byte*) in; //resets the pointer to the start of the input
+    ptrByte += nBlocksInput * BLOCK_LEN_BLAKE2_SAFE_BYTES - 1; //sets the pointer to the correct position: end of incomplete block
+    *ptrByte ^= 0x01; //last byte of padding: at the end of the last incomplete block
+
+    return nBlocksInput;
+}
+
 /**
  * Executes Lyra2 based on the G function from Blake2b. This version supports salts and passwords
  * whose combined length is smaller than the size of the memory matrix, (i.e., (nRows x nCols x b) bits,
@@ -40,10 +101,11 @@
  * @param timeCost Parameter to determine the processing time (T)
  * @param nRows Number or rows of the memory matrix (R)
  * @param nCols Number of columns of the memory matrix (C)
+ * @param wholeMatrix Scratch space of LYRA2_MATRIX_INT64(nRows, nCols) words for the memory matrix, owned by the caller
  *
- * @return 0 if the key is generated correctly; -1 if there is an error (usually due to lack of memory for allocation)
+ * @return 0 if the key is generated correctly
  */
-int LYRA2(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols) {
+int LYRA2_scratch(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols, uint64_t *wholeMatrix) {
 
     //============================= Basic variables ============================//
     int64_t row = 2; //index of row to be processed
@@ -64,69 +126,23 @@ int LYRA2(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *
     const int64_t ROW_LEN_BYTES = ROW_LEN_INT64 * 8;
 
     i = (int64_t) ((int64_t) nRows * (int64_t) ROW_LEN_BYTES);
-    uint64_t *wholeMatrix = malloc(i);
-    if (wholeMatrix == NULL) {
-      return -1;
-    }
 	memset(wholeMatrix, 0, i);
 
-    //Allocates pointers to each row of the matrix
-    uint64_t **memMatrix = malloc(nRows * sizeof (uint64_t*));
-    if (memMatrix == NULL) {
-      return -1;
-    }
-    //Places the pointers in the correct positions
-    uint64_t *ptrWord = wholeMatrix;
-    for (i = 0; i < nRows; i++) {
-      memMatrix[i] = ptrWord;
-      ptrWord += ROW_LEN_INT64;
-    }
+    //Rows are addressed directly in the matrix instead of through an array of row pointers
+#define memMatrix(r) (wholeMatrix + (r) * ROW_LEN_INT64)
+    uint64_t *ptrWord;
     //==========================================================================/
 
     //============= Getting the password + salt + basil padded with 10*1 ===============//
     //OBS.:The memory matrix will temporarily hold the password: not for saving memory,
     //but this ensures that the password copied locally will be overwritten as soon as possible
-
-    //First, we clean enough blocks for the password, salt, basil and padding
-    uint64_t nBlocksInput = ((saltlen + pwdlen + 6 * sizeof (uint64_t)) / BLOCK_LEN_BLAKE2_SAFE_BYTES) + 1;
-    byte *ptrByte = (byte*) wholeMatrix;
-    memset(ptrByte, 0, nBlocksInput * BLOCK_LEN_BLAKE2_SAFE_BYTES);
-
-    //Prepends the password
-    memcpy(ptrByte, pwd, pwdlen);
-    ptrByte += pwdlen;
-
-    //Concatenates the salt
-    memcpy(ptrByte, salt, saltlen);
-    ptrByte += saltlen;
-
-    //Concatenates the basil: every integer passed as parameter, in the order they are provided by the interface
-    memcpy(ptrByte, &kLen, sizeof (uint64_t));
-    ptrByte += sizeof (uint64_t);
-    memcpy(ptrByte, &pwdlen, sizeof (uint64_t));
-    ptrByte += sizeof (uint64_t);
-    memcpy(ptrByte, &saltlen, sizeof (uint64_t));
-    ptrByte += sizeof (uint64_t);
-    memcpy(ptrByte, &timeCost, sizeof (uint64_t));
-    ptrByte += sizeof (uint64_t);
-    memcpy(ptrByte, &nRows, sizeof (uint64_t));
-    ptrByte += sizeof (uint64_t);
-    memcpy(ptrByte, &nCols, sizeof (uint64_t));
-    ptrByte += sizeof (uint64_t);
-
-    //Now comes the padding
-    *ptrByte = 0x80; //first byte of padding: right after the password
-    ptrByte = (byte*) wholeMatrix; //resets the pointer to the start of the memory matrix
-    ptrByte += nBlocksInput * BLOCK_LEN_BLAKE2_SAFE_BYTES - 1; //sets the pointer to the correct position: end of incomplete block
-    *ptrByte ^= 0x01; //last byte of padding: at the end of the last incomplete block
+    uint64_t nBlocksInput = LYRA2_pad_input(wholeMatrix, kLen, pwd, pwdlen, salt, saltlen, timeCost, nRows, nCols);
     //==========================================================================/
 
     //======================= Initializing the Sponge State ====================//
     //Sponge state: 16 uint64_t, BLOCK_LEN_INT64 words of them for the bitrate (b) and the remainder for the capacity (c)
-    uint64_t *state = malloc(16 * sizeof (uint64_t));
-    if (state == NULL) {
-      return -1;
-    }
+    const lyra2_impl *sponge = impl; //The sponge routines are looked up once for the whole call
+    uint64_t state[16];
     initState(state);
     //==========================================================================/
 
@@ -134,17 +150,17 @@ int LYRA2(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *
     //Absorbing salt, password and basil: this is the only place in which the block length is hard-coded to 512 bits
     ptrWord = wholeMatrix;
     for (i = 0; i < nBlocksInput; i++) {
-      absorbBlockBlake2Safe(state, ptrWord); //absorbs each block of pad(pwd || salt || basil)
+      sponge->absorbBlockBlake2Safe(state, ptrWord); //absorbs each block of pad(pwd || salt || basil)
       ptrWord += BLOCK_LEN_BLAKE2_SAFE_INT64; //goes to next block of pad(pwd || salt || basil)
     }
 
     //Initializes M[0] and M[1]
-    reducedSqueezeRow0(state, memMatrix[0], nCols); //The locally copied password is most likely overwritten here
-    reducedDuplexRow1(state, memMatrix[0], memMatrix[1], nCols);
+    sponge->reducedSqueezeRow0(state, memMatrix(0), nCols); //The locally copied password is most likely overwritten here
+    sponge->reducedDuplexRow1(state, memMatrix(0), memMatrix(1), nCols);
 
     do {
       //M[row] = rand; //M[row*] = M[row*] XOR rotW(rand)
-      reducedDuplexRowSetup(state, memMatrix[prev], memMatrix[rowa], memMatrix[row], nCols);
+      sponge->reducedDuplexRowSetup(state, memMatrix(prev), memMatrix(rowa), memMatrix(row), nCols);
 
 
       //updates the value of row* (deterministically picked during Setup))
@@ -177,7 +193,7 @@ int LYRA2(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *
   	    //------------------------------------------------------------------------------------------
 
   	    //Performs a reduced-round duplexing operation over M[row*] XOR M[prev], updating both M[row*] and M[row]
-  	    reducedDuplexRow(state, memMatrix[prev], memMatrix[rowa], memMatrix[row], nCols);
+  	    sponge->reducedDuplexRow(state, memMatrix(prev), memMatrix(rowa), memMatrix(row), nCols);
 
   	    //update prev: it now points to the last row ever computed
   	    prev = row;
@@ -194,24 +210,57 @@ int LYRA2(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *
 
     //============================ Wrap-up Phase ===============================//
     //Absorbs the last block of the memory matrix
-    absorbBlock(state, memMatrix[rowa]);
+    sponge->absorbBlock(state, memMatrix(rowa));
 
     //Squeezes the key
-    squeeze(state, K, kLen);
+    sponge->squeeze(state, K, kLen);
     //==========================================================================/
 
-    //========================= Freeing the memory =============================//
-    free(memMatrix);
-    free(wholeMatrix);
+#undef memMatrix
 
-    //Wiping out the sponge's internal state before freeing it
+    //Wiping out the sponge's internal state
     memset(state, 0, 16 * sizeof (uint64_t));
-    free(state);
-    //==========================================================================/
 
     return 0;
 }
 
+/**
+ * Executes Lyra2 on LYRA2_LANES independent inputs with the same lengths and parameters, in lockstep if the selected
+ * implementation supports it. See LYRA2_scratch for the parameters, of which K, pwd and salt hold one pointer per lane.
+ *
+ * @param wholeMatrix Scratch space of LYRA2_LANES * LYRA2_MATRIX_INT64(nRows, nCols) words, owned by the caller
+ *
+ * @return 0 if the keys are generated correctly
+ */
+int LYRA2_4way(void *const *K, uint64_t kLen, const void *const *pwd, uint64_t pwdlen, const void *const *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols, uint64_t *wholeMatrix) {
+    int i;
+    if (impl->lyra2_4way != NULL) {
+      return impl->lyra2_4way(K, kLen, pwd, pwdlen, salt, saltlen, timeCost, nRows, nCols, wholeMatrix);
+    }
+    for (i = 0; i < LYRA2_LANES; i++) {
+      int result = LYRA2_scratch(K[i], kLen, pwd[i], pwdlen, salt[i], saltlen, timeCost, nRows, nCols, wholeMatrix + i * LYRA2_MATRIX_INT64(nRows, nCols));
+      if (result != 0) {
+        return result;
+      }
+    }
+    return 0;
+}
+
+/**
+ * Executes Lyra2 on a memory matrix allocated on the heap for the call. See LYRA2_scratch for the parameters.
+ *
+ * @return 0 if the key is generated correctly; -1 if there is an error (usually due to lack of memory for allocation)
+ */
+int LYRA2(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols) {
+    uint64_t *wholeMatrix = malloc(LYRA2_MATRIX_INT64(nRows, nCols) * sizeof (uint64_t));
+    if (wholeMatrix == NULL) {
+      return -1;
+    }
+    int result = LYRA2_scratch(K, kLen, pwd, pwdlen, salt, saltlen, timeCost, nRows, nCols, wholeMatrix);
+    free(wholeMatrix);
+    return result;
+}
+
 int LYRA2_old(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols) {
 
     //============================= Basic variables ============================//
@@ -37,8 +37,47 @@ typedef unsigned char byte;
         #define BLOCK_LEN_BYTES (BLOCK_LEN_INT64 * 8)    //Block length, in bytes
 #endif
 
+//Number of uint64_t words of the memory matrix used by LYRA2 for the given number of rows and columns
+#define LYRA2_MATRIX_INT64(nRows, nCols) ((nRows) * (nCols) * BLOCK_LEN_INT64)
+
+//Number of independent inputs LYRA2_4way processes in lockstep
+#define LYRA2_LANES 4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A replacement for the sponge routines of Sponge.h used by LYRA2_scratch, and for LYRA2_4way, such as a vectorized
+ * one. Every routine must give the same results as the portable one.
+ */
+typedef struct lyra2_impl {
+    void (*absorbBlock)(uint64_t *state, const uint64_t *in);
+    void (*absorbBlockBlake2Safe)(uint64_t *state, const uint64_t *in);
+    void (*squeeze)(uint64_t *state, unsigned char *out, unsigned int len);
+    void (*reducedSqueezeRow0)(uint64_t *state, uint64_t *rowOut, uint64_t nCols);
+    void (*reducedDuplexRow1)(uint64_t *state, uint64_t *rowIn, uint64_t *rowOut, uint64_t nCols);
+    void (*reducedDuplexRowSetup)(uint64_t *state, uint64_t *rowIn, uint64_t *rowInOut, uint64_t *rowOut, uint64_t nCols);
+    void (*reducedDuplexRow)(uint64_t *state, uint64_t *rowIn, uint64_t *rowInOut, uint64_t *rowOut, uint64_t nCols);
+    int (*lyra2_4way)(void *const *K, uint64_t kLen, const void *const *pwd, uint64_t pwdlen, const void *const *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols, uint64_t *wholeMatrix);
+} lyra2_impl;
+
+//Selects the implementation used by LYRA2_scratch and LYRA2_4way, or the portable one if impl is NULL
+void LYRA2_set_impl(const lyra2_impl *impl);
+
+//Writes pad(pwd || salt || basil) into in, and returns its number of blocks of BLOCK_LEN_BLAKE2_SAFE_INT64 words
+uint64_t LYRA2_pad_input(uint64_t *in, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols);
+
+int LYRA2_scratch(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols, uint64_t *wholeMatrix);
+
+int LYRA2_4way(void *const *K, uint64_t kLen, const void *const *pwd, uint64_t pwdlen, const void *const *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols, uint64_t *wholeMatrix);
+
 int LYRA2(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols);
 
 int LYRA2_old(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* LYRA2_H_ */
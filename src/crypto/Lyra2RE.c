@@ -70,80 +70,131 @@ void lyra2re_hash(const char* input, char* output)
 	memcpy(output, hashA, 32);
 }
 
-void lyra2re2_hash(const char* input, char* output)
+/* Runs the rounds of lyra2re2 between Blake-256 and Lyra2 on hashA, in place */
+static void lyra2re2_hash_head(uint32_t* hashA)
 {
-	sph_blake256_context ctx_blake;
-	sph_cubehash256_context ctx_cubehash;
-	sph_keccak256_context ctx_keccak;
-	sph_skein256_context ctx_skein;
-	sph_bmw256_context ctx_bmw;
-	
-	uint32_t hashA[8], hashB[8];
-	
-	sph_blake256_init(&ctx_blake);
-    sph_blake256(&ctx_blake, input, 80);
-    sph_blake256_close (&ctx_blake, hashA);	
-	
+    sph_cubehash256_context ctx_cubehash;
+    sph_keccak256_context ctx_keccak;
+
+    uint32_t hashB[8];
+
     sph_keccak256_init(&ctx_keccak);
-    sph_keccak256(&ctx_keccak, hashA, 32); 
+    sph_keccak256(&ctx_keccak, hashA, 32);
     sph_keccak256_close(&ctx_keccak, hashB);
-    
+
     sph_cubehash256_init(&ctx_cubehash);
     sph_cubehash256(&ctx_cubehash, hashB, 32);
     sph_cubehash256_close(&ctx_cubehash, hashA);
-    
-    LYRA2(hashB, 32, hashA, 32, hashA, 32, 1, 4, 4);
-    
-   	sph_skein256_init(&ctx_skein);
-    sph_skein256(&ctx_skein, hashB, 32); 
+}
+
+/* Runs the rounds of lyra2re2 following Lyra2 on its output in hashB */
+static void lyra2re2_hash_tail(uint32_t* hashB, char* output)
+{
+    sph_cubehash256_context ctx_cubehash;
+    sph_skein256_context ctx_skein;
+    sph_bmw256_context ctx_bmw;
+
+    uint32_t hashA[8];
+
+    sph_skein256_init(&ctx_skein);
+    sph_skein256(&ctx_skein, hashB, 32);
     sph_skein256_close(&ctx_skein, hashA);
-    
+
     sph_cubehash256_init(&ctx_cubehash);
     sph_cubehash256(&ctx_cubehash, hashA, 32);
     sph_cubehash256_close(&ctx_cubehash, hashB);
-    
+
     sph_bmw256_init(&ctx_bmw);
     sph_bmw256(&ctx_bmw, hashB, 32);
     sph_bmw256_close(&ctx_bmw, hashA);
-    
-   	memcpy(output, hashA, 32);
+
+    memcpy(output, hashA, 32);
+}
+
+/* Runs the rounds of lyra2re2 following Blake-256 on its output in hashA */
+static void lyra2re2_hash_rounds(uint32_t* hashA, char* output)
+{
+    uint32_t hashB[8];
+    uint64_t matrix[LYRA2_MATRIX_INT64(4, 4)];
+
+    lyra2re2_hash_head(hashA);
+    LYRA2_scratch(hashB, 32, hashA, 32, hashA, 32, 1, 4, 4, matrix);
+    lyra2re2_hash_tail(hashB, output);
+}
+
+void lyra2re2_hash(const char* input, char* output)
+{
+    sph_blake256_context ctx_blake;
+
+    uint32_t hashA[8];
+
+    sph_blake256_init(&ctx_blake);
+    sph_blake256(&ctx_blake, input, 80);
+    sph_blake256_close(&ctx_blake, hashA);
+
+    lyra2re2_hash_rounds(hashA, output);
 }
 
 void lyra2re2_hash52(const char* input, char* output)
 {
     sph_blake256_context ctx_blake;
-    sph_cubehash256_context ctx_cubehash;
-    sph_keccak256_context ctx_keccak;
-    sph_skein256_context ctx_skein;
-    sph_bmw256_context ctx_bmw;
 
-    uint32_t hashA[8], hashB[8];
+    uint32_t hashA[8];
 
     sph_blake256_init(&ctx_blake);
     sph_blake256(&ctx_blake, input, 52);
-    sph_blake256_close (&ctx_blake, hashA);
+    sph_blake256_close(&ctx_blake, hashA);
 
-    sph_keccak256_init(&ctx_keccak);
-    sph_keccak256(&ctx_keccak, hashA, 32);
-    sph_keccak256_close(&ctx_keccak, hashB);
+    lyra2re2_hash_rounds(hashA, output);
+}
 
-    sph_cubehash256_init(&ctx_cubehash);
-    sph_cubehash256(&ctx_cubehash, hashB, 32);
-    sph_cubehash256_close(&ctx_cubehash, hashA);
+void lyra2re2_hash_batch(const char* const* inputs, char* const* outputs, size_t n)
+{
+    sph_blake256_context ctx_blake;
 
-    LYRA2(hashB, 32, hashA, 32, hashA, 32, 1, 4, 4);
+    uint32_t hashA[LYRA2_LANES][8];
+    uint32_t hashB[LYRA2_LANES][8];
+    uint64_t matrix[LYRA2_LANES * LYRA2_MATRIX_INT64(4, 4)];
+    void* keys[LYRA2_LANES];
+    const void* pwds[LYRA2_LANES];
+    size_t begin, l;
+
+    for (begin = 0; begin < n; begin += LYRA2_LANES) {
+        /* A short last group fills its unused lanes with its last input and drops their outputs */
+        for (l = 0; l < LYRA2_LANES && begin + l < n; l++) {
+            sph_blake256_init(&ctx_blake);
+            sph_blake256(&ctx_blake, inputs[begin + l], 80);
+            sph_blake256_close(&ctx_blake, hashA[l]);
+            lyra2re2_hash_head(hashA[l]);
+        }
+        for (; l < LYRA2_LANES; l++) {
+            memcpy(hashA[l], hashA[l - 1], 32);
+        }
+        for (l = 0; l < LYRA2_LANES; l++) {
+            keys[l] = hashB[l];
+            pwds[l] = hashA[l];
+        }
+        LYRA2_4way(keys, 32, pwds, 32, pwds, 32, 1, 4, 4, matrix);
+        for (l = 0; l < LYRA2_LANES && begin + l < n; l++) {
+            lyra2re2_hash_tail(hashB[l], outputs[begin + l]);
+        }
+    }
+}
 
-    sph_skein256_init(&ctx_skein);
-    sph_skein256(&ctx_skein, hashB, 32);
-    sph_skein256_close(&ctx_skein, hashA);
+void lyra2re2_midstate_init(lyra2re2_midstate* midstate, const char* input)
+{
+    sph_blake256_init(&midstate->blake);
+    sph_blake256(&midstate->blake, input, 64);
+}
 
-    sph_cubehash256_init(&ctx_cubehash);
-    sph_cubehash256(&ctx_cubehash, hashA, 32);
-    sph_cubehash256_close(&ctx_cubehash, hashB);
+void lyra2re2_hash_midstate(const lyra2re2_midstate* midstate, const char* tail, char* output)
+{
+    sph_blake256_context ctx_blake = midstate->blake;
 
-    sph_bmw256_init(&ctx_bmw);
-    sph_bmw256(&ctx_bmw, hashB, 32);
-    sph_bmw256_close(&ctx_bmw, hashA);
+    uint32_t hashA[8];
 
-    memcpy(output, hashA, 32);
+    sph_blake256(&ctx_blake, tail, 16);
+    sph_blake256_close(&ctx_blake, hashA);
+
+    lyra2re2_hash_rounds(hashA, output);
 }
@@ -1,13 +1,29 @@
 #ifndef LYRA2RE_H
 #define LYRA2RE_H
 
+#include "sph_blake.h"
+
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Blake-256 state of an 80 byte input after its first 64 bytes, shared by every nonce of a block header */
+typedef struct lyra2re2_midstate {
+    sph_blake256_context blake;
+} lyra2re2_midstate;
+
 void lyra2re_hash(const char* input, char* output);
 void lyra2re2_hash(const char* input, char* output);
 void lyra2re2_hash52(const char* input, char* output);
+/* Same as n calls to lyra2re2_hash, running the Lyra2 step of LYRA2_LANES inputs at a time through LYRA2_4way */
+void lyra2re2_hash_batch(const char* const* inputs, char* const* outputs, size_t n);
+
+/* Absorbs the first 64 bytes of the 80 byte input into midstate */
+void lyra2re2_midstate_init(lyra2re2_midstate* midstate, const char* input);
+/* Same as lyra2re2_hash of the input midstate was initialized from, with its last 16 bytes replaced by tail */
+void lyra2re2_hash_midstate(const lyra2re2_midstate* midstate, const char* tail, char* output);
 
 
 #ifdef __cplusplus
@@ -73,6 +73,10 @@ static inline uint64_t rotr64( const uint64_t w, const unsigned c ){
     G(r,7,v[ 3],v[ 4],v[ 9],v[14]);
 
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 //---- Housekeeping
 void initState(uint64_t state[/*16*/]);
 
@@ -92,6 +96,10 @@ void reducedDuplexRow(uint64_t *state, uint64_t *rowIn, uint64_t *rowInOut, uint
 //---- Misc
 void printArray(unsigned char *array, unsigned int size, char *name);
 
+#ifdef __cplusplus
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
@@ -0,0 +1,58 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// AVX2 version of the CubeHash round function of cubehash.c.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace cubehash_avx2
+{
+namespace {
+
+inline __m256i Rotl(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n));
+}
+
+}
+
+/**
+ * The state is held in four registers: words 0-7, 8-15, 16-23 and 24-31. The swaps of the round function are a
+ * renaming of the first two registers, a swap of their 128 bit halves, and shuffles within the last two.
+ */
+void Rounds(uint32_t* state, unsigned n)
+{
+    __m256i x0 = _mm256_loadu_si256((const __m256i*)state);
+    __m256i x1 = _mm256_loadu_si256((const __m256i*)(state + 8));
+    __m256i y0 = _mm256_loadu_si256((const __m256i*)(state + 16));
+    __m256i y1 = _mm256_loadu_si256((const __m256i*)(state + 24));
+    __m256i t;
+
+    for (unsigned i = 0; i < n * 16; i++) {
+        y0 = _mm256_add_epi32(y0, x0);
+        y1 = _mm256_add_epi32(y1, x1);
+        t = Rotl(x0, 7);
+        x0 = _mm256_xor_si256(Rotl(x1, 7), y0);
+        x1 = _mm256_xor_si256(t, y1);
+        y0 = _mm256_shuffle_epi32(y0, _MM_SHUFFLE(1, 0, 3, 2));
+        y1 = _mm256_shuffle_epi32(y1, _MM_SHUFFLE(1, 0, 3, 2));
+        y0 = _mm256_add_epi32(y0, x0);
+        y1 = _mm256_add_epi32(y1, x1);
+        x0 = _mm256_xor_si256(_mm256_permute4x64_epi64(Rotl(x0, 11), _MM_SHUFFLE(1, 0, 3, 2)), y0);
+        x1 = _mm256_xor_si256(_mm256_permute4x64_epi64(Rotl(x1, 11), _MM_SHUFFLE(1, 0, 3, 2)), y1);
+        y0 = _mm256_shuffle_epi32(y0, _MM_SHUFFLE(2, 3, 0, 1));
+        y1 = _mm256_shuffle_epi32(y1, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+
+    _mm256_storeu_si256((__m256i*)state, x0);
+    _mm256_storeu_si256((__m256i*)(state + 8), x1);
+    _mm256_storeu_si256((__m256i*)(state + 16), y0);
+    _mm256_storeu_si256((__m256i*)(state + 24), y1);
+}
+}
+
+#endif
@@ -0,0 +1,83 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// SSE2 version of the CubeHash round function of cubehash.c, built wherever the compiler targets SSE2.
+
+#if defined(__SSE2__)
+
+#include <stdint.h>
+#include <emmintrin.h>
+
+namespace cubehash_sse2
+{
+namespace {
+
+inline __m128i Rotl(__m128i x, int n)
+{
+    return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n));
+}
+
+}
+
+/**
+ * The state is held in eight registers of four words. The swaps of the round function that move words between
+ * registers are done by renaming them, and those within a register by shuffles.
+ */
+void Rounds(uint32_t* state, unsigned n)
+{
+    __m128i x0 = _mm_loadu_si128((const __m128i*)state);
+    __m128i x1 = _mm_loadu_si128((const __m128i*)(state + 4));
+    __m128i x2 = _mm_loadu_si128((const __m128i*)(state + 8));
+    __m128i x3 = _mm_loadu_si128((const __m128i*)(state + 12));
+    __m128i y0 = _mm_loadu_si128((const __m128i*)(state + 16));
+    __m128i y1 = _mm_loadu_si128((const __m128i*)(state + 20));
+    __m128i y2 = _mm_loadu_si128((const __m128i*)(state + 24));
+    __m128i y3 = _mm_loadu_si128((const __m128i*)(state + 28));
+    __m128i t;
+
+    for (unsigned i = 0; i < n * 16; i++) {
+        y0 = _mm_add_epi32(y0, x0);
+        y1 = _mm_add_epi32(y1, x1);
+        y2 = _mm_add_epi32(y2, x2);
+        y3 = _mm_add_epi32(y3, x3);
+        // Rotate, then swap words 0-7 with words 8-15
+        t = Rotl(x0, 7);
+        x0 = _mm_xor_si128(Rotl(x2, 7), y0);
+        x2 = _mm_xor_si128(t, y2);
+        t = Rotl(x1, 7);
+        x1 = _mm_xor_si128(Rotl(x3, 7), y1);
+        x3 = _mm_xor_si128(t, y3);
+        y0 = _mm_shuffle_epi32(y0, _MM_SHUFFLE(1, 0, 3, 2));
+        y1 = _mm_shuffle_epi32(y1, _MM_SHUFFLE(1, 0, 3, 2));
+        y2 = _mm_shuffle_epi32(y2, _MM_SHUFFLE(1, 0, 3, 2));
+        y3 = _mm_shuffle_epi32(y3, _MM_SHUFFLE(1, 0, 3, 2));
+        y0 = _mm_add_epi32(y0, x0);
+        y1 = _mm_add_epi32(y1, x1);
+        y2 = _mm_add_epi32(y2, x2);
+        y3 = _mm_add_epi32(y3, x3);
+        // Rotate, then swap words 0-3 with words 4-7 and words 8-11 with words 12-15
+        t = Rotl(x0, 11);
+        x0 = _mm_xor_si128(Rotl(x1, 11), y0);
+        x1 = _mm_xor_si128(t, y1);
+        t = Rotl(x2, 11);
+        x2 = _mm_xor_si128(Rotl(x3, 11), y2);
+        x3 = _mm_xor_si128(t, y3);
+        y0 = _mm_shuffle_epi32(y0, _MM_SHUFFLE(2, 3, 0, 1));
+        y1 = _mm_shuffle_epi32(y1, _MM_SHUFFLE(2, 3, 0, 1));
+        y2 = _mm_shuffle_epi32(y2, _MM_SHUFFLE(2, 3, 0, 1));
+        y3 = _mm_shuffle_epi32(y3, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+
+    _mm_storeu_si128((__m128i*)state, x0);
+    _mm_storeu_si128((__m128i*)(state + 4), x1);
+    _mm_storeu_si128((__m128i*)(state + 8), x2);
+    _mm_storeu_si128((__m128i*)(state + 12), x3);
+    _mm_storeu_si128((__m128i*)(state + 16), y0);
+    _mm_storeu_si128((__m128i*)(state + 20), y1);
+    _mm_storeu_si128((__m128i*)(state + 24), y2);
+    _mm_storeu_si128((__m128i*)(state + 28), y3);
+}
+}
+
+#endif
@@ -1,23 +1,142 @@
 #include "dag.h"
+#include "crypto/dag_sizes.h"
 #include "crypto/sph_blake.h"
 #include "crypto/Lyra2RE.h"
 #include "sync.h"
+#include "tinyformat.h"
 #include "primitives/block.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <thread>
 
-CDAGNode::CDAGNode(uint32_t *ptr, bool fGraphDerived) {
-    this->ptr = ptr;
-    this->fGraphDerived = fGraphDerived;
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+#include <cpuid.h>
+namespace dag_avx2
+{
+void MixParents(const uint64_t* indices, const uint32_t* cache, uint64_t items, uint32_t* mix, uint32_t parents);
 }
+#endif
 
-uint32_t *CDAGNode::GetNodePtr() {
-    return ptr;
+CDAGNode::CDAGNode(const uint32_t *ptr, CDAGEpochRef epoch) : ptr(ptr), epoch(std::move(epoch)) {}
+
+CDAGNode::CDAGNode() : ptr(nullptr) {}
+
+const uint32_t *CDAGNode::GetNodePtr() const {
+    return ptr ? ptr : words;
+}
+
+namespace {
+inline uint32_t fnv(uint32_t v1, uint32_t v2) {
+    return ((v1 * 0x01000193) ^ v2) % UINT32_MAX;
+}
+
+/**
+ * Mixes parents parent words into each of the lanes 8 word nodes in mix. All lanes' parents are fetched
+ * before any of them is mixed in, so the fetches do not wait for each other.
+ */
+void MixParentsGeneric(const uint64_t *indices, size_t lanes, const uint32_t *cache, uint64_t items, uint32_t *mix, uint32_t parents) {
+    uint32_t parentdata[8];
+    for (uint32_t parent = 0; parent < parents; parent++) {
+        for (size_t lane = 0; lane < lanes; lane++) {
+            parentdata[lane] = cache[(fnv(indices[lane] ^ parent, mix[lane * 8 + parent % 8]) % items) * 8];
+        }
+        for (size_t lane = 0; lane < lanes; lane++) {
+            for (size_t dword = 0; dword < 8; dword++) {
+                mix[lane * 8 + dword] = fnv(mix[lane * 8 + dword], parentdata[lane]);
+            }
+        }
+    }
+}
+
+void MixParents8Generic(const uint64_t *indices, const uint32_t *cache, uint64_t items, uint32_t *mix, uint32_t parents) {
+    MixParentsGeneric(indices, 8, cache, items, mix, parents);
+}
+
+typedef void (*MixParents8Type)(const uint64_t *indices, const uint32_t *cache, uint64_t items, uint32_t *mix, uint32_t parents);
+/** Parent mixing for a full set of 8 lanes, selected by DAGAutoDetect */
+MixParents8Type MixParents8 = MixParents8Generic;
+
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+/** Whether the OS saves the AVX registers on context switches */
+bool AVXEnabled() {
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+#endif
+
+/** Checks mixer against the generic implementation on a small pseudo random cache */
+bool SelfTest(MixParents8Type mixer) {
+    static const uint64_t ITEMS = 61;
+    std::vector<uint32_t> cache(ITEMS * 8);
+    uint32_t x = 0x12345678;
+    for (uint32_t& word : cache) {
+        x = x * 1103515245 + 12345;
+        word = x;
+    }
+    cache[0] = UINT32_MAX;
+    uint64_t indices[8];
+    uint32_t expected[64], mix[64];
+    for (int lane = 0; lane < 8; lane++) {
+        indices[lane] = 0x100000000ULL * lane + 977 * lane;
+    }
+    for (int i = 0; i < 64; i++) {
+        expected[i] = mix[i] = cache[i * 3];
+    }
+    MixParentsGeneric(indices, 8, cache.data(), ITEMS, expected, 256);
+    mixer(indices, cache.data(), ITEMS, mix, 256);
+    return memcmp(expected, mix, sizeof(mix)) == 0;
+}
+}
+
+std::string DAGAutoDetect()
+{
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+    uint32_t eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && ((ecx >> 27) & 1) && AVXEnabled()) {
+        if (__get_cpuid_max(0, nullptr) >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            if ((ebx >> 5) & 1) {
+                MixParents8 = dag_avx2::MixParents;
+                if (SelfTest(MixParents8))
+                    return "avx2";
+                MixParents8 = MixParents8Generic;
+                return "standard, the avx2 implementation failed its self-test";
+            }
+        }
+    }
+#endif
+
+    return "standard";
+}
+
+CDAGTable::CDAGTable() : pData(nullptr), nWords(0) {}
+
+CDAGTable::CDAGTable(std::vector<uint32_t>&& vDataIn) : vData(std::move(vDataIn)) {
+    pData = vData.data();
+    nWords = vData.size();
+}
+
+CDAGTable::CDAGTable(const uint32_t *pDataIn, uint64_t nWordsIn, std::shared_ptr<const void> ownerIn) :
+    owner(std::move(ownerIn)), pData(pDataIn), nWords(nWordsIn) {}
+
+CDAGTable::CDAGTable(CDAGTable&& other) : CDAGTable() {
+    *this = std::move(other);
 }
 
-CDAGNode::~CDAGNode() {
-    if(!fGraphDerived) {
-        delete[] ptr;
+CDAGTable& CDAGTable::operator=(CDAGTable&& other) {
+    if(this != &other) {
+        vData = std::move(other.vData);
+        owner = std::move(other.owner);
+        pData = owner ? other.pData : vData.data();
+        nWords = other.nWords;
+        other.vData.clear();
+        other.pData = nullptr;
+        other.nWords = 0;
     }
+    return *this;
 }
 
 CHashimotoResult::CHashimotoResult(uint128 cmix, uint256 result) {
@@ -33,30 +152,39 @@ uint256 CHashimotoResult::GetResult() {
     return result;
 }
 
+std::map<uint64_t, std::pair<uint64_t, uint64_t>> CDAGSystem::sizeCache;
 std::map<size_t, std::array<uint8_t, 32>> CDAGSystem::seedCache = std::map<size_t, std::array<uint8_t, 32>>();
-std::map<size_t, std::vector<uint32_t>> CDAGSystem::cacheCache = std::map<size_t, std::vector<uint32_t>>();
-std::map<size_t, std::vector<uint32_t>> CDAGSystem::graphCache = std::map<size_t, std::vector<uint32_t>>();
+std::shared_ptr<const std::map<uint64_t, CDAGEpochRef>> CDAGSystem::epochs = std::make_shared<const std::map<uint64_t, CDAGEpochRef>>();
+CCriticalSection CDAGSystem::cs_epochs;
+uint64_t CDAGSystem::nTipEpoch = CDAGSystem::NO_EPOCH;
+std::list<uint64_t> CDAGSystem::otherEpochs;
 CHashimotoResult CDAGSystem::lastwork = CHashimotoResult(uint128(), uint256());
-void CDAGSystem::PopulateSeedEpoch(uint64_t epoch) {
-    if(!(seedCache.find(epoch) == seedCache.end())){
-        return;
-    }
+int CDAGSystem::nGraphThreads = 1;
+std::function<void(uint64_t, int)> CDAGSystem::GraphProgress;
+std::function<void(const std::string&)> CDAGSystem::GraphLog;
+std::function<bool()> CDAGSystem::GraphInterrupt;
+std::function<std::shared_ptr<const CDAGTable>(CDAGTable::Type, uint64_t, const std::array<uint8_t, 32>&, uint64_t)> CDAGSystem::LoadTable;
+std::function<void(CDAGTable::Type, uint64_t, const std::array<uint8_t, 32>&, std::shared_ptr<const CDAGTable>)> CDAGSystem::SaveTable;
+std::array<uint8_t, 32> CDAGSystem::PopulateSeedEpoch(uint64_t epoch) {
     static CCriticalSection cs;
-    {
-        LOCK(cs);
-        //Finds largest epoch, populates seed from it.
-        seedCache[0].fill(0);
-        uint64_t epoch_latest = seedCache.rbegin()->first;
-        uint64_t start_epoch = ((epoch - epoch_latest) > epoch) ? 0 : epoch_latest;
-        seedCache[epoch] = seedCache[start_epoch];
-        for(uint64_t i = start_epoch; i < epoch; i++) {
-            //Repeatedly hashes (seed_epoch - start_epoch) times
-            sph_blake256_context ctx;
-            sph_blake256_init(&ctx);
-            sph_blake256(&ctx, seedCache[epoch].data(), HASH_BYTES);
-            sph_blake256_close(&ctx,seedCache[epoch].data());
-        }
+    LOCK(cs);
+    auto it = seedCache.find(epoch);
+    if(it != seedCache.end()) {
+        return it->second;
+    }
+    //Finds largest epoch, populates seed from it.
+    seedCache[0].fill(0);
+    uint64_t epoch_latest = seedCache.rbegin()->first;
+    uint64_t start_epoch = ((epoch - epoch_latest) > epoch) ? 0 : epoch_latest;
+    seedCache[epoch] = seedCache[start_epoch];
+    for(uint64_t i = start_epoch; i < epoch; i++) {
+        //Repeatedly hashes (seed_epoch - start_epoch) times
+        sph_blake256_context ctx;
+        sph_blake256_init(&ctx);
+        sph_blake256(&ctx, seedCache[epoch].data(), HASH_BYTES);
+        sph_blake256_close(&ctx,seedCache[epoch].data());
     }
+    return seedCache[epoch];
 }
 
 uint32_t CDAGSystem::fnv(uint32_t v1, uint32_t v2) {
@@ -76,9 +204,7 @@ bool CDAGSystem::is_prime(uint64_t num) {
     return true;
 }
 
-uint64_t CDAGSystem::GetCacheSize(uint64_t epoch) {
-    if(!cacheCache[epoch].empty())
-        return cacheCache[epoch].size() * sizeof(uint32_t);
+uint64_t CDAGSystem::CalcCacheSize(uint64_t epoch) {
     uint64_t size = CACHE_BYTES_INIT + (CACHE_BYTES_GROWTH * round(sqrt(6*epoch)));
     size -= HASH_BYTES;
     while(!is_prime(size / HASH_BYTES)) {
@@ -87,9 +213,7 @@ uint64_t CDAGSystem::GetCacheSize(uint64_t epoch) {
     return size;
 }
 
-uint64_t CDAGSystem::GetGraphSize(uint64_t epoch) {
-    if(!graphCache[epoch].empty())
-        return graphCache[epoch].size() * sizeof(uint32_t);
+uint64_t CDAGSystem::CalcGraphSize(uint64_t epoch) {
     uint64_t size = DATASET_BYTES_INIT + (DATASET_BYTES_GROWTH * round(sqrt(6*epoch)));
     size -= MIX_BYTES;
     while(!is_prime(size / MIX_BYTES)) {
@@ -98,140 +222,418 @@ uint64_t CDAGSystem::GetGraphSize(uint64_t epoch) {
     return size;
 }
 
-void CDAGSystem::CreateCacheInPlace(uint64_t epoch) {
-    PopulateSeedEpoch(epoch);
-    uint64_t size = GetCacheSize(epoch);
-    uint64_t items = size / HASH_BYTES;
-    cacheCache[epoch].resize(size / sizeof(uint32_t), 0);
+uint64_t CDAGSystem::GetCacheSize(uint64_t epoch) {
+    if (epoch < DAG_SIZES_EPOCHS)
+        return dag_cache_sizes[epoch];
+    return GetSizes(epoch).first;
+}
+
+uint64_t CDAGSystem::GetGraphSize(uint64_t epoch) {
+    if (epoch < DAG_SIZES_EPOCHS)
+        return dag_graph_sizes[epoch];
+    return GetSizes(epoch).second;
+}
+
+std::pair<uint64_t, uint64_t> CDAGSystem::GetSizes(uint64_t epoch) {
+    static const size_t MAX_SIZE_CACHE = 16;
+    static CCriticalSection cs;
+    LOCK(cs);
+    auto it = sizeCache.find(epoch);
+    if (it == sizeCache.end()) {
+        // Headers may claim any height, so only remember a few epochs
+        if (sizeCache.size() >= MAX_SIZE_CACHE)
+            sizeCache.erase(sizeCache.begin());
+        it = sizeCache.emplace(epoch, std::make_pair(CalcCacheSize(epoch), CalcGraphSize(epoch))).first;
+    }
+    return it->second;
+}
+
+CDAGEpochRef CDAGSystem::LookupEpoch(uint64_t epoch) {
+    std::shared_ptr<const std::map<uint64_t, CDAGEpochRef>> current = std::atomic_load(&epochs);
+    auto it = current->find(epoch);
+    if(it == current->end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+bool CDAGSystem::IsTipWindowEpoch(uint64_t epoch) {
+    return nTipEpoch != NO_EPOCH && epoch + 1 >= nTipEpoch && epoch <= nTipEpoch + 1;
+}
+
+void CDAGSystem::EvictEpochs(std::map<uint64_t, CDAGEpochRef>& next) {
+    while(otherEpochs.size() > MAX_OTHER_EPOCHS) {
+        otherEpochs.pop_back();
+    }
+    // Threads still hashing against a dropped snapshot keep it alive until they are done.
+    for(auto it = next.begin(); it != next.end();) {
+        if(IsTipWindowEpoch(it->first) || std::find(otherEpochs.begin(), otherEpochs.end(), it->first) != otherEpochs.end()) {
+            ++it;
+        } else {
+            it = next.erase(it);
+        }
+    }
+}
+
+void CDAGSystem::PublishEpoch(CDAGEpochRef ref) {
+    LOCK(cs_epochs);
+    std::shared_ptr<std::map<uint64_t, CDAGEpochRef>> next = std::make_shared<std::map<uint64_t, CDAGEpochRef>>(*std::atomic_load(&epochs));
+    (*next)[ref->epoch] = ref;
+    if(!IsTipWindowEpoch(ref->epoch)) {
+        otherEpochs.remove(ref->epoch);
+        otherEpochs.push_front(ref->epoch);
+    }
+    EvictEpochs(*next);
+    std::atomic_store(&epochs, std::shared_ptr<const std::map<uint64_t, CDAGEpochRef>>(std::move(next)));
+}
+
+void CDAGSystem::SetTipEpoch(uint64_t epoch) {
+    LOCK(cs_epochs);
+    if(epoch == nTipEpoch) {
+        return;
+    }
+    nTipEpoch = epoch;
+    // Epochs the window now covers no longer count against the other epochs, the ones it left are dropped.
+    otherEpochs.remove_if(IsTipWindowEpoch);
+    std::shared_ptr<std::map<uint64_t, CDAGEpochRef>> next = std::make_shared<std::map<uint64_t, CDAGEpochRef>>(*std::atomic_load(&epochs));
+    EvictEpochs(*next);
+    std::atomic_store(&epochs, std::shared_ptr<const std::map<uint64_t, CDAGEpochRef>>(std::move(next)));
+}
+
+uint64_t CDAGSystem::GetTipEpoch() {
+    LOCK(cs_epochs);
+    return nTipEpoch;
+}
+
+void CDAGSystem::CreateCacheInPlace(const std::array<uint8_t, 32>& seed, uint64_t nBytes, std::vector<uint32_t>& cache) {
+    uint64_t items = nBytes / HASH_BYTES;
+    cache.assign(nBytes / sizeof(uint32_t), 0);
     sph_blake256_context ctx;
     sph_blake256_init(&ctx);
-    sph_blake256(&ctx, seedCache[epoch].data(), HASH_BYTES);
-    sph_blake256_close(&ctx, cacheCache[epoch].data());
+    sph_blake256(&ctx, seed.data(), HASH_BYTES);
+    sph_blake256_close(&ctx, cache.data());
     //First 32 bytes of cache are written to with hash of seed.
     for(uint64_t i = 1; i < items; i++){
         //Hash last item of the cache repeatedly the generate all items.
         uint8_t hasheditem[HASH_BYTES];
         sph_blake256_init(&ctx);
-        sph_blake256(&ctx, cacheCache[epoch].data() + (i - 1)*(HASH_BYTES / sizeof(uint32_t)), HASH_BYTES);
+        sph_blake256(&ctx, cache.data() + (i - 1)*(HASH_BYTES / sizeof(uint32_t)), HASH_BYTES);
         sph_blake256_close(&ctx, hasheditem);
-        std::memcpy(cacheCache[epoch].data() + i*(HASH_BYTES / sizeof(uint32_t)), hasheditem, HASH_BYTES);
+        std::memcpy(cache.data() + i*(HASH_BYTES / sizeof(uint32_t)), hasheditem, HASH_BYTES);
     }
     for(uint64_t round = 0; round < CACHE_ROUNDS; round++) {
         //3 round randmemohash.
         for(uint64_t i = 0; i < items; i++) {
-            uint64_t target = cacheCache[epoch][(i * (HASH_BYTES / sizeof(uint32_t)))] % items;
+            uint64_t target = cache[(i * (HASH_BYTES / sizeof(uint32_t)))] % items;
             uint64_t mapper = (i - 1 + items) % items;
             /* Map target onto mapper, hash it,
              * then replace the current cache item with the 32 byte result. */
             uint32_t item[HASH_BYTES / sizeof(uint32_t)];
             for(uint64_t dword = 0; dword < (HASH_BYTES / sizeof(uint32_t)); dword++) {
-                item[dword] = cacheCache[epoch][(mapper * (HASH_BYTES / sizeof(uint32_t))) + dword]
-                            ^ cacheCache[epoch][(target * (HASH_BYTES / sizeof(uint32_t))) + dword];
+                item[dword] = cache[(mapper * (HASH_BYTES / sizeof(uint32_t))) + dword]
+                            ^ cache[(target * (HASH_BYTES / sizeof(uint32_t))) + dword];
             }
             sph_blake256_init(&ctx);
             sph_blake256(&ctx, item, HASH_BYTES);
             sph_blake256_close(&ctx, item);
-            std::memcpy(cacheCache[epoch].data() + (i * (HASH_BYTES / sizeof(uint32_t))), item, HASH_BYTES);
+            std::memcpy(cache.data() + (i * (HASH_BYTES / sizeof(uint32_t))), item, HASH_BYTES);
         }
     }
-
 }
 
-void CDAGSystem::CreateGraphInPlace(uint64_t epoch) {
-    uint64_t items = GetGraphSize(epoch) / HASH_BYTES;
-    graphCache[epoch].resize(items * (HASH_BYTES / WORD_BYTES), 0);
-    for(uint64_t i = 0; i < items; i++) {
-        CDAGNode node = GetNode(i, epoch*EPOCH_LENGTH);
-        memcpy(graphCache[epoch].data() + (i * (HASH_BYTES / sizeof(uint32_t))), node.GetNodePtr(), HASH_BYTES);
+bool CDAGSystem::CreateGraphInPlace(uint64_t epoch, const CDAGTable& cachetable, uint64_t nBytes, std::vector<uint32_t>& graph) {
+    static const uint64_t CHUNK_ITEMS = 4096;
+    const uint64_t items = nBytes / HASH_BYTES;
+    const uint64_t cacheitems = cachetable.size() * sizeof(uint32_t) / HASH_BYTES;
+    const uint32_t *cache = cachetable.data();
+    const uint64_t chunks = (items + CHUNK_ITEMS - 1) / CHUNK_ITEMS;
+    graph.assign(items * (HASH_BYTES / WORD_BYTES), 0);
+    const int nThreads = std::max(1, std::min(nGraphThreads, MAX_DAG_THREADS));
+
+    std::atomic<uint64_t> nextChunk(0);
+    std::atomic<uint64_t> doneChunks(0);
+    std::atomic<bool> fAbort(false);
+    // Every item only depends on the cache, so workers simply pull chunks until none are left.
+    auto worker = [&](bool fReport) {
+        int nLastProgress = -1;
+        while (!fAbort) {
+            if (GraphInterrupt && GraphInterrupt()) {
+                fAbort = true;
+                break;
+            }
+            uint64_t chunk = nextChunk++;
+            if (chunk >= chunks)
+                break;
+            uint64_t end = std::min(items, (chunk + 1) * CHUNK_ITEMS);
+            for (uint64_t i = chunk * CHUNK_ITEMS; i < end; i += NODE_LANES) {
+                uint64_t indices[NODE_LANES];
+                size_t n = std::min<uint64_t>(NODE_LANES, end - i);
+                for (size_t lane = 0; lane < n; lane++) {
+                    indices[lane] = i + lane;
+                }
+                CalcNodes(indices, n, cache, cacheitems, graph.data() + (i * (HASH_BYTES / sizeof(uint32_t))));
+            }
+            uint64_t done = ++doneChunks;
+            int nProgress = (int)(done * 100 / chunks);
+            if (fReport && nProgress != nLastProgress && GraphProgress) {
+                GraphProgress(epoch, std::min(nProgress, 99));
+                nLastProgress = nProgress;
+            }
+        }
+    };
+
+    if (GraphLog)
+        GraphLog(strprintf("Generating DAG for epoch %u (%u items) using %d threads", epoch, items, nThreads));
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 1; t < nThreads; t++) {
+        threads.emplace_back(worker, false);
     }
+    worker(true);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    if (GraphProgress)
+        GraphProgress(epoch, 100);
+    if (fAbort || doneChunks != chunks) {
+        if (GraphLog)
+            GraphLog(strprintf("DAG generation for epoch %u interrupted", epoch));
+        return false;
+    }
+    if (GraphLog) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        GraphLog(strprintf("Generated DAG for epoch %u in %dms", epoch, elapsed.count()));
+    }
+    return true;
 }
 
-void CDAGSystem::PopulateCacheEpoch(uint64_t epoch) {
-    if(!cacheCache[epoch].empty()) {
-        return;
+CDAGEpochRef CDAGSystem::PopulateCacheEpoch(uint64_t epoch) {
+    CDAGEpochRef ref = LookupEpoch(epoch);
+    if(ref) {
+        return ref;
     }
     static CCriticalSection cs;
     {
         LOCK(cs);
-        if(epoch > 1) {
-            if(cacheCache[epoch - 2].size() > 0) {
-                cacheCache[epoch - 2] = std::vector<uint32_t>();
+        ref = LookupEpoch(epoch);
+        if(ref) {
+            return ref;
+        }
+        std::shared_ptr<CDAGEpoch> dag = std::make_shared<CDAGEpoch>();
+        dag->epoch = epoch;
+        dag->seed = PopulateSeedEpoch(epoch);
+        dag->cache = FindTable(CDAGTable::CACHE, epoch, dag->seed, GetCacheSize(epoch));
+        if(!dag->cache) {
+            std::vector<uint32_t> data;
+            CreateCacheInPlace(dag->seed, GetCacheSize(epoch), data);
+            dag->cache = std::make_shared<CDAGTable>(std::move(data));
+            if(SaveTable) {
+                SaveTable(CDAGTable::CACHE, epoch, dag->seed, dag->cache);
             }
         }
-        PopulateSeedEpoch(epoch);
-        CreateCacheInPlace(epoch);
+        PublishEpoch(dag);
+        return dag;
     }
 }
 
-void CDAGSystem::PopulateGraphEpoch(uint64_t epoch) {
-    if(!graphCache[epoch].empty()) {
-        return;
+CDAGEpochRef CDAGSystem::PopulateGraphEpoch(uint64_t epoch) {
+    CDAGEpochRef ref = PopulateCacheEpoch(epoch);
+    if(ref->graph) {
+        return ref;
     }
     static CCriticalSection cs;
     {
         LOCK(cs);
-        PopulateSeedEpoch(epoch);
-        PopulateCacheEpoch(epoch);
-        CreateGraphInPlace(epoch);
+        ref = PopulateCacheEpoch(epoch);
+        if(ref->graph) {
+            return ref;
+        }
+        std::shared_ptr<const CDAGTable> graph = FindTable(CDAGTable::GRAPH, epoch, ref->seed, GetGraphSize(epoch));
+        if(!graph) {
+            std::vector<uint32_t> data;
+            if(!CreateGraphInPlace(epoch, *ref->cache, GetGraphSize(epoch), data)) {
+                return ref;
+            }
+            graph = std::make_shared<CDAGTable>(std::move(data));
+            if(SaveTable) {
+                SaveTable(CDAGTable::GRAPH, epoch, ref->seed, graph);
+            }
+        }
+        // Publish a new snapshot sharing the cache, threads holding the old one are unaffected.
+        std::shared_ptr<CDAGEpoch> dag = std::make_shared<CDAGEpoch>(*ref);
+        dag->graph = std::move(graph);
+        PublishEpoch(dag);
+        return dag;
     }
 }
 
-CDAGNode CDAGSystem::GetNode(uint64_t i, int32_t height) {
+CDAGEpochRef CDAGSystem::CreateEpoch(uint64_t epoch, uint64_t nCacheBytes, uint64_t nGraphBytes) {
+    std::shared_ptr<CDAGEpoch> dag = std::make_shared<CDAGEpoch>();
+    dag->epoch = epoch;
+    dag->seed = PopulateSeedEpoch(epoch);
+    std::vector<uint32_t> data;
+    CreateCacheInPlace(dag->seed, nCacheBytes, data);
+    dag->cache = std::make_shared<CDAGTable>(std::move(data));
+    data.clear();
+    if(CreateGraphInPlace(epoch, *dag->cache, nGraphBytes, data)) {
+        dag->graph = std::make_shared<CDAGTable>(std::move(data));
+    }
+    return dag;
+}
+
+void CDAGSystem::CalcNode(uint64_t i, const uint32_t *cache, uint64_t items, uint32_t *mix) {
+    CalcNodes(&i, 1, cache, items, mix);
+}
+
+void CDAGSystem::CalcNodes(const uint64_t *indices, size_t n, const uint32_t *cache, uint64_t items, uint32_t *out) {
+    static_assert(HASH_BYTES / sizeof(uint32_t) == 8, "parent mixing works on 8 word nodes");
+    assert(n <= NODE_LANES);
     sph_blake256_context ctx;
-    uint64_t epoch = height / EPOCH_LENGTH;
-    PopulateCacheEpoch(epoch);
-    uint64_t items = GetCacheSize(epoch) / HASH_BYTES;
-    uint32_t *mix = new uint32_t[HASH_BYTES / sizeof(uint32_t)];
-    std::memcpy(mix, cacheCache[epoch].data() + ((i % items) * (HASH_BYTES / sizeof(uint32_t))), HASH_BYTES);
-    mix[0] ^= i;
-    sph_blake256_init(&ctx);
-    sph_blake256(&ctx, mix, HASH_BYTES);
-    sph_blake256_close(&ctx, mix);
-    for(uint64_t parent = 0; parent < DATASET_PARENTS; parent++) {
-        uint64_t index = fnv(i ^ parent, mix[parent % (HASH_BYTES / sizeof(uint32_t))]) % items;
-        for(uint64_t dword = 0; dword < (HASH_BYTES / sizeof(uint32_t)); dword++) {
-            mix[dword] = fnv(mix[dword], cacheCache[epoch][index * (HASH_BYTES / sizeof(uint32_t))]);
-        }
+    for(size_t lane = 0; lane < n; lane++) {
+        uint32_t *mix = out + (lane * (HASH_BYTES / sizeof(uint32_t)));
+        std::memcpy(mix, cache + ((indices[lane] % items) * (HASH_BYTES / sizeof(uint32_t))), HASH_BYTES);
+        mix[0] ^= indices[lane];
+        sph_blake256_init(&ctx);
+        sph_blake256(&ctx, mix, HASH_BYTES);
+        sph_blake256_close(&ctx, mix);
     }
-    sph_blake256_init(&ctx);
-    sph_blake256(&ctx, mix, HASH_BYTES);
-    sph_blake256_close(&ctx, mix);
-    return CDAGNode(mix, false);
+    if(n == NODE_LANES) {
+        MixParents8(indices, cache, items, out, DATASET_PARENTS);
+    } else {
+        MixParentsGeneric(indices, n, cache, items, out, DATASET_PARENTS);
+    }
+    for(size_t lane = 0; lane < n; lane++) {
+        uint32_t *mix = out + (lane * (HASH_BYTES / sizeof(uint32_t)));
+        sph_blake256_init(&ctx);
+        sph_blake256(&ctx, mix, HASH_BYTES);
+        sph_blake256_close(&ctx, mix);
+    }
+}
+
+std::shared_ptr<const CDAGTable> CDAGSystem::FindTable(CDAGTable::Type type, uint64_t epoch, const std::array<uint8_t, 32>& seed, uint64_t nBytes) {
+    if(!LoadTable) {
+        return nullptr;
+    }
+    std::shared_ptr<const CDAGTable> table = LoadTable(type, epoch, seed, nBytes);
+    // Never trust a table of the wrong size, whatever was found
+    if(table && table->size() * sizeof(uint32_t) != nBytes) {
+        return nullptr;
+    }
+    return table;
+}
+
+uint64_t CDAGSystem::GetEpoch(int32_t height) {
+    return height / EPOCH_LENGTH;
+}
+
+std::array<uint8_t, 32> CDAGSystem::GetSeed(uint64_t epoch) {
+    return PopulateSeedEpoch(epoch);
+}
+
+bool CDAGSystem::HasCache(uint64_t epoch) {
+    return LookupEpoch(epoch) != nullptr;
+}
+
+bool CDAGSystem::HasGraph(uint64_t epoch) {
+    CDAGEpochRef ref = LookupEpoch(epoch);
+    return ref && ref->graph;
+}
+
+void CDAGSystem::DropGraph(uint64_t epoch) {
+    LOCK(cs_epochs);
+    std::shared_ptr<std::map<uint64_t, CDAGEpochRef>> next = std::make_shared<std::map<uint64_t, CDAGEpochRef>>(*std::atomic_load(&epochs));
+    auto it = next->find(epoch);
+    if(it == next->end() || !it->second->graph) {
+        return;
+    }
+    std::shared_ptr<CDAGEpoch> dag = std::make_shared<CDAGEpoch>(*it->second);
+    dag->graph = nullptr;
+    it->second = std::move(dag);
+    std::atomic_store(&epochs, std::shared_ptr<const std::map<uint64_t, CDAGEpochRef>>(std::move(next)));
+}
+
+bool CDAGSystem::PrepareEpoch(uint64_t epoch, bool fGraph) {
+    if(fGraph) {
+        return PopulateGraphEpoch(epoch)->graph != nullptr;
+    }
+    PopulateCacheEpoch(epoch);
+    return true;
+}
+
+CDAGNode CDAGSystem::GetNode(uint64_t i, const CDAGEpoch& dag) {
+    static_assert(CDAGNode::WORDS == HASH_BYTES / sizeof(uint32_t), "a node holds one item");
+    uint64_t items = dag.cache->size() * sizeof(uint32_t) / HASH_BYTES;
+    CDAGNode node;
+    CalcNode(i, dag.cache->data(), items, node.words);
+    return node;
+}
+
+CDAGNode CDAGSystem::GetNode(uint64_t i, int32_t height) {
+    return GetNode(i, *PopulateCacheEpoch(height / EPOCH_LENGTH));
 }
 
 CDAGNode CDAGSystem::GetNodeFromGraph(uint64_t i, int32_t height) {
-    uint64_t epoch = height / EPOCH_LENGTH;
-    PopulateGraphEpoch(epoch);
-    return CDAGNode(graphCache[epoch].data() + (i * (HASH_BYTES / sizeof(uint32_t))), true);
+    CDAGEpochRef dag = PopulateGraphEpoch(height / EPOCH_LENGTH);
+    if(!dag->graph) {
+        return GetNode(i, *dag);
+    }
+    const uint32_t *ptr = dag->graph->data() + (i * (HASH_BYTES / sizeof(uint32_t)));
+    return CDAGNode(ptr, std::move(dag));
 }
 
-CHashimotoResult CDAGSystem::Hashimoto(CBlockHeader header) {
-    uint64_t epoch = header.height / EPOCH_LENGTH;
-    uint64_t items = GetGraphSize(epoch) / HASH_BYTES;
+CHashimotoResult CDAGSystem::Hashimoto(const CBlockHeader& header) {
+    CHashimotoResult result = CHashimotoResult(uint128(), uint256());
+    HashimotoLanes(&header, 1, *PopulateCacheEpoch(header.height / EPOCH_LENGTH), &result);
+    return result;
+}
+
+void CDAGSystem::HashimotoLanes(const CBlockHeader *headers, size_t n, const CDAGEpoch& dag, CHashimotoResult *results) {
+    assert(n <= HEADER_LANES);
+    uint64_t items = GetGraphSize(dag.epoch) / HASH_BYTES;
+    uint64_t cacheitems = dag.cache->size() * sizeof(uint32_t) / HASH_BYTES;
     const uint64_t mixhashes = MIX_BYTES / HASH_BYTES;
-    uint32_t headerhash[HASH_BYTES / sizeof(uint32_t)];
-    uint32_t mix[MIX_BYTES / sizeof(uint32_t)];
-    uint32_t cmix[(MIX_BYTES / sizeof(uint32_t)) / sizeof(uint32_t)];
-    lyra2re2_hash((char*)&header, (char*)headerhash);
-    for(uint64_t i = 0; i < mixhashes; i++) {
-        std::memcpy(mix + (i * (HASH_BYTES / sizeof(uint32_t))), headerhash, HASH_BYTES);
+    uint32_t headerhash[HEADER_LANES][HASH_BYTES / sizeof(uint32_t)];
+    uint32_t mix[HEADER_LANES][MIX_BYTES / sizeof(uint32_t)];
+    const char *inputs[HEADER_LANES];
+    char *outputs[HEADER_LANES];
+    for(size_t h = 0; h < n; h++) {
+        assert(headers[h].height / EPOCH_LENGTH == dag.epoch);
+        inputs[h] = (const char*)&headers[h];
+        outputs[h] = (char*)headerhash[h];
     }
+    lyra2re2_hash_batch(inputs, outputs, n);
+    for(size_t h = 0; h < n; h++) {
+        for(uint64_t i = 0; i < mixhashes; i++) {
+            std::memcpy(mix[h] + (i * (HASH_BYTES / sizeof(uint32_t))), headerhash[h], HASH_BYTES);
+        }
+    }
+    // Every access of a header depends on the previous one, but the accesses of different headers don't, so all
+    // of the headers' nodes of one access are derived together.
     for(uint64_t i = 0; i < ACCESSES; i++) {
-        uint32_t target = (fnv(i ^ headerhash[0], mix[i % (MIX_BYTES / sizeof(uint32_t))]) % (items / mixhashes)) * mixhashes;
-        uint32_t mapdata[MIX_BYTES / sizeof(uint32_t)];
-        for(uint64_t mixhash = 0; mixhash < mixhashes; mixhash++) {
-            CDAGNode node = GetNode(target + mixhash, header.height);
-            assert((mixhash * (HASH_BYTES / sizeof(uint32_t))) < 16);
-            std::memcpy(mapdata + (mixhash * (HASH_BYTES / sizeof(uint32_t))), node.GetNodePtr(), HASH_BYTES);
+        uint64_t nodes[NODE_LANES];
+        uint32_t mapdata[HEADER_LANES][MIX_BYTES / sizeof(uint32_t)];
+        for(size_t h = 0; h < n; h++) {
+            uint32_t target = (fnv(i ^ headerhash[h][0], mix[h][i % (MIX_BYTES / sizeof(uint32_t))]) % (items / mixhashes)) * mixhashes;
+            for(uint64_t mixhash = 0; mixhash < mixhashes; mixhash++) {
+                nodes[h * mixhashes + mixhash] = target + mixhash;
+            }
         }
-        for(uint64_t dword = 0; dword < (MIX_BYTES / sizeof(uint32_t)); dword++) {
-            mix[dword] = fnv(mix[dword], mapdata[dword]);
-            assert(dword < sizeof(mix));
+        CalcNodes(nodes, n * mixhashes, dag.cache->data(), cacheitems, mapdata[0]);
+        for(size_t h = 0; h < n; h++) {
+            for(uint64_t dword = 0; dword < (MIX_BYTES / sizeof(uint32_t)); dword++) {
+                mix[h][dword] = fnv(mix[h][dword], mapdata[h][dword]);
+            }
         }
     }
+    for(size_t h = 0; h < n; h++) {
+        results[h] = FinalizeHashimoto(headers[h], headerhash[h], mix[h]);
+    }
+}
+
+CHashimotoResult CDAGSystem::FinalizeHashimoto(const CBlockHeader& header, const uint32_t *headerhash, const uint32_t *mix) {
+    uint32_t cmix[(MIX_BYTES / sizeof(uint32_t)) / sizeof(uint32_t)];
     for(uint64_t i = 0; i < MIX_BYTES / sizeof(uint32_t); i += sizeof(uint32_t)) {
         cmix[i / sizeof(uint32_t)] = fnv(fnv(fnv(mix[i], mix[i+1]), mix[i+2]), mix[i+3]);
-        assert((i/4) < sizeof(cmix));
     }
     uint128 resmix;
     uint256 result;
@@ -244,38 +646,61 @@ CHashimotoResult CDAGSystem::Hashimoto(CBlockHeader header) {
     return CHashimotoResult(resmix, result);
 }
 
-CHashimotoResult CDAGSystem::FastHashimoto(CBlockHeader header) {
+void CDAGSystem::HashimotoRun(const CBlockHeader *headers, size_t n, CHashimotoResult *results) {
+    assert(n > 0 && n <= HEADER_LANES);
+    CDAGEpochRef dag = PopulateCacheEpoch(headers[0].height / EPOCH_LENGTH);
+    HashimotoLanes(headers, n, *dag, results);
+}
+
+CHashimotoResult CDAGSystem::FastHashimoto(const CBlockHeader& header) {
+    uint32_t headerhash[HASH_BYTES / sizeof(uint32_t)];
+    lyra2re2_hash((const char*)&header, (char*)headerhash);
+    return FastHashimoto(header, headerhash);
+}
+
+CHashimotoResult CDAGSystem::FastHashimoto(const CBlockHeader& header, const lyra2re2_midstate& midstate) {
+    uint32_t headerhash[HASH_BYTES / sizeof(uint32_t)];
+    lyra2re2_hash_midstate(&midstate, (const char*)&header + 64, (char*)headerhash);
+    return FastHashimoto(header, headerhash);
+}
+
+CHashimotoResult CDAGSystem::FastHashimoto(const CBlockHeader& header, const uint32_t *headerhash) {
     uint64_t epoch = header.height / EPOCH_LENGTH;
     uint64_t items = GetGraphSize(epoch) / HASH_BYTES;
-    const uint64_t mixhashes = MIX_BYTES / HASH_BYTES;
+    CDAGEpochRef dag = PopulateGraphEpoch(epoch);
+    return GraphHashimoto(header, headerhash, *dag, items);
+}
+
+CHashimotoResult CDAGSystem::FastHashimoto(const CBlockHeader& header, const CDAGEpoch& dag, uint64_t items) {
+    assert(header.height / EPOCH_LENGTH == dag.epoch);
     uint32_t headerhash[HASH_BYTES / sizeof(uint32_t)];
+    lyra2re2_hash((const char*)&header, (char*)headerhash);
+    return GraphHashimoto(header, headerhash, dag, items);
+}
+
+CHashimotoResult CDAGSystem::GraphHashimoto(const CBlockHeader& header, const uint32_t *headerhash, const CDAGEpoch& dag, uint64_t items) {
+    const uint64_t mixhashes = MIX_BYTES / HASH_BYTES;
     uint32_t mix[MIX_BYTES / sizeof(uint32_t)];
-    uint32_t cmix[(MIX_BYTES / sizeof(uint32_t)) / sizeof(uint32_t)];
-    lyra2re2_hash((char*)&header, (char*)headerhash);
     for(uint64_t i = 0; i < mixhashes; i++) {
         std::memcpy(mix + (i * (HASH_BYTES / sizeof(uint32_t))), headerhash, HASH_BYTES);
     }
+    const uint32_t *graph = dag.graph ? dag.graph->data() : nullptr;
+    const uint64_t cacheitems = dag.cache->size() * sizeof(uint32_t) / HASH_BYTES;
     for(uint64_t i = 0; i < ACCESSES; i++) {
         uint32_t target = fnv(i ^ headerhash[0], mix[i % (MIX_BYTES / sizeof(uint32_t))]) % (items / mixhashes) * mixhashes;
         uint32_t mapdata[MIX_BYTES / sizeof(uint32_t)];
-        for(uint64_t mixhash = 0; mixhash < mixhashes; mixhash++) {
-            CDAGNode node = GetNodeFromGraph(target + mixhash, header.height);
-            std::memcpy(mapdata + (mixhash * (HASH_BYTES / sizeof(uint32_t))), node.GetNodePtr(), HASH_BYTES);
+        if(graph) {
+            std::memcpy(mapdata, graph + (target * (HASH_BYTES / sizeof(uint32_t))), MIX_BYTES);
+        } else {
+            uint64_t nodes[mixhashes];
+            for(uint64_t mixhash = 0; mixhash < mixhashes; mixhash++) {
+                nodes[mixhash] = target + mixhash;
+            }
+            CalcNodes(nodes, mixhashes, dag.cache->data(), cacheitems, mapdata);
         }
         for(uint64_t dword = 0; dword < (MIX_BYTES / sizeof(uint32_t)); dword++) {
             mix[dword] = fnv(mix[dword], mapdata[dword]);
         }
     }
-    for(uint64_t i = 0; i < MIX_BYTES / sizeof(uint32_t); i += sizeof(uint32_t)) {
-        cmix[i / sizeof(uint32_t)] = fnv(fnv(fnv(mix[i], mix[i+1]), mix[i+2]), mix[i+3]);
-    }
-    uint128 resmix;
-    uint256 result;
-    std::memcpy(resmix.begin(), cmix, MIX_BYTES / sizeof(uint32_t));
-    std::array<uint8_t, HEADER_BYTES> fhash;
-    std::memcpy(fhash.data(), headerhash, HASH_BYTES);
-    std::memcpy(fhash.data() + HASH_BYTES, &header.height, sizeof(int32_t));
-    std::memcpy(fhash.data() + HASH_BYTES + sizeof(int32_t), cmix, MIX_BYTES / sizeof(uint32_t));
-    lyra2re2_hash52((char*)fhash.data(), (char*)result.begin());
-    return CHashimotoResult(resmix, result);
+    return FinalizeHashimoto(header, headerhash, mix);
 }
@@ -2,22 +2,94 @@
 #define DAG_H
 
 #include <array>
+#include <functional>
+#include <list>
 #include <map>
+#include <memory>
+#include <string>
 #include <vector>
+#include "sync.h"
 #include "uint256.h"
 
 class CBlockHeader;
+struct lyra2re2_midstate;
 
+/** -dagthreads default (0 = one thread per core) */
+static const int DEFAULT_DAG_THREADS = 0;
+/** Maximum number of threads used to generate a graph */
+static const int MAX_DAG_THREADS = 64;
+/** Autodetect the best available parent mixing implementation. Returns the name of the implementation. */
+std::string DAGAutoDetect();
+
+struct CDAGEpoch;
+typedef std::shared_ptr<const CDAGEpoch> CDAGEpochRef;
+
+/** A DAG item, either viewed in place inside an epoch's graph or computed into the node itself */
 class CDAGNode {
 public:
-    CDAGNode(uint32_t *ptr, bool fGraphDerived);
+    static const size_t WORDS = 8;
+
+    /** Views the item at ptr inside the graph of epoch */
+    CDAGNode(const uint32_t *ptr, CDAGEpochRef epoch);
+
+    const uint32_t *GetNodePtr() const;
 
-    uint32_t *GetNodePtr();
+private:
+    friend class CDAGSystem;
+    /** Node an item is computed into by CDAGSystem */
+    CDAGNode();
+
+    uint32_t words[WORDS];
+    /** Item inside a graph, or null if the item is held in words */
+    const uint32_t *ptr;
+    /** Keeps the graph a graph derived node points into alive */
+    CDAGEpochRef epoch;
+};
 
-    ~CDAGNode();
+/**
+ * Read-only array of 32 bit words holding an epoch's cache or graph. It either owns its words on the heap or views
+ * words kept alive by an owner, such as a memory-mapped file that several processes share the pages of.
+ */
+class CDAGTable {
 private:
-    uint32_t *ptr;
-    bool fGraphDerived;
+    std::vector<uint32_t> vData;
+    /** Keeps the viewed words alive, null if the table owns them */
+    std::shared_ptr<const void> owner;
+    const uint32_t *pData;
+    uint64_t nWords;
+
+public:
+    enum Type : uint32_t {
+        CACHE = 0,
+        GRAPH = 1,
+    };
+
+    CDAGTable();
+    explicit CDAGTable(std::vector<uint32_t>&& vDataIn);
+    /** Views nWordsIn words at pDataIn, which stay valid as long as ownerIn is alive */
+    CDAGTable(const uint32_t *pDataIn, uint64_t nWordsIn, std::shared_ptr<const void> ownerIn);
+    CDAGTable(CDAGTable&& other);
+    CDAGTable& operator=(CDAGTable&& other);
+    CDAGTable(const CDAGTable&) = delete;
+    CDAGTable& operator=(const CDAGTable&) = delete;
+
+    const uint32_t *data() const { return pData; }
+    uint64_t size() const { return nWords; }
+    bool empty() const { return nWords == 0; }
+    bool IsMapped() const { return owner != nullptr; }
+    const uint32_t& operator[](uint64_t i) const { return pData[i]; }
+};
+
+/**
+ * Immutable snapshot of one epoch's DAG data. Snapshots are reference counted, so hashing threads keep using
+ * the one they fetched without any lock while a newer snapshot of the epoch is published or the epoch is evicted.
+ */
+struct CDAGEpoch {
+    uint64_t epoch;
+    std::array<uint8_t, 32> seed;
+    std::shared_ptr<const CDAGTable> cache;
+    /** Null until the graph of the epoch has been generated */
+    std::shared_ptr<const CDAGTable> graph;
 };
 
 class CHashimotoResult {
@@ -49,6 +121,8 @@ private:
     static const uint32_t CACHE_ROUNDS = 3;
     static const uint32_t ACCESSES = 64;
     static const uint32_t FNV_PRIME = 0x01000193;
+    /** Number of nodes derived side by side by CalcNodes */
+    static const size_t NODE_LANES = 8;
 
     /** Trivial primality check */
     static bool is_prime(uint64_t num);
@@ -56,46 +130,171 @@ private:
     /** FNV hash function */
     static uint32_t fnv(uint32_t v1, uint32_t v2);
 
-    /** Get cache size from epoch */
-    static uint64_t GetCacheSize(uint64_t epoch);
+    /** Sizes found for epochs past the end of the precomputed tables, guarded by GetSizes' lock */
+    static std::map<uint64_t, std::pair<uint64_t, uint64_t>> sizeCache;
+    /** Returns the cache and graph sizes of an epoch past the end of the precomputed tables */
+    static std::pair<uint64_t, uint64_t> GetSizes(uint64_t epoch);
 
-    /** Get graph size from epoch */
-    static uint64_t GetGraphSize(uint64_t epoch);
+    /** Computes graph item i from a cache of items 32 byte entries into out */
+    static void CalcNode(uint64_t i, const uint32_t *cache, uint64_t items, uint32_t *out);
+    /**
+     * Computes the n <= NODE_LANES graph items in indices into consecutive entries of out. Their parent fetches
+     * are interleaved, so the cache misses of independent items overlap instead of being waited for one by one.
+     */
+    static void CalcNodes(const uint64_t *indices, size_t n, const uint32_t *cache, uint64_t items, uint32_t *out);
 
-    /** Caches cache seeds in case of a need for regeneration */
+    /** Caches cache seeds in case of a need for regeneration, guarded by PopulateSeedEpoch's lock */
     static std::map<size_t, std::array<uint8_t, 32>> seedCache;
-    /** Caches caches to verify blocks */
-    static std::map<size_t, std::vector<uint32_t>> cacheCache;
-    /** Caches dags to generate blocks faster */
-    static std::map<size_t, std::vector<uint32_t>> graphCache;
+    /**
+     * Published epoch snapshots. The map itself is never modified once published: writers copy it, apply their
+     * change and swap the pointer with std::atomic_store, so readers only need a std::atomic_load.
+     */
+    static std::shared_ptr<const std::map<uint64_t, CDAGEpochRef>> epochs;
 
-    /** Populates seed of the epoch's epoch. */
-    static void PopulateSeedEpoch(uint64_t epoch);
-    /** Populates cache of the epoch's epoch.*/
-    static void PopulateCacheEpoch(uint64_t epoch);
-    /** Populates graph of the epoch's epoch */
-    static void PopulateGraphEpoch(uint64_t epoch);
+    /** Number of epochs outside of the active tip's window kept published */
+    static const size_t MAX_OTHER_EPOCHS = 2;
+    /** Guards publishing to epochs, nTipEpoch and otherEpochs */
+    static CCriticalSection cs_epochs;
+    /** Epoch of the active tip, NO_EPOCH if not known yet */
+    static uint64_t nTipEpoch;
+    /** Published epochs outside of the active tip's window, most recently published first */
+    static std::list<uint64_t> otherEpochs;
 
-    /** Actually creates a cache from seed and size data */
-    static void CreateCacheInPlace(uint64_t epoch);
+    /** Returns the published snapshot of the epoch, or null */
+    static CDAGEpochRef LookupEpoch(uint64_t epoch);
+    /** Returns whether the epoch is the active tip's, the one before it or the one after it. cs_epochs must be held. */
+    static bool IsTipWindowEpoch(uint64_t epoch);
+    /** Drops the epochs neither in the active tip's window nor among the recent other epochs from next. cs_epochs must be held. */
+    static void EvictEpochs(std::map<uint64_t, CDAGEpochRef>& next);
+    /**
+     * Publishes a snapshot, replacing any previous one of its epoch. Epochs outside of the active tip's window,
+     * such as those of headers far from the tip, only displace each other and never the window's epochs.
+     */
+    static void PublishEpoch(CDAGEpochRef ref);
 
-    /** Actually creates a graph from a cache */
-    static void CreateGraphInPlace(uint64_t epoch);
+    /** Returns the table LoadTable found for an epoch's cache or graph, or null */
+    static std::shared_ptr<const CDAGTable> FindTable(CDAGTable::Type type, uint64_t epoch, const std::array<uint8_t, 32>& seed, uint64_t nBytes);
+
+    /** Populates seed of the epoch's epoch and returns it. */
+    static std::array<uint8_t, 32> PopulateSeedEpoch(uint64_t epoch);
+    /** Populates cache of the epoch's epoch and returns its snapshot.*/
+    static CDAGEpochRef PopulateCacheEpoch(uint64_t epoch);
+    /** Populates graph of the epoch's epoch and returns its snapshot, without a graph if generation was interrupted */
+    static CDAGEpochRef PopulateGraphEpoch(uint64_t epoch);
+
+    /** Actually creates a graph of nBytes for the epoch from a cache, split across nGraphThreads workers */
+    static bool CreateGraphInPlace(uint64_t epoch, const CDAGTable& cache, uint64_t nBytes, std::vector<uint32_t>& graph);
+
+    /** Gets node i of the snapshot's epoch from its cache */
+    static CDAGNode GetNode(uint64_t i, const CDAGEpoch& dag);
+
+    /** Runs the hashimoto function using the cache on n <= HEADER_LANES headers of the snapshot's epoch */
+    static void HashimotoLanes(const CBlockHeader *headers, size_t n, const CDAGEpoch& dag, CHashimotoResult *results);
+    /** Runs the hashimoto function using the graph on a header whose lyra2re2 hash is headerhash */
+    static CHashimotoResult FastHashimoto(const CBlockHeader& header, const uint32_t *headerhash);
+    /** Runs the hashimoto function on a header whose lyra2re2 hash is headerhash using the snapshot's graph of items items */
+    static CHashimotoResult GraphHashimoto(const CBlockHeader& header, const uint32_t *headerhash, const CDAGEpoch& dag, uint64_t items);
+    /** Derives cmix and the final hash from a header's lyra2re2 hash and its final mix */
+    static CHashimotoResult FinalizeHashimoto(const CBlockHeader& header, const uint32_t *headerhash, const uint32_t *mix);
 
 public:
+    /** Number of headers hashed side by side by HashimotoRun, each of them fetching MIX_BYTES / HASH_BYTES nodes */
+    static const size_t HEADER_LANES = NODE_LANES / (MIX_BYTES / HASH_BYTES);
+
+    /** Value of GetTipEpoch until SetTipEpoch is first called */
+    static const uint64_t NO_EPOCH = UINT64_MAX;
+
+    /** Number of threads used to generate a graph, at least one */
+    static int nGraphThreads;
+    /** Called with the epoch and percentage done while a graph is being generated */
+    static std::function<void(uint64_t, int)> GraphProgress;
+    /** Called with a line worth logging about the generation of a graph */
+    static std::function<void(const std::string&)> GraphLog;
+    /** Polled while a graph is being generated, returning true abandons the graph */
+    static std::function<bool()> GraphInterrupt;
+    /**
+     * Looks up a previously saved cache or graph of an epoch with the given seed and size, returning null if there
+     * is none. Unset, or returning null, means the table is generated.
+     */
+    static std::function<std::shared_ptr<const CDAGTable>(CDAGTable::Type, uint64_t, const std::array<uint8_t, 32>&, uint64_t)> LoadTable;
+    /** Called, from whichever thread generated it, with every cache and graph generated, to save it for LoadTable */
+    static std::function<void(CDAGTable::Type, uint64_t, const std::array<uint8_t, 32>&, std::shared_ptr<const CDAGTable>)> SaveTable;
+
+    /** Returns the epoch a block height belongs to */
+    static uint64_t GetEpoch(int32_t height);
+
+    /**
+     * Sets the epoch of the active tip. Its epoch, the one before it and the one after it stay published, any
+     * other epochs are evicted once more than MAX_OTHER_EPOCHS of them have been published since.
+     */
+    static void SetTipEpoch(uint64_t epoch);
+    /** Returns the epoch of the active tip, NO_EPOCH if not known yet */
+    static uint64_t GetTipEpoch();
+
+    /** Returns the seed the cache and graph of epoch are built from */
+    static std::array<uint8_t, 32> GetSeed(uint64_t epoch);
+
+    /** Get cache size in bytes from epoch, looked up in a table or computed once */
+    static uint64_t GetCacheSize(uint64_t epoch);
+    /** Get graph size in bytes from epoch, looked up in a table or computed once */
+    static uint64_t GetGraphSize(uint64_t epoch);
+    /** Searches the cache size of epoch, which takes a primality search. Use GetCacheSize instead. */
+    static uint64_t CalcCacheSize(uint64_t epoch);
+    /** Searches the graph size of epoch, which takes a primality search. Use GetGraphSize instead. */
+    static uint64_t CalcGraphSize(uint64_t epoch);
+
+    /** Returns whether the cache of the epoch is resident */
+    static bool HasCache(uint64_t epoch);
+    /** Returns whether the graph of the epoch is resident */
+    static bool HasGraph(uint64_t epoch);
+    /** Drops the resident graph of the epoch, such as one found to be corrupt, so that it is built again when needed */
+    static void DropGraph(uint64_t epoch);
+
+    /**
+     * Builds the seed and cache of the epoch, and its graph if fGraph, ahead of the first header that needs them.
+     * Returns false if graph generation was interrupted.
+     */
+    static bool PrepareEpoch(uint64_t epoch, bool fGraph);
+
     /** Gets node from cache, much slower(on the order of 100x, but uses about that much less memory. */
     static CDAGNode GetNode(uint64_t i, int32_t height);
     /**
      * Gets node from cached graph, delayed to generate the needed graph(which may take several minutes), but once it
-     * is generated, returning a node is effectively instant.
+     * is generated, returning a node is effectively instant. Falls back to GetNode if generation was interrupted.
      */
     static CDAGNode GetNodeFromGraph(uint64_t i, int32_t height);
 
+    /** Actually creates a cache of nBytes from seed */
+    static void CreateCacheInPlace(const std::array<uint8_t, 32>& seed, uint64_t nBytes, std::vector<uint32_t>& cache);
+
+    /**
+     * Builds a snapshot of the epoch with a cache of nCacheBytes and a graph of nGraphBytes from its seed, without
+     * publishing it, so that benchmarks can run the graph path without generating a full size graph. Its graph is
+     * null if generation was interrupted.
+     */
+    static CDAGEpochRef CreateEpoch(uint64_t epoch, uint64_t nCacheBytes, uint64_t nGraphBytes);
+
     /** Runs the hashimoto function on header using the cache */
-    static CHashimotoResult Hashimoto(CBlockHeader header);
+    static CHashimotoResult Hashimoto(const CBlockHeader& header);
 
     /** Runs the hashimoto function on header using the graph */
-    static CHashimotoResult FastHashimoto(CBlockHeader header);
+    static CHashimotoResult FastHashimoto(const CBlockHeader& header);
+    /**
+     * Runs the hashimoto function on header using the graph, finishing the lyra2re2 hash of the header from midstate,
+     * which was initialized from a header differing from this one in at most its last 16 bytes.
+     */
+    static CHashimotoResult FastHashimoto(const CBlockHeader& header, const lyra2re2_midstate& midstate);
+    /**
+     * Runs the hashimoto function on header using the graph of a snapshot of its epoch holding items graph items,
+     * such as one built by CreateEpoch, instead of the published one.
+     */
+    static CHashimotoResult FastHashimoto(const CBlockHeader& header, const CDAGEpoch& dag, uint64_t items);
+
+    /**
+     * Runs the hashimoto function using the cache on n <= HEADER_LANES headers of one epoch, with the headers' node
+     * derivations interleaved. results[i] is the same as Hashimoto(headers[i]).
+     */
+    static void HashimotoRun(const CBlockHeader *headers, size_t n, CHashimotoResult *results);
 
     static CHashimotoResult lastwork;
 };
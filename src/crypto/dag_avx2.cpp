@@ -0,0 +1,62 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// AVX2 version of the parent mixing loop of CDAGSystem::CalcNodes, deriving eight DAG nodes at once.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace dag_avx2
+{
+namespace {
+
+inline __m256i fnv(__m256i v1, __m256i v2)
+{
+    __m256i x = _mm256_xor_si256(_mm256_mullo_epi32(v1, _mm256_set1_epi32(0x01000193)), v2);
+    // x % UINT32_MAX only differs from x for x == UINT32_MAX, which becomes 0
+    return _mm256_andnot_si256(_mm256_cmpeq_epi32(x, _mm256_set1_epi32(-1)), x);
+}
+
+}
+
+/**
+ * mix holds 8 nodes of 8 words each, node after node. They are transposed so that register d holds word d of
+ * every node, which turns the 8 word FNV of a parent into 8 vector operations covering all nodes. Parent
+ * fetches stay scalar, but are issued back to back so their cache misses overlap.
+ */
+void MixParents(const uint64_t* indices, const uint32_t* cache, uint64_t items, uint32_t* mix, uint32_t parents)
+{
+    const __m256i lanes = _mm256_setr_epi32(0, 8, 16, 24, 32, 40, 48, 56);
+    __m256i m[8];
+    for (int d = 0; d < 8; d++) {
+        m[d] = _mm256_i32gather_epi32((const int*)(mix + d), lanes, 4);
+    }
+    const __m256i base = _mm256_setr_epi32((uint32_t)indices[0], (uint32_t)indices[1], (uint32_t)indices[2], (uint32_t)indices[3],
+                                           (uint32_t)indices[4], (uint32_t)indices[5], (uint32_t)indices[6], (uint32_t)indices[7]);
+    alignas(32) uint32_t selector[8];
+    alignas(32) uint32_t parentdata[8];
+    for (uint32_t parent = 0; parent < parents; parent++) {
+        __m256i sel = fnv(_mm256_xor_si256(base, _mm256_set1_epi32(parent)), m[parent % 8]);
+        _mm256_store_si256((__m256i*)selector, sel);
+        for (int l = 0; l < 8; l++) {
+            parentdata[l] = cache[(selector[l] % items) * 8];
+        }
+        __m256i data = _mm256_load_si256((const __m256i*)parentdata);
+        for (int d = 0; d < 8; d++) {
+            m[d] = fnv(m[d], data);
+        }
+    }
+    alignas(32) uint32_t out[8];
+    for (int d = 0; d < 8; d++) {
+        _mm256_store_si256((__m256i*)out, m[d]);
+        for (int l = 0; l < 8; l++) {
+            mix[l * 8 + d] = out[l];
+        }
+    }
+}
+}
+
+#endif
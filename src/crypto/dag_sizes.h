@@ -0,0 +1,1046 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_CRYPTO_DAG_SIZES_H
+#define BITCOIN_CRYPTO_DAG_SIZES_H
+
+#include <stdint.h>
+
+/**
+ * Cache and graph sizes in bytes of the first DAG_SIZES_EPOCHS epochs, as found by CDAGSystem::CalcCacheSize and
+ * CDAGSystem::CalcGraphSize. dag_tests checks every entry against them.
+ */
+static const uint64_t DAG_SIZES_EPOCHS = 2048;
+
+static const uint64_t dag_cache_sizes[DAG_SIZES_EPOCHS] = {
+    8388448U, 8781536U, 8977952U, 9174752U,
+    9371168U, 9371168U, 9567968U, 9567968U,
+    9764704U, 9764704U, 9961376U, 9961376U,
+    9961376U, 10157984U, 10157984U, 10157984U,
+    10354592U, 10354592U, 10354592U, 10551136U,
+    10551136U, 10551136U, 10551136U, 10747424U,
+    10747424U, 10747424U, 10747424U, 10943776U,
+    10943776U, 10943776U, 10943776U, 11140768U,
+    11140768U, 11140768U, 11140768U, 11140768U,
+    11337632U, 11337632U, 11337632U, 11337632U,
+    11337632U, 11534048U, 11534048U, 11534048U,
+    11534048U, 11534048U, 11729504U, 11729504U,
+    11729504U, 11729504U, 11729504U, 11729504U,
+    11927456U, 11927456U, 11927456U, 11927456U,
+    11927456U, 11927456U, 12123808U, 12123808U,
+    12123808U, 12123808U, 12123808U, 12123808U,
+    12320416U, 12320416U, 12320416U, 12320416U,
+    12320416U, 12320416U, 12320416U, 12517216U,
+    12517216U, 12517216U, 12517216U, 12517216U,
+    12517216U, 12517216U, 12713696U, 12713696U,
+    12713696U, 12713696U, 12713696U, 12713696U,
+    12713696U, 12910048U, 12910048U, 12910048U,
+    12910048U, 12910048U, 12910048U, 12910048U,
+    12910048U, 13107104U, 13107104U, 13107104U,
+    13107104U, 13107104U, 13107104U, 13107104U,
+    13107104U, 13303328U, 13303328U, 13303328U,
+    13303328U, 13303328U, 13303328U, 13303328U,
+    13303328U, 13499104U, 13499104U, 13499104U,
+    13499104U, 13499104U, 13499104U, 13499104U,
+    13499104U, 13499104U, 13696864U, 13696864U,
+    13696864U, 13696864U, 13696864U, 13696864U,
+    13696864U, 13696864U, 13696864U, 13893344U,
+    13893344U, 13893344U, 13893344U, 13893344U,
+    13893344U, 13893344U, 13893344U, 13893344U,
+    14089952U, 14089952U, 14089952U, 14089952U,
+    14089952U, 14089952U, 14089952U, 14089952U,
+    14089952U, 14089952U, 14286752U, 14286752U,
+    14286752U, 14286752U, 14286752U, 14286752U,
+    14286752U, 14286752U, 14286752U, 14286752U,
+    14483104U, 14483104U, 14483104U, 14483104U,
+    14483104U, 14483104U, 14483104U, 14483104U,
+    14483104U, 14483104U, 14679904U, 14679904U,
+    14679904U, 14679904U, 14679904U, 14679904U,
+    14679904U, 14679904U, 14679904U, 14679904U,
+    14679904U, 14876128U, 14876128U, 14876128U,
+    14876128U, 14876128U, 14876128U, 14876128U,
+    14876128U, 14876128U, 14876128U, 14876128U,
+    15072224U, 15072224U, 15072224U, 15072224U,
+    15072224U, 15072224U, 15072224U, 15072224U,
+    15072224U, 15072224U, 15072224U, 15269216U,
+    15269216U, 15269216U, 15269216U, 15269216U,
+    15269216U, 15269216U, 15269216U, 15269216U,
+    15269216U, 15269216U, 15269216U, 15466336U,
+    15466336U, 15466336U, 15466336U, 15466336U,
+    15466336U, 15466336U, 15466336U, 15466336U,
+    15466336U, 15466336U, 15466336U, 15662624U,
+    15662624U, 15662624U, 15662624U, 15662624U,
+    15662624U, 15662624U, 15662624U, 15662624U,
+    15662624U, 15662624U, 15662624U, 15859616U,
+    15859616U, 15859616U, 15859616U, 15859616U,
+    15859616U, 15859616U, 15859616U, 15859616U,
+    15859616U, 15859616U, 15859616U, 15859616U,
+    16055392U, 16055392U, 16055392U, 16055392U,
+    16055392U, 16055392U, 16055392U, 16055392U,
+    16055392U, 16055392U, 16055392U, 16055392U,
+    16055392U, 16252832U, 16252832U, 16252832U,
+    16252832U, 16252832U, 16252832U, 16252832U,
+    16252832U, 16252832U, 16252832U, 16252832U,
+    16252832U, 16252832U, 16448672U, 16448672U,
+    16448672U, 16448672U, 16448672U, 16448672U,
+    16448672U, 16448672U, 16448672U, 16448672U,
+    16448672U, 16448672U, 16448672U, 16448672U,
+    16644832U, 16644832U, 16644832U, 16644832U,
+    16644832U, 16644832U, 16644832U, 16644832U,
+    16644832U, 16644832U, 16644832U, 16644832U,
+    16644832U, 16644832U, 16841824U, 16841824U,
+    16841824U, 16841824U, 16841824U, 16841824U,
+    16841824U, 16841824U, 16841824U, 16841824U,
+    16841824U, 16841824U, 16841824U, 16841824U,
+    17038496U, 17038496U, 17038496U, 17038496U,
+    17038496U, 17038496U, 17038496U, 17038496U,
+    17038496U, 17038496U, 17038496U, 17038496U,
+    17038496U, 17038496U, 17038496U, 17235872U,
+    17235872U, 17235872U, 17235872U, 17235872U,
+    17235872U, 17235872U, 17235872U, 17235872U,
+    17235872U, 17235872U, 17235872U, 17235872U,
+    17235872U, 17235872U, 17432288U, 17432288U,
+    17432288U, 17432288U, 17432288U, 17432288U,
+    17432288U, 17432288U, 17432288U, 17432288U,
+    17432288U, 17432288U, 17432288U, 17432288U,
+    17432288U, 17629088U, 17629088U, 17629088U,
+    17629088U, 17629088U, 17629088U, 17629088U,
+    17629088U, 17629088U, 17629088U, 17629088U,
+    17629088U, 17629088U, 17629088U, 17629088U,
+    17629088U, 17825312U, 17825312U, 17825312U,
+    17825312U, 17825312U, 17825312U, 17825312U,
+    17825312U, 17825312U, 17825312U, 17825312U,
+    17825312U, 17825312U, 17825312U, 17825312U,
+    17825312U, 18022304U, 18022304U, 18022304U,
+    18022304U, 18022304U, 18022304U, 18022304U,
+    18022304U, 18022304U, 18022304U, 18022304U,
+    18022304U, 18022304U, 18022304U, 18022304U,
+    18022304U, 18218336U, 18218336U, 18218336U,
+    18218336U, 18218336U, 18218336U, 18218336U,
+    18218336U, 18218336U, 18218336U, 18218336U,
+    18218336U, 18218336U, 18218336U, 18218336U,
+    18218336U, 18218336U, 18415328U, 18415328U,
+    18415328U, 18415328U, 18415328U, 18415328U,
+    18415328U, 18415328U, 18415328U, 18415328U,
+    18415328U, 18415328U, 18415328U, 18415328U,
+    18415328U, 18415328U, 18415328U, 18611744U,
+    18611744U, 18611744U, 18611744U, 18611744U,
+    18611744U, 18611744U, 18611744U, 18611744U,
+    18611744U, 18611744U, 18611744U, 18611744U,
+    18611744U, 18611744U, 18611744U, 18611744U,
+    18808736U, 18808736U, 18808736U, 18808736U,
+    18808736U, 18808736U, 18808736U, 18808736U,
+    18808736U, 18808736U, 18808736U, 18808736U,
+    18808736U, 18808736U, 18808736U, 18808736U,
+    18808736U, 18808736U, 19004896U, 19004896U,
+    19004896U, 19004896U, 19004896U, 19004896U,
+    19004896U, 19004896U, 19004896U, 19004896U,
+    19004896U, 19004896U, 19004896U, 19004896U,
+    19004896U, 19004896U, 19004896U, 19004896U,
+    19201696U, 19201696U, 19201696U, 19201696U,
+    19201696U, 19201696U, 19201696U, 19201696U,
+    19201696U, 19201696U, 19201696U, 19201696U,
+    19201696U, 19201696U, 19201696U, 19201696U,
+    19201696U, 19201696U, 19397792U, 19397792U,
+    19397792U, 19397792U, 19397792U, 19397792U,
+    19397792U, 19397792U, 19397792U, 19397792U,
+    19397792U, 19397792U, 19397792U, 19397792U,
+    19397792U, 19397792U, 19397792U, 19397792U,
+    19397792U, 19595168U, 19595168U, 19595168U,
+    19595168U, 19595168U, 19595168U, 19595168U,
+    19595168U, 19595168U, 19595168U, 19595168U,
+    19595168U, 19595168U, 19595168U, 19595168U,
+    19595168U, 19595168U, 19595168U, 19595168U,
+    19790816U, 19790816U, 19790816U, 19790816U,
+    19790816U, 19790816U, 19790816U, 19790816U,
+    19790816U, 19790816U, 19790816U, 19790816U,
+    19790816U, 19790816U, 19790816U, 19790816U,
+    19790816U, 19790816U, 19790816U, 19987424U,
+    19987424U, 19987424U, 19987424U, 19987424U,
+    19987424U, 19987424U, 19987424U, 19987424U,
+    19987424U, 19987424U, 19987424U, 19987424U,
+    19987424U, 19987424U, 19987424U, 19987424U,
+    19987424U, 19987424U, 19987424U, 20183584U,
+    20183584U, 20183584U, 20183584U, 20183584U,
+    20183584U, 20183584U, 20183584U, 20183584U,
+    20183584U, 20183584U, 20183584U, 20183584U,
+    20183584U, 20183584U, 20183584U, 20183584U,
+    20183584U, 20183584U, 20183584U, 20381408U,
+    20381408U, 20381408U, 20381408U, 20381408U,
+    20381408U, 20381408U, 20381408U, 20381408U,
+    20381408U, 20381408U, 20381408U, 20381408U,
+    20381408U, 20381408U, 20381408U, 20381408U,
+    20381408U, 20381408U, 20381408U, 20577952U,
+    20577952U, 20577952U, 20577952U, 20577952U,
+    20577952U, 20577952U, 20577952U, 20577952U,
+    20577952U, 20577952U, 20577952U, 20577952U,
+    20577952U, 20577952U, 20577952U, 20577952U,
+    20577952U, 20577952U, 20577952U, 20577952U,
+    20773856U, 20773856U, 20773856U, 20773856U,
+    20773856U, 20773856U, 20773856U, 20773856U,
+    20773856U, 20773856U, 20773856U, 20773856U,
+    20773856U, 20773856U, 20773856U, 20773856U,
+    20773856U, 20773856U, 20773856U, 20773856U,
+    20773856U, 20971424U, 20971424U, 20971424U,
+    20971424U, 20971424U, 20971424U, 20971424U,
+    20971424U, 20971424U, 20971424U, 20971424U,
+    20971424U, 20971424U, 20971424U, 20971424U,
+    20971424U, 20971424U, 20971424U, 20971424U,
+    20971424U, 20971424U, 21167456U, 21167456U,
+    21167456U, 21167456U, 21167456U, 21167456U,
+    21167456U, 21167456U, 21167456U, 21167456U,
+    21167456U, 21167456U, 21167456U, 21167456U,
+    21167456U, 21167456U, 21167456U, 21167456U,
+    21167456U, 21167456U, 21167456U, 21167456U,
+    21364576U, 21364576U, 21364576U, 21364576U,
+    21364576U, 21364576U, 21364576U, 21364576U,
+    21364576U, 21364576U, 21364576U, 21364576U,
+    21364576U, 21364576U, 21364576U, 21364576U,
+    21364576U, 21364576U, 21364576U, 21364576U,
+    21364576U, 21364576U, 21561184U, 21561184U,
+    21561184U, 21561184U, 21561184U, 21561184U,
+    21561184U, 21561184U, 21561184U, 21561184U,
+    21561184U, 21561184U, 21561184U, 21561184U,
+    21561184U, 21561184U, 21561184U, 21561184U,
+    21561184U, 21561184U, 21561184U, 21561184U,
+    21757856U, 21757856U, 21757856U, 21757856U,
+    21757856U, 21757856U, 21757856U, 21757856U,
+    21757856U, 21757856U, 21757856U, 21757856U,
+    21757856U, 21757856U, 21757856U, 21757856U,
+    21757856U, 21757856U, 21757856U, 21757856U,
+    21757856U, 21757856U, 21757856U, 21953824U,
+    21953824U, 21953824U, 21953824U, 21953824U,
+    21953824U, 21953824U, 21953824U, 21953824U,
+    21953824U, 21953824U, 21953824U, 21953824U,
+    21953824U, 21953824U, 21953824U, 21953824U,
+    21953824U, 21953824U, 21953824U, 21953824U,
+    21953824U, 21953824U, 22151072U, 22151072U,
+    22151072U, 22151072U, 22151072U, 22151072U,
+    22151072U, 22151072U, 22151072U, 22151072U,
+    22151072U, 22151072U, 22151072U, 22151072U,
+    22151072U, 22151072U, 22151072U, 22151072U,
+    22151072U, 22151072U, 22151072U, 22151072U,
+    22151072U, 22347488U, 22347488U, 22347488U,
+    22347488U, 22347488U, 22347488U, 22347488U,
+    22347488U, 22347488U, 22347488U, 22347488U,
+    22347488U, 22347488U, 22347488U, 22347488U,
+    22347488U, 22347488U, 22347488U, 22347488U,
+    22347488U, 22347488U, 22347488U, 22347488U,
+    22347488U, 22544224U, 22544224U, 22544224U,
+    22544224U, 22544224U, 22544224U, 22544224U,
+    22544224U, 22544224U, 22544224U, 22544224U,
+    22544224U, 22544224U, 22544224U, 22544224U,
+    22544224U, 22544224U, 22544224U, 22544224U,
+    22544224U, 22544224U, 22544224U, 22544224U,
+    22544224U, 22740512U, 22740512U, 22740512U,
+    22740512U, 22740512U, 22740512U, 22740512U,
+    22740512U, 22740512U, 22740512U, 22740512U,
+    22740512U, 22740512U, 22740512U, 22740512U,
+    22740512U, 22740512U, 22740512U, 22740512U,
+    22740512U, 22740512U, 22740512U, 22740512U,
+    22740512U, 22937248U, 22937248U, 22937248U,
+    22937248U, 22937248U, 22937248U, 22937248U,
+    22937248U, 22937248U, 22937248U, 22937248U,
+    22937248U, 22937248U, 22937248U, 22937248U,
+    22937248U, 22937248U, 22937248U, 22937248U,
+    22937248U, 22937248U, 22937248U, 22937248U,
+    22937248U, 22937248U, 23133856U, 23133856U,
+    23133856U, 23133856U, 23133856U, 23133856U,
+    23133856U, 23133856U, 23133856U, 23133856U,
+    23133856U, 23133856U, 23133856U, 23133856U,
+    23133856U, 23133856U, 23133856U, 23133856U,
+    23133856U, 23133856U, 23133856U, 23133856U,
+    23133856U, 23133856U, 23133856U, 23330336U,
+    23330336U, 23330336U, 23330336U, 23330336U,
+    23330336U, 23330336U, 23330336U, 23330336U,
+    23330336U, 23330336U, 23330336U, 23330336U,
+    23330336U, 23330336U, 23330336U, 23330336U,
+    23330336U, 23330336U, 23330336U, 23330336U,
+    23330336U, 23330336U, 23330336U, 23330336U,
+    23526752U, 23526752U, 23526752U, 23526752U,
+    23526752U, 23526752U, 23526752U, 23526752U,
+    23526752U, 23526752U, 23526752U, 23526752U,
+    23526752U, 23526752U, 23526752U, 23526752U,
+    23526752U, 23526752U, 23526752U, 23526752U,
+    23526752U, 23526752U, 23526752U, 23526752U,
+    23526752U, 23526752U, 23723936U, 23723936U,
+    23723936U, 23723936U, 23723936U, 23723936U,
+    23723936U, 23723936U, 23723936U, 23723936U,
+    23723936U, 23723936U, 23723936U, 23723936U,
+    23723936U, 23723936U, 23723936U, 23723936U,
+    23723936U, 23723936U, 23723936U, 23723936U,
+    23723936U, 23723936U, 23723936U, 23723936U,
+    23919968U, 23919968U, 23919968U, 23919968U,
+    23919968U, 23919968U, 23919968U, 23919968U,
+    23919968U, 23919968U, 23919968U, 23919968U,
+    23919968U, 23919968U, 23919968U, 23919968U,
+    23919968U, 23919968U, 23919968U, 23919968U,
+    23919968U, 23919968U, 23919968U, 23919968U,
+    23919968U, 23919968U, 24117088U, 24117088U,
+    24117088U, 24117088U, 24117088U, 24117088U,
+    24117088U, 24117088U, 24117088U, 24117088U,
+    24117088U, 24117088U, 24117088U, 24117088U,
+    24117088U, 24117088U, 24117088U, 24117088U,
+    24117088U, 24117088U, 24117088U, 24117088U,
+    24117088U, 24117088U, 24117088U, 24117088U,
+    24117088U, 24313568U, 24313568U, 24313568U,
+    24313568U, 24313568U, 24313568U, 24313568U,
+    24313568U, 24313568U, 24313568U, 24313568U,
+    24313568U, 24313568U, 24313568U, 24313568U,
+    24313568U, 24313568U, 24313568U, 24313568U,
+    24313568U, 24313568U, 24313568U, 24313568U,
+    24313568U, 24313568U, 24313568U, 24313568U,
+    24510368U, 24510368U, 24510368U, 24510368U,
+    24510368U, 24510368U, 24510368U, 24510368U,
+    24510368U, 24510368U, 24510368U, 24510368U,
+    24510368U, 24510368U, 24510368U, 24510368U,
+    24510368U, 24510368U, 24510368U, 24510368U,
+    24510368U, 24510368U, 24510368U, 24510368U,
+    24510368U, 24510368U, 24510368U, 24706912U,
+    24706912U, 24706912U, 24706912U, 24706912U,
+    24706912U, 24706912U, 24706912U, 24706912U,
+    24706912U, 24706912U, 24706912U, 24706912U,
+    24706912U, 24706912U, 24706912U, 24706912U,
+    24706912U, 24706912U, 24706912U, 24706912U,
+    24706912U, 24706912U, 24706912U, 24706912U,
+    24706912U, 24706912U, 24706912U, 24903584U,
+    24903584U, 24903584U, 24903584U, 24903584U,
+    24903584U, 24903584U, 24903584U, 24903584U,
+    24903584U, 24903584U, 24903584U, 24903584U,
+    24903584U, 24903584U, 24903584U, 24903584U,
+    24903584U, 24903584U, 24903584U, 24903584U,
+    24903584U, 24903584U, 24903584U, 24903584U,
+    24903584U, 24903584U, 24903584U, 25100128U,
+    25100128U, 25100128U, 25100128U, 25100128U,
+    25100128U, 25100128U, 25100128U, 25100128U,
+    25100128U, 25100128U, 25100128U, 25100128U,
+    25100128U, 25100128U, 25100128U, 25100128U,
+    25100128U, 25100128U, 25100128U, 25100128U,
+    25100128U, 25100128U, 25100128U, 25100128U,
+    25100128U, 25100128U, 25100128U, 25296736U,
+    25296736U, 25296736U, 25296736U, 25296736U,
+    25296736U, 25296736U, 25296736U, 25296736U,
+    25296736U, 25296736U, 25296736U, 25296736U,
+    25296736U, 25296736U, 25296736U, 25296736U,
+    25296736U, 25296736U, 25296736U, 25296736U,
+    25296736U, 25296736U, 25296736U, 25296736U,
+    25296736U, 25296736U, 25296736U, 25296736U,
+    25493024U, 25493024U, 25493024U, 25493024U,
+    25493024U, 25493024U, 25493024U, 25493024U,
+    25493024U, 25493024U, 25493024U, 25493024U,
+    25493024U, 25493024U, 25493024U, 25493024U,
+    25493024U, 25493024U, 25493024U, 25493024U,
+    25493024U, 25493024U, 25493024U, 25493024U,
+    25493024U, 25493024U, 25493024U, 25493024U,
+    25493024U, 25689952U, 25689952U, 25689952U,
+    25689952U, 25689952U, 25689952U, 25689952U,
+    25689952U, 25689952U, 25689952U, 25689952U,
+    25689952U, 25689952U, 25689952U, 25689952U,
+    25689952U, 25689952U, 25689952U, 25689952U,
+    25689952U, 25689952U, 25689952U, 25689952U,
+    25689952U, 25689952U, 25689952U, 25689952U,
+    25689952U, 25689952U, 25886624U, 25886624U,
+    25886624U, 25886624U, 25886624U, 25886624U,
+    25886624U, 25886624U, 25886624U, 25886624U,
+    25886624U, 25886624U, 25886624U, 25886624U,
+    25886624U, 25886624U, 25886624U, 25886624U,
+    25886624U, 25886624U, 25886624U, 25886624U,
+    25886624U, 25886624U, 25886624U, 25886624U,
+    25886624U, 25886624U, 25886624U, 25886624U,
+    26082016U, 26082016U, 26082016U, 26082016U,
+    26082016U, 26082016U, 26082016U, 26082016U,
+    26082016U, 26082016U, 26082016U, 26082016U,
+    26082016U, 26082016U, 26082016U, 26082016U,
+    26082016U, 26082016U, 26082016U, 26082016U,
+    26082016U, 26082016U, 26082016U, 26082016U,
+    26082016U, 26082016U, 26082016U, 26082016U,
+    26082016U, 26082016U, 26278688U, 26278688U,
+    26278688U, 26278688U, 26278688U, 26278688U,
+    26278688U, 26278688U, 26278688U, 26278688U,
+    26278688U, 26278688U, 26278688U, 26278688U,
+    26278688U, 26278688U, 26278688U, 26278688U,
+    26278688U, 26278688U, 26278688U, 26278688U,
+    26278688U, 26278688U, 26278688U, 26278688U,
+    26278688U, 26278688U, 26278688U, 26278688U,
+    26476448U, 26476448U, 26476448U, 26476448U,
+    26476448U, 26476448U, 26476448U, 26476448U,
+    26476448U, 26476448U, 26476448U, 26476448U,
+    26476448U, 26476448U, 26476448U, 26476448U,
+    26476448U, 26476448U, 26476448U, 26476448U,
+    26476448U, 26476448U, 26476448U, 26476448U,
+    26476448U, 26476448U, 26476448U, 26476448U,
+    26476448U, 26476448U, 26476448U, 26672288U,
+    26672288U, 26672288U, 26672288U, 26672288U,
+    26672288U, 26672288U, 26672288U, 26672288U,
+    26672288U, 26672288U, 26672288U, 26672288U,
+    26672288U, 26672288U, 26672288U, 26672288U,
+    26672288U, 26672288U, 26672288U, 26672288U,
+    26672288U, 26672288U, 26672288U, 26672288U,
+    26672288U, 26672288U, 26672288U, 26672288U,
+    26672288U, 26672288U, 26869408U, 26869408U,
+    26869408U, 26869408U, 26869408U, 26869408U,
+    26869408U, 26869408U, 26869408U, 26869408U,
+    26869408U, 26869408U, 26869408U, 26869408U,
+    26869408U, 26869408U, 26869408U, 26869408U,
+    26869408U, 26869408U, 26869408U, 26869408U,
+    26869408U, 26869408U, 26869408U, 26869408U,
+    26869408U, 26869408U, 26869408U, 26869408U,
+    26869408U, 27065888U, 27065888U, 27065888U,
+    27065888U, 27065888U, 27065888U, 27065888U,
+    27065888U, 27065888U, 27065888U, 27065888U,
+    27065888U, 27065888U, 27065888U, 27065888U,
+    27065888U, 27065888U, 27065888U, 27065888U,
+    27065888U, 27065888U, 27065888U, 27065888U,
+    27065888U, 27065888U, 27065888U, 27065888U,
+    27065888U, 27065888U, 27065888U, 27065888U,
+    27065888U, 27262624U, 27262624U, 27262624U,
+    27262624U, 27262624U, 27262624U, 27262624U,
+    27262624U, 27262624U, 27262624U, 27262624U,
+    27262624U, 27262624U, 27262624U, 27262624U,
+    27262624U, 27262624U, 27262624U, 27262624U,
+    27262624U, 27262624U, 27262624U, 27262624U,
+    27262624U, 27262624U, 27262624U, 27262624U,
+    27262624U, 27262624U, 27262624U, 27262624U,
+    27262624U, 27459296U, 27459296U, 27459296U,
+    27459296U, 27459296U, 27459296U, 27459296U,
+    27459296U, 27459296U, 27459296U, 27459296U,
+    27459296U, 27459296U, 27459296U, 27459296U,
+    27459296U, 27459296U, 27459296U, 27459296U,
+    27459296U, 27459296U, 27459296U, 27459296U,
+    27459296U, 27459296U, 27459296U, 27459296U,
+    27459296U, 27459296U, 27459296U, 27459296U,
+    27459296U, 27656032U, 27656032U, 27656032U,
+    27656032U, 27656032U, 27656032U, 27656032U,
+    27656032U, 27656032U, 27656032U, 27656032U,
+    27656032U, 27656032U, 27656032U, 27656032U,
+    27656032U, 27656032U, 27656032U, 27656032U,
+    27656032U, 27656032U, 27656032U, 27656032U,
+    27656032U, 27656032U, 27656032U, 27656032U,
+    27656032U, 27656032U, 27656032U, 27656032U,
+    27656032U, 27656032U, 27852512U, 27852512U,
+    27852512U, 27852512U, 27852512U, 27852512U,
+    27852512U, 27852512U, 27852512U, 27852512U,
+    27852512U, 27852512U, 27852512U, 27852512U,
+    27852512U, 27852512U, 27852512U, 27852512U,
+    27852512U, 27852512U, 27852512U, 27852512U,
+    27852512U, 27852512U, 27852512U, 27852512U,
+    27852512U, 27852512U, 27852512U, 27852512U,
+    27852512U, 27852512U, 27852512U, 28048928U,
+    28048928U, 28048928U, 28048928U, 28048928U,
+    28048928U, 28048928U, 28048928U, 28048928U,
+    28048928U, 28048928U, 28048928U, 28048928U,
+    28048928U, 28048928U, 28048928U, 28048928U,
+    28048928U, 28048928U, 28048928U, 28048928U,
+    28048928U, 28048928U, 28048928U, 28048928U,
+    28048928U, 28048928U, 28048928U, 28048928U,
+    28048928U, 28048928U, 28048928U, 28048928U,
+    28245088U, 28245088U, 28245088U, 28245088U,
+    28245088U, 28245088U, 28245088U, 28245088U,
+    28245088U, 28245088U, 28245088U, 28245088U,
+    28245088U, 28245088U, 28245088U, 28245088U,
+    28245088U, 28245088U, 28245088U, 28245088U,
+    28245088U, 28245088U, 28245088U, 28245088U,
+    28245088U, 28245088U, 28245088U, 28245088U,
+    28245088U, 28245088U, 28245088U, 28245088U,
+    28245088U, 28245088U, 28442464U, 28442464U,
+    28442464U, 28442464U, 28442464U, 28442464U,
+    28442464U, 28442464U, 28442464U, 28442464U,
+    28442464U, 28442464U, 28442464U, 28442464U,
+    28442464U, 28442464U, 28442464U, 28442464U,
+    28442464U, 28442464U, 28442464U, 28442464U,
+    28442464U, 28442464U, 28442464U, 28442464U,
+    28442464U, 28442464U, 28442464U, 28442464U,
+    28442464U, 28442464U, 28442464U, 28442464U,
+    28639136U, 28639136U, 28639136U, 28639136U,
+    28639136U, 28639136U, 28639136U, 28639136U,
+    28639136U, 28639136U, 28639136U, 28639136U,
+    28639136U, 28639136U, 28639136U, 28639136U,
+    28639136U, 28639136U, 28639136U, 28639136U,
+    28639136U, 28639136U, 28639136U, 28639136U,
+    28639136U, 28639136U, 28639136U, 28639136U,
+    28639136U, 28639136U, 28639136U, 28639136U,
+    28639136U, 28639136U, 28835552U, 28835552U,
+    28835552U, 28835552U, 28835552U, 28835552U,
+    28835552U, 28835552U, 28835552U, 28835552U,
+    28835552U, 28835552U, 28835552U, 28835552U,
+    28835552U, 28835552U, 28835552U, 28835552U,
+    28835552U, 28835552U, 28835552U, 28835552U,
+    28835552U, 28835552U, 28835552U, 28835552U,
+    28835552U, 28835552U, 28835552U, 28835552U,
+    28835552U, 28835552U, 28835552U, 28835552U,
+    28835552U, 29032288U, 29032288U, 29032288U,
+    29032288U, 29032288U, 29032288U, 29032288U,
+    29032288U, 29032288U, 29032288U, 29032288U,
+    29032288U, 29032288U, 29032288U, 29032288U,
+    29032288U, 29032288U, 29032288U, 29032288U,
+    29032288U, 29032288U, 29032288U, 29032288U,
+    29032288U, 29032288U, 29032288U, 29032288U,
+    29032288U, 29032288U, 29032288U, 29032288U,
+    29032288U, 29032288U, 29032288U, 29032288U,
+    29228704U, 29228704U, 29228704U, 29228704U,
+    29228704U, 29228704U, 29228704U, 29228704U,
+    29228704U, 29228704U, 29228704U, 29228704U,
+    29228704U, 29228704U, 29228704U, 29228704U,
+    29228704U, 29228704U, 29228704U, 29228704U,
+    29228704U, 29228704U, 29228704U, 29228704U,
+    29228704U, 29228704U, 29228704U, 29228704U,
+    29228704U, 29228704U, 29228704U, 29228704U,
+    29228704U, 29228704U, 29228704U, 29424992U,
+    29424992U, 29424992U, 29424992U, 29424992U,
+    29424992U, 29424992U, 29424992U, 29424992U,
+    29424992U, 29424992U, 29424992U, 29424992U,
+    29424992U, 29424992U, 29424992U, 29424992U,
+    29424992U, 29424992U, 29424992U, 29424992U,
+    29424992U, 29424992U, 29424992U, 29424992U,
+    29424992U, 29424992U, 29424992U, 29424992U,
+    29424992U, 29424992U, 29424992U, 29424992U,
+    29424992U, 29424992U, 29424992U, 29621728U,
+    29621728U, 29621728U, 29621728U, 29621728U,
+    29621728U, 29621728U, 29621728U, 29621728U,
+    29621728U, 29621728U, 29621728U, 29621728U,
+    29621728U, 29621728U, 29621728U, 29621728U,
+    29621728U, 29621728U, 29621728U, 29621728U,
+    29621728U, 29621728U, 29621728U, 29621728U,
+    29621728U, 29621728U, 29621728U, 29621728U,
+    29621728U, 29621728U, 29621728U, 29621728U,
+    29621728U, 29621728U, 29621728U, 29818784U,
+    29818784U, 29818784U, 29818784U, 29818784U,
+    29818784U, 29818784U, 29818784U, 29818784U,
+    29818784U, 29818784U, 29818784U, 29818784U,
+    29818784U, 29818784U, 29818784U, 29818784U,
+    29818784U, 29818784U, 29818784U, 29818784U,
+    29818784U, 29818784U, 29818784U, 29818784U,
+    29818784U, 29818784U, 29818784U, 29818784U,
+    29818784U, 29818784U, 29818784U, 29818784U,
+    29818784U, 29818784U, 29818784U, 30015008U,
+    30015008U, 30015008U, 30015008U, 30015008U,
+    30015008U, 30015008U, 30015008U, 30015008U,
+    30015008U, 30015008U, 30015008U, 30015008U,
+    30015008U, 30015008U, 30015008U, 30015008U,
+    30015008U, 30015008U, 30015008U, 30015008U,
+    30015008U, 30015008U, 30015008U, 30015008U,
+    30015008U, 30015008U, 30015008U, 30015008U,
+    30015008U, 30015008U, 30015008U, 30015008U,
+    30015008U, 30015008U, 30015008U, 30015008U,
+    30211936U, 30211936U, 30211936U, 30211936U,
+    30211936U, 30211936U, 30211936U, 30211936U,
+    30211936U, 30211936U, 30211936U, 30211936U
+};
+
+static const uint64_t dag_graph_sizes[DAG_SIZES_EPOCHS] = {
+    536869952U, 562035008U, 574616384U, 587202368U,
+    599784256U, 599784256U, 612366016U, 612366016U,
+    624951232U, 624951232U, 637533632U, 637533632U,
+    637533632U, 650117056U, 650117056U, 650117056U,
+    662698688U, 662698688U, 662698688U, 675280832U,
+    675280832U, 675280832U, 675280832U, 687865792U,
+    687865792U, 687865792U, 687865792U, 700448704U,
+    700448704U, 700448704U, 700448704U, 713031232U,
+    713031232U, 713031232U, 713031232U, 713031232U,
+    725614528U, 725614528U, 725614528U, 725614528U,
+    725614528U, 738197056U, 738197056U, 738197056U,
+    738197056U, 738197056U, 750779584U, 750779584U,
+    750779584U, 750779584U, 750779584U, 750779584U,
+    763363264U, 763363264U, 763363264U, 763363264U,
+    763363264U, 763363264U, 775946048U, 775946048U,
+    775946048U, 775946048U, 775946048U, 775946048U,
+    788528192U, 788528192U, 788528192U, 788528192U,
+    788528192U, 788528192U, 788528192U, 801109696U,
+    801109696U, 801109696U, 801109696U, 801109696U,
+    801109696U, 801109696U, 813693376U, 813693376U,
+    813693376U, 813693376U, 813693376U, 813693376U,
+    813693376U, 826277824U, 826277824U, 826277824U,
+    826277824U, 826277824U, 826277824U, 826277824U,
+    826277824U, 838860608U, 838860608U, 838860608U,
+    838860608U, 838860608U, 838860608U, 838860608U,
+    838860608U, 851443136U, 851443136U, 851443136U,
+    851443136U, 851443136U, 851443136U, 851443136U,
+    851443136U, 864023872U, 864023872U, 864023872U,
+    864023872U, 864023872U, 864023872U, 864023872U,
+    864023872U, 864023872U, 876609472U, 876609472U,
+    876609472U, 876609472U, 876609472U, 876609472U,
+    876609472U, 876609472U, 876609472U, 889191232U,
+    889191232U, 889191232U, 889191232U, 889191232U,
+    889191232U, 889191232U, 889191232U, 889191232U,
+    901775296U, 901775296U, 901775296U, 901775296U,
+    901775296U, 901775296U, 901775296U, 901775296U,
+    901775296U, 901775296U, 914355776U, 914355776U,
+    914355776U, 914355776U, 914355776U, 914355776U,
+    914355776U, 914355776U, 914355776U, 914355776U,
+    926939968U, 926939968U, 926939968U, 926939968U,
+    926939968U, 926939968U, 926939968U, 926939968U,
+    926939968U, 926939968U, 939524032U, 939524032U,
+    939524032U, 939524032U, 939524032U, 939524032U,
+    939524032U, 939524032U, 939524032U, 939524032U,
+    939524032U, 952106048U, 952106048U, 952106048U,
+    952106048U, 952106048U, 952106048U, 952106048U,
+    952106048U, 952106048U, 952106048U, 952106048U,
+    964689728U, 964689728U, 964689728U, 964689728U,
+    964689728U, 964689728U, 964689728U, 964689728U,
+    964689728U, 964689728U, 964689728U, 977271616U,
+    977271616U, 977271616U, 977271616U, 977271616U,
+    977271616U, 977271616U, 977271616U, 977271616U,
+    977271616U, 977271616U, 977271616U, 989853632U,
+    989853632U, 989853632U, 989853632U, 989853632U,
+    989853632U, 989853632U, 989853632U, 989853632U,
+    989853632U, 989853632U, 989853632U, 1002437312U,
+    1002437312U, 1002437312U, 1002437312U, 1002437312U,
+    1002437312U, 1002437312U, 1002437312U, 1002437312U,
+    1002437312U, 1002437312U, 1002437312U, 1015019968U,
+    1015019968U, 1015019968U, 1015019968U, 1015019968U,
+    1015019968U, 1015019968U, 1015019968U, 1015019968U,
+    1015019968U, 1015019968U, 1015019968U, 1015019968U,
+    1027604288U, 1027604288U, 1027604288U, 1027604288U,
+    1027604288U, 1027604288U, 1027604288U, 1027604288U,
+    1027604288U, 1027604288U, 1027604288U, 1027604288U,
+    1027604288U, 1040186816U, 1040186816U, 1040186816U,
+    1040186816U, 1040186816U, 1040186816U, 1040186816U,
+    1040186816U, 1040186816U, 1040186816U, 1040186816U,
+    1040186816U, 1040186816U, 1052769856U, 1052769856U,
+    1052769856U, 1052769856U, 1052769856U, 1052769856U,
+    1052769856U, 1052769856U, 1052769856U, 1052769856U,
+    1052769856U, 1052769856U, 1052769856U, 1052769856U,
+    1065350336U, 1065350336U, 1065350336U, 1065350336U,
+    1065350336U, 1065350336U, 1065350336U, 1065350336U,
+    1065350336U, 1065350336U, 1065350336U, 1065350336U,
+    1065350336U, 1065350336U, 1077936064U, 1077936064U,
+    1077936064U, 1077936064U, 1077936064U, 1077936064U,
+    1077936064U, 1077936064U, 1077936064U, 1077936064U,
+    1077936064U, 1077936064U, 1077936064U, 1077936064U,
+    1090517696U, 1090517696U, 1090517696U, 1090517696U,
+    1090517696U, 1090517696U, 1090517696U, 1090517696U,
+    1090517696U, 1090517696U, 1090517696U, 1090517696U,
+    1090517696U, 1090517696U, 1090517696U, 1103101504U,
+    1103101504U, 1103101504U, 1103101504U, 1103101504U,
+    1103101504U, 1103101504U, 1103101504U, 1103101504U,
+    1103101504U, 1103101504U, 1103101504U, 1103101504U,
+    1103101504U, 1103101504U, 1115683904U, 1115683904U,
+    1115683904U, 1115683904U, 1115683904U, 1115683904U,
+    1115683904U, 1115683904U, 1115683904U, 1115683904U,
+    1115683904U, 1115683904U, 1115683904U, 1115683904U,
+    1115683904U, 1128263872U, 1128263872U, 1128263872U,
+    1128263872U, 1128263872U, 1128263872U, 1128263872U,
+    1128263872U, 1128263872U, 1128263872U, 1128263872U,
+    1128263872U, 1128263872U, 1128263872U, 1128263872U,
+    1128263872U, 1140850624U, 1140850624U, 1140850624U,
+    1140850624U, 1140850624U, 1140850624U, 1140850624U,
+    1140850624U, 1140850624U, 1140850624U, 1140850624U,
+    1140850624U, 1140850624U, 1140850624U, 1140850624U,
+    1140850624U, 1153433536U, 1153433536U, 1153433536U,
+    1153433536U, 1153433536U, 1153433536U, 1153433536U,
+    1153433536U, 1153433536U, 1153433536U, 1153433536U,
+    1153433536U, 1153433536U, 1153433536U, 1153433536U,
+    1153433536U, 1166016064U, 1166016064U, 1166016064U,
+    1166016064U, 1166016064U, 1166016064U, 1166016064U,
+    1166016064U, 1166016064U, 1166016064U, 1166016064U,
+    1166016064U, 1166016064U, 1166016064U, 1166016064U,
+    1166016064U, 1166016064U, 1178598208U, 1178598208U,
+    1178598208U, 1178598208U, 1178598208U, 1178598208U,
+    1178598208U, 1178598208U, 1178598208U, 1178598208U,
+    1178598208U, 1178598208U, 1178598208U, 1178598208U,
+    1178598208U, 1178598208U, 1178598208U, 1191181504U,
+    1191181504U, 1191181504U, 1191181504U, 1191181504U,
+    1191181504U, 1191181504U, 1191181504U, 1191181504U,
+    1191181504U, 1191181504U, 1191181504U, 1191181504U,
+    1191181504U, 1191181504U, 1191181504U, 1191181504U,
+    1203765184U, 1203765184U, 1203765184U, 1203765184U,
+    1203765184U, 1203765184U, 1203765184U, 1203765184U,
+    1203765184U, 1203765184U, 1203765184U, 1203765184U,
+    1203765184U, 1203765184U, 1203765184U, 1203765184U,
+    1203765184U, 1203765184U, 1216347712U, 1216347712U,
+    1216347712U, 1216347712U, 1216347712U, 1216347712U,
+    1216347712U, 1216347712U, 1216347712U, 1216347712U,
+    1216347712U, 1216347712U, 1216347712U, 1216347712U,
+    1216347712U, 1216347712U, 1216347712U, 1216347712U,
+    1228930624U, 1228930624U, 1228930624U, 1228930624U,
+    1228930624U, 1228930624U, 1228930624U, 1228930624U,
+    1228930624U, 1228930624U, 1228930624U, 1228930624U,
+    1228930624U, 1228930624U, 1228930624U, 1228930624U,
+    1228930624U, 1228930624U, 1241513408U, 1241513408U,
+    1241513408U, 1241513408U, 1241513408U, 1241513408U,
+    1241513408U, 1241513408U, 1241513408U, 1241513408U,
+    1241513408U, 1241513408U, 1241513408U, 1241513408U,
+    1241513408U, 1241513408U, 1241513408U, 1241513408U,
+    1241513408U, 1254095936U, 1254095936U, 1254095936U,
+    1254095936U, 1254095936U, 1254095936U, 1254095936U,
+    1254095936U, 1254095936U, 1254095936U, 1254095936U,
+    1254095936U, 1254095936U, 1254095936U, 1254095936U,
+    1254095936U, 1254095936U, 1254095936U, 1254095936U,
+    1266679616U, 1266679616U, 1266679616U, 1266679616U,
+    1266679616U, 1266679616U, 1266679616U, 1266679616U,
+    1266679616U, 1266679616U, 1266679616U, 1266679616U,
+    1266679616U, 1266679616U, 1266679616U, 1266679616U,
+    1266679616U, 1266679616U, 1266679616U, 1279262528U,
+    1279262528U, 1279262528U, 1279262528U, 1279262528U,
+    1279262528U, 1279262528U, 1279262528U, 1279262528U,
+    1279262528U, 1279262528U, 1279262528U, 1279262528U,
+    1279262528U, 1279262528U, 1279262528U, 1279262528U,
+    1279262528U, 1279262528U, 1279262528U, 1291843264U,
+    1291843264U, 1291843264U, 1291843264U, 1291843264U,
+    1291843264U, 1291843264U, 1291843264U, 1291843264U,
+    1291843264U, 1291843264U, 1291843264U, 1291843264U,
+    1291843264U, 1291843264U, 1291843264U, 1291843264U,
+    1291843264U, 1291843264U, 1291843264U, 1304428096U,
+    1304428096U, 1304428096U, 1304428096U, 1304428096U,
+    1304428096U, 1304428096U, 1304428096U, 1304428096U,
+    1304428096U, 1304428096U, 1304428096U, 1304428096U,
+    1304428096U, 1304428096U, 1304428096U, 1304428096U,
+    1304428096U, 1304428096U, 1304428096U, 1317011008U,
+    1317011008U, 1317011008U, 1317011008U, 1317011008U,
+    1317011008U, 1317011008U, 1317011008U, 1317011008U,
+    1317011008U, 1317011008U, 1317011008U, 1317011008U,
+    1317011008U, 1317011008U, 1317011008U, 1317011008U,
+    1317011008U, 1317011008U, 1317011008U, 1317011008U,
+    1329594176U, 1329594176U, 1329594176U, 1329594176U,
+    1329594176U, 1329594176U, 1329594176U, 1329594176U,
+    1329594176U, 1329594176U, 1329594176U, 1329594176U,
+    1329594176U, 1329594176U, 1329594176U, 1329594176U,
+    1329594176U, 1329594176U, 1329594176U, 1329594176U,
+    1329594176U, 1342176448U, 1342176448U, 1342176448U,
+    1342176448U, 1342176448U, 1342176448U, 1342176448U,
+    1342176448U, 1342176448U, 1342176448U, 1342176448U,
+    1342176448U, 1342176448U, 1342176448U, 1342176448U,
+    1342176448U, 1342176448U, 1342176448U, 1342176448U,
+    1342176448U, 1342176448U, 1354759232U, 1354759232U,
+    1354759232U, 1354759232U, 1354759232U, 1354759232U,
+    1354759232U, 1354759232U, 1354759232U, 1354759232U,
+    1354759232U, 1354759232U, 1354759232U, 1354759232U,
+    1354759232U, 1354759232U, 1354759232U, 1354759232U,
+    1354759232U, 1354759232U, 1354759232U, 1354759232U,
+    1367342528U, 1367342528U, 1367342528U, 1367342528U,
+    1367342528U, 1367342528U, 1367342528U, 1367342528U,
+    1367342528U, 1367342528U, 1367342528U, 1367342528U,
+    1367342528U, 1367342528U, 1367342528U, 1367342528U,
+    1367342528U, 1367342528U, 1367342528U, 1367342528U,
+    1367342528U, 1367342528U, 1379925824U, 1379925824U,
+    1379925824U, 1379925824U, 1379925824U, 1379925824U,
+    1379925824U, 1379925824U, 1379925824U, 1379925824U,
+    1379925824U, 1379925824U, 1379925824U, 1379925824U,
+    1379925824U, 1379925824U, 1379925824U, 1379925824U,
+    1379925824U, 1379925824U, 1379925824U, 1379925824U,
+    1392508864U, 1392508864U, 1392508864U, 1392508864U,
+    1392508864U, 1392508864U, 1392508864U, 1392508864U,
+    1392508864U, 1392508864U, 1392508864U, 1392508864U,
+    1392508864U, 1392508864U, 1392508864U, 1392508864U,
+    1392508864U, 1392508864U, 1392508864U, 1392508864U,
+    1392508864U, 1392508864U, 1392508864U, 1405091008U,
+    1405091008U, 1405091008U, 1405091008U, 1405091008U,
+    1405091008U, 1405091008U, 1405091008U, 1405091008U,
+    1405091008U, 1405091008U, 1405091008U, 1405091008U,
+    1405091008U, 1405091008U, 1405091008U, 1405091008U,
+    1405091008U, 1405091008U, 1405091008U, 1405091008U,
+    1405091008U, 1405091008U, 1417674688U, 1417674688U,
+    1417674688U, 1417674688U, 1417674688U, 1417674688U,
+    1417674688U, 1417674688U, 1417674688U, 1417674688U,
+    1417674688U, 1417674688U, 1417674688U, 1417674688U,
+    1417674688U, 1417674688U, 1417674688U, 1417674688U,
+    1417674688U, 1417674688U, 1417674688U, 1417674688U,
+    1417674688U, 1430257216U, 1430257216U, 1430257216U,
+    1430257216U, 1430257216U, 1430257216U, 1430257216U,
+    1430257216U, 1430257216U, 1430257216U, 1430257216U,
+    1430257216U, 1430257216U, 1430257216U, 1430257216U,
+    1430257216U, 1430257216U, 1430257216U, 1430257216U,
+    1430257216U, 1430257216U, 1430257216U, 1430257216U,
+    1430257216U, 1442838464U, 1442838464U, 1442838464U,
+    1442838464U, 1442838464U, 1442838464U, 1442838464U,
+    1442838464U, 1442838464U, 1442838464U, 1442838464U,
+    1442838464U, 1442838464U, 1442838464U, 1442838464U,
+    1442838464U, 1442838464U, 1442838464U, 1442838464U,
+    1442838464U, 1442838464U, 1442838464U, 1442838464U,
+    1442838464U, 1455421504U, 1455421504U, 1455421504U,
+    1455421504U, 1455421504U, 1455421504U, 1455421504U,
+    1455421504U, 1455421504U, 1455421504U, 1455421504U,
+    1455421504U, 1455421504U, 1455421504U, 1455421504U,
+    1455421504U, 1455421504U, 1455421504U, 1455421504U,
+    1455421504U, 1455421504U, 1455421504U, 1455421504U,
+    1455421504U, 1468005824U, 1468005824U, 1468005824U,
+    1468005824U, 1468005824U, 1468005824U, 1468005824U,
+    1468005824U, 1468005824U, 1468005824U, 1468005824U,
+    1468005824U, 1468005824U, 1468005824U, 1468005824U,
+    1468005824U, 1468005824U, 1468005824U, 1468005824U,
+    1468005824U, 1468005824U, 1468005824U, 1468005824U,
+    1468005824U, 1468005824U, 1480588864U, 1480588864U,
+    1480588864U, 1480588864U, 1480588864U, 1480588864U,
+    1480588864U, 1480588864U, 1480588864U, 1480588864U,
+    1480588864U, 1480588864U, 1480588864U, 1480588864U,
+    1480588864U, 1480588864U, 1480588864U, 1480588864U,
+    1480588864U, 1480588864U, 1480588864U, 1480588864U,
+    1480588864U, 1480588864U, 1480588864U, 1493169472U,
+    1493169472U, 1493169472U, 1493169472U, 1493169472U,
+    1493169472U, 1493169472U, 1493169472U, 1493169472U,
+    1493169472U, 1493169472U, 1493169472U, 1493169472U,
+    1493169472U, 1493169472U, 1493169472U, 1493169472U,
+    1493169472U, 1493169472U, 1493169472U, 1493169472U,
+    1493169472U, 1493169472U, 1493169472U, 1493169472U,
+    1505754176U, 1505754176U, 1505754176U, 1505754176U,
+    1505754176U, 1505754176U, 1505754176U, 1505754176U,
+    1505754176U, 1505754176U, 1505754176U, 1505754176U,
+    1505754176U, 1505754176U, 1505754176U, 1505754176U,
+    1505754176U, 1505754176U, 1505754176U, 1505754176U,
+    1505754176U, 1505754176U, 1505754176U, 1505754176U,
+    1505754176U, 1505754176U, 1518337984U, 1518337984U,
+    1518337984U, 1518337984U, 1518337984U, 1518337984U,
+    1518337984U, 1518337984U, 1518337984U, 1518337984U,
+    1518337984U, 1518337984U, 1518337984U, 1518337984U,
+    1518337984U, 1518337984U, 1518337984U, 1518337984U,
+    1518337984U, 1518337984U, 1518337984U, 1518337984U,
+    1518337984U, 1518337984U, 1518337984U, 1518337984U,
+    1530918848U, 1530918848U, 1530918848U, 1530918848U,
+    1530918848U, 1530918848U, 1530918848U, 1530918848U,
+    1530918848U, 1530918848U, 1530918848U, 1530918848U,
+    1530918848U, 1530918848U, 1530918848U, 1530918848U,
+    1530918848U, 1530918848U, 1530918848U, 1530918848U,
+    1530918848U, 1530918848U, 1530918848U, 1530918848U,
+    1530918848U, 1530918848U, 1543501888U, 1543501888U,
+    1543501888U, 1543501888U, 1543501888U, 1543501888U,
+    1543501888U, 1543501888U, 1543501888U, 1543501888U,
+    1543501888U, 1543501888U, 1543501888U, 1543501888U,
+    1543501888U, 1543501888U, 1543501888U, 1543501888U,
+    1543501888U, 1543501888U, 1543501888U, 1543501888U,
+    1543501888U, 1543501888U, 1543501888U, 1543501888U,
+    1543501888U, 1556086592U, 1556086592U, 1556086592U,
+    1556086592U, 1556086592U, 1556086592U, 1556086592U,
+    1556086592U, 1556086592U, 1556086592U, 1556086592U,
+    1556086592U, 1556086592U, 1556086592U, 1556086592U,
+    1556086592U, 1556086592U, 1556086592U, 1556086592U,
+    1556086592U, 1556086592U, 1556086592U, 1556086592U,
+    1556086592U, 1556086592U, 1556086592U, 1556086592U,
+    1568669632U, 1568669632U, 1568669632U, 1568669632U,
+    1568669632U, 1568669632U, 1568669632U, 1568669632U,
+    1568669632U, 1568669632U, 1568669632U, 1568669632U,
+    1568669632U, 1568669632U, 1568669632U, 1568669632U,
+    1568669632U, 1568669632U, 1568669632U, 1568669632U,
+    1568669632U, 1568669632U, 1568669632U, 1568669632U,
+    1568669632U, 1568669632U, 1568669632U, 1581252544U,
+    1581252544U, 1581252544U, 1581252544U, 1581252544U,
+    1581252544U, 1581252544U, 1581252544U, 1581252544U,
+    1581252544U, 1581252544U, 1581252544U, 1581252544U,
+    1581252544U, 1581252544U, 1581252544U, 1581252544U,
+    1581252544U, 1581252544U, 1581252544U, 1581252544U,
+    1581252544U, 1581252544U, 1581252544U, 1581252544U,
+    1581252544U, 1581252544U, 1581252544U, 1593834688U,
+    1593834688U, 1593834688U, 1593834688U, 1593834688U,
+    1593834688U, 1593834688U, 1593834688U, 1593834688U,
+    1593834688U, 1593834688U, 1593834688U, 1593834688U,
+    1593834688U, 1593834688U, 1593834688U, 1593834688U,
+    1593834688U, 1593834688U, 1593834688U, 1593834688U,
+    1593834688U, 1593834688U, 1593834688U, 1593834688U,
+    1593834688U, 1593834688U, 1593834688U, 1606418368U,
+    1606418368U, 1606418368U, 1606418368U, 1606418368U,
+    1606418368U, 1606418368U, 1606418368U, 1606418368U,
+    1606418368U, 1606418368U, 1606418368U, 1606418368U,
+    1606418368U, 1606418368U, 1606418368U, 1606418368U,
+    1606418368U, 1606418368U, 1606418368U, 1606418368U,
+    1606418368U, 1606418368U, 1606418368U, 1606418368U,
+    1606418368U, 1606418368U, 1606418368U, 1619001152U,
+    1619001152U, 1619001152U, 1619001152U, 1619001152U,
+    1619001152U, 1619001152U, 1619001152U, 1619001152U,
+    1619001152U, 1619001152U, 1619001152U, 1619001152U,
+    1619001152U, 1619001152U, 1619001152U, 1619001152U,
+    1619001152U, 1619001152U, 1619001152U, 1619001152U,
+    1619001152U, 1619001152U, 1619001152U, 1619001152U,
+    1619001152U, 1619001152U, 1619001152U, 1619001152U,
+    1631582912U, 1631582912U, 1631582912U, 1631582912U,
+    1631582912U, 1631582912U, 1631582912U, 1631582912U,
+    1631582912U, 1631582912U, 1631582912U, 1631582912U,
+    1631582912U, 1631582912U, 1631582912U, 1631582912U,
+    1631582912U, 1631582912U, 1631582912U, 1631582912U,
+    1631582912U, 1631582912U, 1631582912U, 1631582912U,
+    1631582912U, 1631582912U, 1631582912U, 1631582912U,
+    1631582912U, 1644166208U, 1644166208U, 1644166208U,
+    1644166208U, 1644166208U, 1644166208U, 1644166208U,
+    1644166208U, 1644166208U, 1644166208U, 1644166208U,
+    1644166208U, 1644166208U, 1644166208U, 1644166208U,
+    1644166208U, 1644166208U, 1644166208U, 1644166208U,
+    1644166208U, 1644166208U, 1644166208U, 1644166208U,
+    1644166208U, 1644166208U, 1644166208U, 1644166208U,
+    1644166208U, 1644166208U, 1656750016U, 1656750016U,
+    1656750016U, 1656750016U, 1656750016U, 1656750016U,
+    1656750016U, 1656750016U, 1656750016U, 1656750016U,
+    1656750016U, 1656750016U, 1656750016U, 1656750016U,
+    1656750016U, 1656750016U, 1656750016U, 1656750016U,
+    1656750016U, 1656750016U, 1656750016U, 1656750016U,
+    1656750016U, 1656750016U, 1656750016U, 1656750016U,
+    1656750016U, 1656750016U, 1656750016U, 1656750016U,
+    1669329472U, 1669329472U, 1669329472U, 1669329472U,
+    1669329472U, 1669329472U, 1669329472U, 1669329472U,
+    1669329472U, 1669329472U, 1669329472U, 1669329472U,
+    1669329472U, 1669329472U, 1669329472U, 1669329472U,
+    1669329472U, 1669329472U, 1669329472U, 1669329472U,
+    1669329472U, 1669329472U, 1669329472U, 1669329472U,
+    1669329472U, 1669329472U, 1669329472U, 1669329472U,
+    1669329472U, 1669329472U, 1681913536U, 1681913536U,
+    1681913536U, 1681913536U, 1681913536U, 1681913536U,
+    1681913536U, 1681913536U, 1681913536U, 1681913536U,
+    1681913536U, 1681913536U, 1681913536U, 1681913536U,
+    1681913536U, 1681913536U, 1681913536U, 1681913536U,
+    1681913536U, 1681913536U, 1681913536U, 1681913536U,
+    1681913536U, 1681913536U, 1681913536U, 1681913536U,
+    1681913536U, 1681913536U, 1681913536U, 1681913536U,
+    1694498752U, 1694498752U, 1694498752U, 1694498752U,
+    1694498752U, 1694498752U, 1694498752U, 1694498752U,
+    1694498752U, 1694498752U, 1694498752U, 1694498752U,
+    1694498752U, 1694498752U, 1694498752U, 1694498752U,
+    1694498752U, 1694498752U, 1694498752U, 1694498752U,
+    1694498752U, 1694498752U, 1694498752U, 1694498752U,
+    1694498752U, 1694498752U, 1694498752U, 1694498752U,
+    1694498752U, 1694498752U, 1694498752U, 1707081536U,
+    1707081536U, 1707081536U, 1707081536U, 1707081536U,
+    1707081536U, 1707081536U, 1707081536U, 1707081536U,
+    1707081536U, 1707081536U, 1707081536U, 1707081536U,
+    1707081536U, 1707081536U, 1707081536U, 1707081536U,
+    1707081536U, 1707081536U, 1707081536U, 1707081536U,
+    1707081536U, 1707081536U, 1707081536U, 1707081536U,
+    1707081536U, 1707081536U, 1707081536U, 1707081536U,
+    1707081536U, 1707081536U, 1719664192U, 1719664192U,
+    1719664192U, 1719664192U, 1719664192U, 1719664192U,
+    1719664192U, 1719664192U, 1719664192U, 1719664192U,
+    1719664192U, 1719664192U, 1719664192U, 1719664192U,
+    1719664192U, 1719664192U, 1719664192U, 1719664192U,
+    1719664192U, 1719664192U, 1719664192U, 1719664192U,
+    1719664192U, 1719664192U, 1719664192U, 1719664192U,
+    1719664192U, 1719664192U, 1719664192U, 1719664192U,
+    1719664192U, 1732246976U, 1732246976U, 1732246976U,
+    1732246976U, 1732246976U, 1732246976U, 1732246976U,
+    1732246976U, 1732246976U, 1732246976U, 1732246976U,
+    1732246976U, 1732246976U, 1732246976U, 1732246976U,
+    1732246976U, 1732246976U, 1732246976U, 1732246976U,
+    1732246976U, 1732246976U, 1732246976U, 1732246976U,
+    1732246976U, 1732246976U, 1732246976U, 1732246976U,
+    1732246976U, 1732246976U, 1732246976U, 1732246976U,
+    1732246976U, 1744827584U, 1744827584U, 1744827584U,
+    1744827584U, 1744827584U, 1744827584U, 1744827584U,
+    1744827584U, 1744827584U, 1744827584U, 1744827584U,
+    1744827584U, 1744827584U, 1744827584U, 1744827584U,
+    1744827584U, 1744827584U, 1744827584U, 1744827584U,
+    1744827584U, 1744827584U, 1744827584U, 1744827584U,
+    1744827584U, 1744827584U, 1744827584U, 1744827584U,
+    1744827584U, 1744827584U, 1744827584U, 1744827584U,
+    1744827584U, 1757413184U, 1757413184U, 1757413184U,
+    1757413184U, 1757413184U, 1757413184U, 1757413184U,
+    1757413184U, 1757413184U, 1757413184U, 1757413184U,
+    1757413184U, 1757413184U, 1757413184U, 1757413184U,
+    1757413184U, 1757413184U, 1757413184U, 1757413184U,
+    1757413184U, 1757413184U, 1757413184U, 1757413184U,
+    1757413184U, 1757413184U, 1757413184U, 1757413184U,
+    1757413184U, 1757413184U, 1757413184U, 1757413184U,
+    1757413184U, 1769993536U, 1769993536U, 1769993536U,
+    1769993536U, 1769993536U, 1769993536U, 1769993536U,
+    1769993536U, 1769993536U, 1769993536U, 1769993536U,
+    1769993536U, 1769993536U, 1769993536U, 1769993536U,
+    1769993536U, 1769993536U, 1769993536U, 1769993536U,
+    1769993536U, 1769993536U, 1769993536U, 1769993536U,
+    1769993536U, 1769993536U, 1769993536U, 1769993536U,
+    1769993536U, 1769993536U, 1769993536U, 1769993536U,
+    1769993536U, 1769993536U, 1782578624U, 1782578624U,
+    1782578624U, 1782578624U, 1782578624U, 1782578624U,
+    1782578624U, 1782578624U, 1782578624U, 1782578624U,
+    1782578624U, 1782578624U, 1782578624U, 1782578624U,
+    1782578624U, 1782578624U, 1782578624U, 1782578624U,
+    1782578624U, 1782578624U, 1782578624U, 1782578624U,
+    1782578624U, 1782578624U, 1782578624U, 1782578624U,
+    1782578624U, 1782578624U, 1782578624U, 1782578624U,
+    1782578624U, 1782578624U, 1782578624U, 1795162048U,
+    1795162048U, 1795162048U, 1795162048U, 1795162048U,
+    1795162048U, 1795162048U, 1795162048U, 1795162048U,
+    1795162048U, 1795162048U, 1795162048U, 1795162048U,
+    1795162048U, 1795162048U, 1795162048U, 1795162048U,
+    1795162048U, 1795162048U, 1795162048U, 1795162048U,
+    1795162048U, 1795162048U, 1795162048U, 1795162048U,
+    1795162048U, 1795162048U, 1795162048U, 1795162048U,
+    1795162048U, 1795162048U, 1795162048U, 1795162048U,
+    1807744192U, 1807744192U, 1807744192U, 1807744192U,
+    1807744192U, 1807744192U, 1807744192U, 1807744192U,
+    1807744192U, 1807744192U, 1807744192U, 1807744192U,
+    1807744192U, 1807744192U, 1807744192U, 1807744192U,
+    1807744192U, 1807744192U, 1807744192U, 1807744192U,
+    1807744192U, 1807744192U, 1807744192U, 1807744192U,
+    1807744192U, 1807744192U, 1807744192U, 1807744192U,
+    1807744192U, 1807744192U, 1807744192U, 1807744192U,
+    1807744192U, 1807744192U, 1820323264U, 1820323264U,
+    1820323264U, 1820323264U, 1820323264U, 1820323264U,
+    1820323264U, 1820323264U, 1820323264U, 1820323264U,
+    1820323264U, 1820323264U, 1820323264U, 1820323264U,
+    1820323264U, 1820323264U, 1820323264U, 1820323264U,
+    1820323264U, 1820323264U, 1820323264U, 1820323264U,
+    1820323264U, 1820323264U, 1820323264U, 1820323264U,
+    1820323264U, 1820323264U, 1820323264U, 1820323264U,
+    1820323264U, 1820323264U, 1820323264U, 1820323264U,
+    1832910784U, 1832910784U, 1832910784U, 1832910784U,
+    1832910784U, 1832910784U, 1832910784U, 1832910784U,
+    1832910784U, 1832910784U, 1832910784U, 1832910784U,
+    1832910784U, 1832910784U, 1832910784U, 1832910784U,
+    1832910784U, 1832910784U, 1832910784U, 1832910784U,
+    1832910784U, 1832910784U, 1832910784U, 1832910784U,
+    1832910784U, 1832910784U, 1832910784U, 1832910784U,
+    1832910784U, 1832910784U, 1832910784U, 1832910784U,
+    1832910784U, 1832910784U, 1845492416U, 1845492416U,
+    1845492416U, 1845492416U, 1845492416U, 1845492416U,
+    1845492416U, 1845492416U, 1845492416U, 1845492416U,
+    1845492416U, 1845492416U, 1845492416U, 1845492416U,
+    1845492416U, 1845492416U, 1845492416U, 1845492416U,
+    1845492416U, 1845492416U, 1845492416U, 1845492416U,
+    1845492416U, 1845492416U, 1845492416U, 1845492416U,
+    1845492416U, 1845492416U, 1845492416U, 1845492416U,
+    1845492416U, 1845492416U, 1845492416U, 1845492416U,
+    1845492416U, 1858076224U, 1858076224U, 1858076224U,
+    1858076224U, 1858076224U, 1858076224U, 1858076224U,
+    1858076224U, 1858076224U, 1858076224U, 1858076224U,
+    1858076224U, 1858076224U, 1858076224U, 1858076224U,
+    1858076224U, 1858076224U, 1858076224U, 1858076224U,
+    1858076224U, 1858076224U, 1858076224U, 1858076224U,
+    1858076224U, 1858076224U, 1858076224U, 1858076224U,
+    1858076224U, 1858076224U, 1858076224U, 1858076224U,
+    1858076224U, 1858076224U, 1858076224U, 1858076224U,
+    1870659008U, 1870659008U, 1870659008U, 1870659008U,
+    1870659008U, 1870659008U, 1870659008U, 1870659008U,
+    1870659008U, 1870659008U, 1870659008U, 1870659008U,
+    1870659008U, 1870659008U, 1870659008U, 1870659008U,
+    1870659008U, 1870659008U, 1870659008U, 1870659008U,
+    1870659008U, 1870659008U, 1870659008U, 1870659008U,
+    1870659008U, 1870659008U, 1870659008U, 1870659008U,
+    1870659008U, 1870659008U, 1870659008U, 1870659008U,
+    1870659008U, 1870659008U, 1870659008U, 1883240768U,
+    1883240768U, 1883240768U, 1883240768U, 1883240768U,
+    1883240768U, 1883240768U, 1883240768U, 1883240768U,
+    1883240768U, 1883240768U, 1883240768U, 1883240768U,
+    1883240768U, 1883240768U, 1883240768U, 1883240768U,
+    1883240768U, 1883240768U, 1883240768U, 1883240768U,
+    1883240768U, 1883240768U, 1883240768U, 1883240768U,
+    1883240768U, 1883240768U, 1883240768U, 1883240768U,
+    1883240768U, 1883240768U, 1883240768U, 1883240768U,
+    1883240768U, 1883240768U, 1883240768U, 1895825216U,
+    1895825216U, 1895825216U, 1895825216U, 1895825216U,
+    1895825216U, 1895825216U, 1895825216U, 1895825216U,
+    1895825216U, 1895825216U, 1895825216U, 1895825216U,
+    1895825216U, 1895825216U, 1895825216U, 1895825216U,
+    1895825216U, 1895825216U, 1895825216U, 1895825216U,
+    1895825216U, 1895825216U, 1895825216U, 1895825216U,
+    1895825216U, 1895825216U, 1895825216U, 1895825216U,
+    1895825216U, 1895825216U, 1895825216U, 1895825216U,
+    1895825216U, 1895825216U, 1895825216U, 1908407744U,
+    1908407744U, 1908407744U, 1908407744U, 1908407744U,
+    1908407744U, 1908407744U, 1908407744U, 1908407744U,
+    1908407744U, 1908407744U, 1908407744U, 1908407744U,
+    1908407744U, 1908407744U, 1908407744U, 1908407744U,
+    1908407744U, 1908407744U, 1908407744U, 1908407744U,
+    1908407744U, 1908407744U, 1908407744U, 1908407744U,
+    1908407744U, 1908407744U, 1908407744U, 1908407744U,
+    1908407744U, 1908407744U, 1908407744U, 1908407744U,
+    1908407744U, 1908407744U, 1908407744U, 1920990784U,
+    1920990784U, 1920990784U, 1920990784U, 1920990784U,
+    1920990784U, 1920990784U, 1920990784U, 1920990784U,
+    1920990784U, 1920990784U, 1920990784U, 1920990784U,
+    1920990784U, 1920990784U, 1920990784U, 1920990784U,
+    1920990784U, 1920990784U, 1920990784U, 1920990784U,
+    1920990784U, 1920990784U, 1920990784U, 1920990784U,
+    1920990784U, 1920990784U, 1920990784U, 1920990784U,
+    1920990784U, 1920990784U, 1920990784U, 1920990784U,
+    1920990784U, 1920990784U, 1920990784U, 1920990784U,
+    1933573952U, 1933573952U, 1933573952U, 1933573952U,
+    1933573952U, 1933573952U, 1933573952U, 1933573952U,
+    1933573952U, 1933573952U, 1933573952U, 1933573952U
+};
+
+#endif // BITCOIN_CRYPTO_DAG_SIZES_H
@@ -0,0 +1,387 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// AVX2 versions of the sponge routines of Sponge.c, and of LYRA2 on four inputs at once.
+
+#ifdef ENABLE_AVX2
+
+#include "crypto/Lyra2.h"
+#include "crypto/Sponge.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+namespace lyra2_avx2
+{
+namespace {
+
+inline __m256i Load(const uint64_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+inline void Store(uint64_t* p, __m256i x) { _mm256_storeu_si256((__m256i*)p, x); }
+
+/** The rotations of Blake2b's G function, on each 64 bit word */
+inline __m256i Rotr32(__m256i x) { return _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)); }
+inline __m256i Rotr24(__m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+                                                   3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10));
+}
+inline __m256i Rotr16(__m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+                                                   2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9));
+}
+inline __m256i Rotr63(__m256i x) { return _mm256_xor_si256(_mm256_srli_epi64(x, 63), _mm256_add_epi64(x, x)); }
+
+inline void Mix(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    a = _mm256_add_epi64(a, b);
+    d = Rotr32(_mm256_xor_si256(d, a));
+    c = _mm256_add_epi64(c, d);
+    b = Rotr24(_mm256_xor_si256(b, c));
+    a = _mm256_add_epi64(a, b);
+    d = Rotr16(_mm256_xor_si256(d, a));
+    c = _mm256_add_epi64(c, d);
+    b = Rotr63(_mm256_xor_si256(b, c));
+}
+
+/**
+ * The single lane state is held in four registers, one per row of Blake2b's 4x4 matrix of words, so the column
+ * step mixes all four columns at once. The diagonal step rotates the last three rows to line the diagonals up as
+ * columns, and back.
+ */
+struct State {
+    __m256i a, b, c, d;
+
+    explicit State(const uint64_t* state) : a(Load(state)), b(Load(state + 4)), c(Load(state + 8)), d(Load(state + 12)) {}
+
+    void Save(uint64_t* state) const
+    {
+        Store(state, a);
+        Store(state + 4, b);
+        Store(state + 8, c);
+        Store(state + 12, d);
+    }
+
+    void Round()
+    {
+        Mix(a, b, c, d);
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+        Mix(a, b, c, d);
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+    }
+
+    void Rounds()
+    {
+        for (int i = 0; i < 12; i++) Round();
+    }
+
+    /** XORs the BLOCK_LEN_INT64 words of a block into the rate */
+    void Absorb(const __m256i& x0, const __m256i& x1, const __m256i& x2)
+    {
+        a = _mm256_xor_si256(a, x0);
+        b = _mm256_xor_si256(b, x1);
+        c = _mm256_xor_si256(c, x2);
+    }
+
+    /** The rate rotated by one word, rotW(rand) of reducedDuplexRowSetup */
+    void RotW(__m256i& r0, __m256i& r1, __m256i& r2) const
+    {
+        __m256i ra = _mm256_permute4x64_epi64(a, _MM_SHUFFLE(2, 1, 0, 3));
+        __m256i rb = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+        __m256i rc = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(2, 1, 0, 3));
+        r0 = _mm256_blend_epi32(ra, rc, 0x03);
+        r1 = _mm256_blend_epi32(rb, ra, 0x03);
+        r2 = _mm256_blend_epi32(rc, rb, 0x03);
+    }
+};
+
+/**
+ * The state of four lanes, with register k holding word k of every lane. A round is the same sequence of G
+ * functions as ROUND_LYRA, each working on all lanes.
+ */
+struct State4 {
+    __m256i v[16];
+
+    void Round()
+    {
+        Mix(v[0], v[4], v[8], v[12]);
+        Mix(v[1], v[5], v[9], v[13]);
+        Mix(v[2], v[6], v[10], v[14]);
+        Mix(v[3], v[7], v[11], v[15]);
+        Mix(v[0], v[5], v[10], v[15]);
+        Mix(v[1], v[6], v[11], v[12]);
+        Mix(v[2], v[7], v[8], v[13]);
+        Mix(v[3], v[4], v[9], v[14]);
+    }
+
+    void Rounds()
+    {
+        for (int i = 0; i < 12; i++) Round();
+    }
+};
+
+/**
+ * The matrix of LYRA2_4way interleaves the lanes: word w of the matrix of every lane is stored as the four words
+ * starting at 4 * w. Rows visited by all lanes are accessed with plain loads and stores, and the rows picked by
+ * each lane during the Wandering phase with gathers and scalar stores.
+ */
+inline uint64_t* Row(uint64_t* matrix, int64_t row, uint64_t nCols) { return matrix + row * (int64_t)nCols * BLOCK_LEN_INT64 * 4; }
+
+}
+
+void AbsorbBlock(uint64_t* state, const uint64_t* in)
+{
+    State s(state);
+    s.Absorb(Load(in), Load(in + 4), Load(in + 8));
+    s.Rounds();
+    s.Save(state);
+}
+
+void AbsorbBlockBlake2Safe(uint64_t* state, const uint64_t* in)
+{
+    State s(state);
+    s.a = _mm256_xor_si256(s.a, Load(in));
+    s.b = _mm256_xor_si256(s.b, Load(in + 4));
+    s.Rounds();
+    s.Save(state);
+}
+
+void Squeeze(uint64_t* state, unsigned char* out, unsigned int len)
+{
+    State s(state);
+    for (unsigned int i = 0; i < len / BLOCK_LEN_BYTES; i++) {
+        s.Save(state);
+        memcpy(out, state, BLOCK_LEN_BYTES);
+        s.Rounds();
+        out += BLOCK_LEN_BYTES;
+    }
+    s.Save(state);
+    memcpy(out, state, len % BLOCK_LEN_BYTES);
+}
+
+void ReducedSqueezeRow0(uint64_t* state, uint64_t* rowOut, uint64_t nCols)
+{
+    State s(state);
+    uint64_t* ptrWord = rowOut + (nCols - 1) * BLOCK_LEN_INT64;
+    for (uint64_t i = 0; i < nCols; i++) {
+        Store(ptrWord, s.a);
+        Store(ptrWord + 4, s.b);
+        Store(ptrWord + 8, s.c);
+        ptrWord -= BLOCK_LEN_INT64;
+        s.Round();
+    }
+    s.Save(state);
+}
+
+void ReducedDuplexRow1(uint64_t* state, uint64_t* rowIn, uint64_t* rowOut, uint64_t nCols)
+{
+    State s(state);
+    uint64_t* ptrWordIn = rowIn;
+    uint64_t* ptrWordOut = rowOut + (nCols - 1) * BLOCK_LEN_INT64;
+    for (uint64_t i = 0; i < nCols; i++) {
+        __m256i in0 = Load(ptrWordIn), in1 = Load(ptrWordIn + 4), in2 = Load(ptrWordIn + 8);
+        s.Absorb(in0, in1, in2);
+        s.Round();
+        Store(ptrWordOut, _mm256_xor_si256(in0, s.a));
+        Store(ptrWordOut + 4, _mm256_xor_si256(in1, s.b));
+        Store(ptrWordOut + 8, _mm256_xor_si256(in2, s.c));
+        ptrWordIn += BLOCK_LEN_INT64;
+        ptrWordOut -= BLOCK_LEN_INT64;
+    }
+    s.Save(state);
+}
+
+void ReducedDuplexRowSetup(uint64_t* state, uint64_t* rowIn, uint64_t* rowInOut, uint64_t* rowOut, uint64_t nCols)
+{
+    State s(state);
+    uint64_t* ptrWordIn = rowIn;
+    uint64_t* ptrWordInOut = rowInOut;
+    uint64_t* ptrWordOut = rowOut + (nCols - 1) * BLOCK_LEN_INT64;
+    for (uint64_t i = 0; i < nCols; i++) {
+        __m256i in0 = Load(ptrWordIn), in1 = Load(ptrWordIn + 4), in2 = Load(ptrWordIn + 8);
+        s.Absorb(_mm256_add_epi64(in0, Load(ptrWordInOut)), _mm256_add_epi64(in1, Load(ptrWordInOut + 4)), _mm256_add_epi64(in2, Load(ptrWordInOut + 8)));
+        s.Round();
+        Store(ptrWordOut, _mm256_xor_si256(in0, s.a));
+        Store(ptrWordOut + 4, _mm256_xor_si256(in1, s.b));
+        Store(ptrWordOut + 8, _mm256_xor_si256(in2, s.c));
+        // Reloaded after the stores above, which the row may overlap
+        __m256i r0, r1, r2;
+        s.RotW(r0, r1, r2);
+        Store(ptrWordInOut, _mm256_xor_si256(Load(ptrWordInOut), r0));
+        Store(ptrWordInOut + 4, _mm256_xor_si256(Load(ptrWordInOut + 4), r1));
+        Store(ptrWordInOut + 8, _mm256_xor_si256(Load(ptrWordInOut + 8), r2));
+        ptrWordInOut += BLOCK_LEN_INT64;
+        ptrWordIn += BLOCK_LEN_INT64;
+        ptrWordOut -= BLOCK_LEN_INT64;
+    }
+    s.Save(state);
+}
+
+void ReducedDuplexRow(uint64_t* state, uint64_t* rowIn, uint64_t* rowInOut, uint64_t* rowOut, uint64_t nCols)
+{
+    State s(state);
+    uint64_t* ptrWordIn = rowIn;
+    uint64_t* ptrWordInOut = rowInOut;
+    uint64_t* ptrWordOut = rowOut;
+    for (uint64_t i = 0; i < nCols; i++) {
+        s.Absorb(_mm256_add_epi64(Load(ptrWordIn), Load(ptrWordInOut)), _mm256_add_epi64(Load(ptrWordIn + 4), Load(ptrWordInOut + 4)), _mm256_add_epi64(Load(ptrWordIn + 8), Load(ptrWordInOut + 8)));
+        s.Round();
+        Store(ptrWordOut, _mm256_xor_si256(Load(ptrWordOut), s.a));
+        Store(ptrWordOut + 4, _mm256_xor_si256(Load(ptrWordOut + 4), s.b));
+        Store(ptrWordOut + 8, _mm256_xor_si256(Load(ptrWordOut + 8), s.c));
+        // Reloaded after the stores above, as row* is the same row as the output one when rowa == row
+        __m256i r0, r1, r2;
+        s.RotW(r0, r1, r2);
+        Store(ptrWordInOut, _mm256_xor_si256(Load(ptrWordInOut), r0));
+        Store(ptrWordInOut + 4, _mm256_xor_si256(Load(ptrWordInOut + 4), r1));
+        Store(ptrWordInOut + 8, _mm256_xor_si256(Load(ptrWordInOut + 8), r2));
+        ptrWordOut += BLOCK_LEN_INT64;
+        ptrWordInOut += BLOCK_LEN_INT64;
+        ptrWordIn += BLOCK_LEN_INT64;
+    }
+    s.Save(state);
+}
+
+/**
+ * LYRA2_scratch on four inputs, following its phases step by step with State4. Every lane visits the same rows
+ * except for row*, which the Wandering phase picks from each lane's own state.
+ */
+int Lyra2_4way(void* const* K, uint64_t kLen, const void* const* pwd, uint64_t pwdlen, const void* const* salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols, uint64_t* wholeMatrix)
+{
+    const uint64_t laneWords = LYRA2_MATRIX_INT64(nRows, nCols);
+    const uint64_t ROW_LEN_INT64 = BLOCK_LEN_INT64 * nCols;
+    State4 s;
+
+    // The padded inputs go to each lane's own quarter of the matrix, which is only written after they are absorbed
+    uint64_t nBlocksInput = 0;
+    for (int l = 0; l < LYRA2_LANES; l++) {
+        nBlocksInput = LYRA2_pad_input(wholeMatrix + l * laneWords, kLen, pwd[l], pwdlen, salt[l], saltlen, timeCost, nRows, nCols);
+    }
+    for (int k = 0; k < 8; k++) {
+        s.v[k] = _mm256_setzero_si256();
+        s.v[k + 8] = _mm256_set1_epi64x(blake2b_IV[k]);
+    }
+    for (uint64_t i = 0; i < nBlocksInput; i++) {
+        for (int k = 0; k < BLOCK_LEN_BLAKE2_SAFE_INT64; k++) {
+            const uint64_t w = i * BLOCK_LEN_BLAKE2_SAFE_INT64 + k;
+            s.v[k] = _mm256_xor_si256(s.v[k], _mm256_set_epi64x(wholeMatrix[3 * laneWords + w], wholeMatrix[2 * laneWords + w], wholeMatrix[laneWords + w], wholeMatrix[w]));
+        }
+        s.Rounds();
+    }
+
+    // Setup phase: reducedSqueezeRow0, reducedDuplexRow1 and reducedDuplexRowSetup on all lanes
+    uint64_t* ptrWordOut = Row(wholeMatrix, 0, nCols) + (nCols - 1) * BLOCK_LEN_INT64 * 4;
+    for (uint64_t i = 0; i < nCols; i++) {
+        for (int k = 0; k < BLOCK_LEN_INT64; k++) Store(ptrWordOut + 4 * k, s.v[k]);
+        ptrWordOut -= BLOCK_LEN_INT64 * 4;
+        s.Round();
+    }
+    uint64_t* ptrWordIn = Row(wholeMatrix, 0, nCols);
+    ptrWordOut = Row(wholeMatrix, 1, nCols) + (nCols - 1) * BLOCK_LEN_INT64 * 4;
+    for (uint64_t i = 0; i < nCols; i++) {
+        __m256i in[BLOCK_LEN_INT64];
+        for (int k = 0; k < BLOCK_LEN_INT64; k++) {
+            in[k] = Load(ptrWordIn + 4 * k);
+            s.v[k] = _mm256_xor_si256(s.v[k], in[k]);
+        }
+        s.Round();
+        for (int k = 0; k < BLOCK_LEN_INT64; k++) Store(ptrWordOut + 4 * k, _mm256_xor_si256(in[k], s.v[k]));
+        ptrWordIn += BLOCK_LEN_INT64 * 4;
+        ptrWordOut -= BLOCK_LEN_INT64 * 4;
+    }
+
+    int64_t row = 2, prev = 1, rowa = 0, step = 1, window = 2, gap = 1;
+    do {
+        ptrWordIn = Row(wholeMatrix, prev, nCols);
+        uint64_t* ptrWordInOut = Row(wholeMatrix, rowa, nCols);
+        ptrWordOut = Row(wholeMatrix, row, nCols) + (nCols - 1) * BLOCK_LEN_INT64 * 4;
+        for (uint64_t i = 0; i < nCols; i++) {
+            __m256i in[BLOCK_LEN_INT64];
+            for (int k = 0; k < BLOCK_LEN_INT64; k++) {
+                in[k] = Load(ptrWordIn + 4 * k);
+                s.v[k] = _mm256_xor_si256(s.v[k], _mm256_add_epi64(in[k], Load(ptrWordInOut + 4 * k)));
+            }
+            s.Round();
+            for (int k = 0; k < BLOCK_LEN_INT64; k++) Store(ptrWordOut + 4 * k, _mm256_xor_si256(in[k], s.v[k]));
+            for (int k = 0; k < BLOCK_LEN_INT64; k++) {
+                Store(ptrWordInOut + 4 * k, _mm256_xor_si256(Load(ptrWordInOut + 4 * k), s.v[(k + BLOCK_LEN_INT64 - 1) % BLOCK_LEN_INT64]));
+            }
+            ptrWordInOut += BLOCK_LEN_INT64 * 4;
+            ptrWordIn += BLOCK_LEN_INT64 * 4;
+            ptrWordOut -= BLOCK_LEN_INT64 * 4;
+        }
+        rowa = (rowa + step) & (window - 1);
+        prev = row;
+        row++;
+        if (rowa == 0) {
+            step = window + gap;
+            window *= 2;
+            gap = -gap;
+        }
+    } while (row < (int64_t)nRows);
+
+    // Wandering phase: reducedDuplexRow, with each lane's row* gathered from its own row and updated word by word
+    alignas(32) uint64_t rowas[LYRA2_LANES];
+    alignas(32) uint64_t rot[BLOCK_LEN_INT64][LYRA2_LANES];
+    for (int l = 0; l < LYRA2_LANES; l++) rowas[l] = rowa * ROW_LEN_INT64 * 4 + l;
+    row = 0;
+    for (int64_t tau = 1; tau <= (int64_t)timeCost; tau++) {
+        step = (tau % 2 == 0) ? -1 : (int64_t)nRows / 2 - 1;
+        do {
+            _mm256_store_si256((__m256i*)rowas, s.v[0]);
+            for (int l = 0; l < LYRA2_LANES; l++) rowas[l] = rowas[l] % nRows * ROW_LEN_INT64 * 4 + l;
+            __m256i inOut = _mm256_load_si256((const __m256i*)rowas);
+            ptrWordIn = Row(wholeMatrix, prev, nCols);
+            ptrWordOut = Row(wholeMatrix, row, nCols);
+            for (uint64_t i = 0; i < nCols; i++) {
+                for (int k = 0; k < BLOCK_LEN_INT64; k++) {
+                    __m256i x = _mm256_i64gather_epi64((const long long*)wholeMatrix, _mm256_add_epi64(inOut, _mm256_set1_epi64x(4 * k)), 8);
+                    s.v[k] = _mm256_xor_si256(s.v[k], _mm256_add_epi64(Load(ptrWordIn + 4 * k), x));
+                }
+                s.Round();
+                for (int k = 0; k < BLOCK_LEN_INT64; k++) {
+                    Store(ptrWordOut + 4 * k, _mm256_xor_si256(Load(ptrWordOut + 4 * k), s.v[k]));
+                    _mm256_store_si256((__m256i*)rot[k], s.v[(k + BLOCK_LEN_INT64 - 1) % BLOCK_LEN_INT64]);
+                }
+                // Scalar updates, after the output row's, which is row* itself for the lanes where rowa == row
+                for (int l = 0; l < LYRA2_LANES; l++) {
+                    uint64_t* ptrWordInOut = wholeMatrix + rowas[l] + i * BLOCK_LEN_INT64 * 4;
+                    for (int k = 0; k < BLOCK_LEN_INT64; k++) ptrWordInOut[4 * k] ^= rot[k][l];
+                }
+                inOut = _mm256_add_epi64(inOut, _mm256_set1_epi64x(BLOCK_LEN_INT64 * 4));
+                ptrWordIn += BLOCK_LEN_INT64 * 4;
+                ptrWordOut += BLOCK_LEN_INT64 * 4;
+            }
+            prev = row;
+            row = (row + step) % (int64_t)nRows;
+        } while (row != 0);
+    }
+
+    // Wrap-up phase: absorbBlock of the first column of each lane's last row*, then squeeze
+    __m256i lastRow = _mm256_load_si256((const __m256i*)rowas);
+    for (int k = 0; k < BLOCK_LEN_INT64; k++) {
+        __m256i x = _mm256_i64gather_epi64((const long long*)wholeMatrix, _mm256_add_epi64(lastRow, _mm256_set1_epi64x(4 * k)), 8);
+        s.v[k] = _mm256_xor_si256(s.v[k], x);
+    }
+    s.Rounds();
+    alignas(32) uint64_t words[BLOCK_LEN_INT64][LYRA2_LANES];
+    for (uint64_t done = 0; done < kLen; done += BLOCK_LEN_BYTES) {
+        if (done > 0) s.Rounds();
+        for (int k = 0; k < BLOCK_LEN_INT64; k++) _mm256_store_si256((__m256i*)words[k], s.v[k]);
+        for (int l = 0; l < LYRA2_LANES; l++) {
+            uint64_t block[BLOCK_LEN_INT64];
+            for (int k = 0; k < BLOCK_LEN_INT64; k++) block[k] = words[k][l];
+            memcpy((unsigned char*)K[l] + done, block, kLen - done < BLOCK_LEN_BYTES ? kLen - done : BLOCK_LEN_BYTES);
+        }
+    }
+    return 0;
+}
+}
+
+#endif
@@ -27,13 +27,26 @@
  * online backup system.
  */
 
+#if defined(HAVE_CONFIG_H)
+#include "config/bitcoin-config.h"
+#endif
+
 #include "crypto/scrypt.h"
 //#include "util.h"
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <vector>
 #include <openssl/sha.h>
 
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+#include <cpuid.h>
+namespace scrypt_avx2
+{
+void Scrypt_1024_1_1_256_8way(const char* const* input, char* const* output, char* scratchpad);
+}
+#endif
+
 #if defined(USE_SSE2) && !defined(USE_SSE2_ALWAYS)
 #ifdef _MSC_VER
 // MSVC 64bit is unable to use inline asm
@@ -329,3 +342,76 @@ void scrypt_1024_1_1_256(const char *input, char *output)
 	char scratchpad[SCRYPT_SCRATCHPAD_SIZE];
     scrypt_1024_1_1_256_sp(input, output, scratchpad);
 }
+
+/* Set by scrypt_detect_avx2 */
+static bool scrypt_use_avx2 = false;
+
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+/* Check a full batch of distinct inputs against the generic implementation */
+static bool scrypt_avx2_selftest()
+{
+    char inputs[SCRYPT_BATCH_LANES][80];
+    char outputs[SCRYPT_BATCH_LANES][32];
+    char expected[32];
+    char scratchpad[SCRYPT_SCRATCHPAD_SIZE];
+    const char *in[SCRYPT_BATCH_LANES];
+    char *out[SCRYPT_BATCH_LANES];
+    for (int l = 0; l < SCRYPT_BATCH_LANES; l++) {
+        for (int i = 0; i < 80; i++)
+            inputs[l][i] = (char)(l * 80 + i * 7 + 1);
+        in[l] = inputs[l];
+        out[l] = outputs[l];
+    }
+    scrypt_1024_1_1_256_batch(in, out, SCRYPT_BATCH_LANES);
+    for (int l = 0; l < SCRYPT_BATCH_LANES; l++) {
+        scrypt_1024_1_1_256_sp_generic(inputs[l], expected, scratchpad);
+        if (memcmp(expected, outputs[l], sizeof(expected)) != 0)
+            return false;
+    }
+    return true;
+}
+#endif
+
+std::string scrypt_detect_avx2()
+{
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+    uint32_t eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && ((ecx >> 27) & 1) && __get_cpuid_max(0, nullptr) >= 7) {
+        uint32_t xcr0, xcr0_high;
+        __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        if ((xcr0 & 6) == 6 && ((ebx >> 5) & 1)) {
+            scrypt_use_avx2 = true;
+            if (scrypt_avx2_selftest())
+                return "scrypt: using 8-way avx2 for batches";
+            scrypt_use_avx2 = false;
+            return "scrypt: batches hashed one by one, the avx2 kernel failed its self-test";
+        }
+    }
+#endif
+    scrypt_use_avx2 = false;
+    return "scrypt: batches hashed one by one, AVX2 unavailable";
+}
+
+void scrypt_1024_1_1_256_batch(const char *const *inputs, char *const *outputs, size_t n)
+{
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+    if (scrypt_use_avx2 && n > 1) {
+        std::vector<char> scratchpad(SCRYPT_BATCH_LANES * 131072 + 63);
+        char tail[SCRYPT_BATCH_LANES][32];
+        for (size_t begin = 0; begin < n; begin += SCRYPT_BATCH_LANES) {
+            // A short last group fills its unused lanes with its last input and drops their outputs
+            const char *in[SCRYPT_BATCH_LANES];
+            char *out[SCRYPT_BATCH_LANES];
+            for (size_t l = 0; l < SCRYPT_BATCH_LANES; l++) {
+                in[l] = inputs[begin + l < n ? begin + l : n - 1];
+                out[l] = begin + l < n ? outputs[begin + l] : tail[l];
+            }
+            scrypt_avx2::Scrypt_1024_1_1_256_8way(in, out, scratchpad.data());
+        }
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; i++)
+        scrypt_1024_1_1_256(inputs[i], outputs[i]);
+}
@@ -3,13 +3,24 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+#include <string>
+
 static const int SCRYPT_SCRATCHPAD_SIZE = 131072 + 63;
+/** Number of inputs scrypt_1024_1_1_256_batch hashes side by side with AVX2 */
+static const int SCRYPT_BATCH_LANES = 8;
 
 void scrypt_1024_1_1_256(const char *input, char *output);
 void scrypt_1024_1_1_256_sp_generic(const char *input, char *output, char *scratchpad);
 
+/** Select the AVX2 kernel of scrypt_1024_1_1_256_batch if the CPU supports it. Returns a description for the log. */
+std::string scrypt_detect_avx2();
+/**
+ * Hash the n 80 byte inputs into the 32 byte outputs, the same as n calls to scrypt_1024_1_1_256. With AVX2 the
+ * inputs are hashed SCRYPT_BATCH_LANES at a time.
+ */
+void scrypt_1024_1_1_256_batch(const char *const *inputs, char *const *outputs, size_t n);
+
 #if defined(USE_SSE2)
-#include <string>
 #if defined(_M_X64) || defined(__x86_64__) || defined(_M_AMD64) || (defined(MAC_OSX) && defined(__i386__))
 #define USE_SSE2_ALWAYS 1
 #define scrypt_1024_1_1_256_sp(input, output, scratchpad) scrypt_1024_1_1_256_sp_sse2((input), (output), (scratchpad))
@@ -0,0 +1,110 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// AVX2 version of scrypt_1024_1_1_256, hashing eight inputs at once.
+
+#ifdef ENABLE_AVX2
+
+#include "crypto/scrypt.h"
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace scrypt_avx2
+{
+namespace {
+
+inline __m256i Rotl(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n));
+}
+
+#define QUARTER(a, b, c, d) \
+    b = _mm256_xor_si256(b, Rotl(_mm256_add_epi32(a, d), 7)); \
+    c = _mm256_xor_si256(c, Rotl(_mm256_add_epi32(b, a), 9)); \
+    d = _mm256_xor_si256(d, Rotl(_mm256_add_epi32(c, b), 13)); \
+    a = _mm256_xor_si256(a, Rotl(_mm256_add_epi32(d, c), 18));
+
+/** xor_salsa8 of scrypt.cpp, with register k holding word k of all eight lanes */
+inline void XorSalsa8(__m256i B[16], const __m256i Bx[16])
+{
+    __m256i x[16];
+    for (int k = 0; k < 16; k++) {
+        x[k] = B[k] = _mm256_xor_si256(B[k], Bx[k]);
+    }
+    for (int i = 0; i < 8; i += 2) {
+        /* Operate on columns. */
+        QUARTER(x[0], x[4], x[8], x[12]);
+        QUARTER(x[5], x[9], x[13], x[1]);
+        QUARTER(x[10], x[14], x[2], x[6]);
+        QUARTER(x[15], x[3], x[7], x[11]);
+
+        /* Operate on rows. */
+        QUARTER(x[0], x[1], x[2], x[3]);
+        QUARTER(x[5], x[6], x[7], x[4]);
+        QUARTER(x[10], x[11], x[8], x[9]);
+        QUARTER(x[15], x[12], x[13], x[14]);
+    }
+    for (int k = 0; k < 16; k++) {
+        B[k] = _mm256_add_epi32(B[k], x[k]);
+    }
+}
+
+#undef QUARTER
+
+}
+
+/**
+ * The 128 byte scrypt state of every lane is transposed into 32 registers, so that each Salsa20/8 step works on
+ * all lanes at once. V stores the states in the same layout, and the data dependent reads of the second loop
+ * gather each lane's word from its own row.
+ */
+void Scrypt_1024_1_1_256_8way(const char* const* input, char* const* output, char* scratchpad)
+{
+    alignas(32) uint8_t B[8][128];
+    alignas(32) uint32_t words[8];
+    __m256i X[32];
+    __m256i* V = (__m256i*)(((uintptr_t)(scratchpad) + 63) & ~(uintptr_t)(63));
+
+    for (int l = 0; l < 8; l++) {
+        PBKDF2_SHA256((const uint8_t*)input[l], 80, (const uint8_t*)input[l], 80, 1, B[l], 128);
+    }
+    for (int k = 0; k < 32; k++) {
+        for (int l = 0; l < 8; l++) {
+            words[l] = le32dec(&B[l][4 * k]);
+        }
+        X[k] = _mm256_load_si256((const __m256i*)words);
+    }
+
+    for (int i = 0; i < 1024; i++) {
+        for (int k = 0; k < 32; k++) {
+            _mm256_store_si256(&V[i * 32 + k], X[k]);
+        }
+        XorSalsa8(&X[0], &X[16]);
+        XorSalsa8(&X[16], &X[0]);
+    }
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (int i = 0; i < 1024; i++) {
+        // Word index of the first word of row (X[16] & 1023) of every lane
+        __m256i row = _mm256_add_epi32(_mm256_slli_epi32(_mm256_and_si256(X[16], _mm256_set1_epi32(1023)), 8), lanes);
+        for (int k = 0; k < 32; k++) {
+            X[k] = _mm256_xor_si256(X[k], _mm256_i32gather_epi32((const int*)V + k * 8, row, 4));
+        }
+        XorSalsa8(&X[0], &X[16]);
+        XorSalsa8(&X[16], &X[0]);
+    }
+
+    for (int k = 0; k < 32; k++) {
+        _mm256_store_si256((__m256i*)words, X[k]);
+        for (int l = 0; l < 8; l++) {
+            le32enc(&B[l][4 * k], words[l]);
+        }
+    }
+    for (int l = 0; l < 8; l++) {
+        PBKDF2_SHA256((const uint8_t*)input[l], 80, B[l], 128, 1, (uint8_t*)output[l], 32);
+    }
+}
+}
+
+#endif
@@ -2,6 +2,10 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#if defined(HAVE_CONFIG_H)
+#include "config/bitcoin-config.h"
+#endif
+
 #include "crypto/sha256.h"
 #include "crypto/common.h"
 
@@ -19,6 +23,14 @@ void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks);
 #endif
 #endif
 
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+#include <cpuid.h>
+namespace sha256d64_avx2
+{
+void TransformD64_8way(unsigned char* out, const unsigned char* in);
+}
+#endif
+
 // Internal implementation code.
 namespace
 {
@@ -174,21 +186,89 @@ bool SelfTest(TransformType tr) {
 
 TransformType Transform = sha256::Transform;
 
+typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
+
+/** Double SHA-256 of a 64-byte input, with the transforms of the current implementation */
+void TransformD64(unsigned char* out, const unsigned char* in)
+{
+    static const unsigned char padding1[64] = {0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0};
+    unsigned char buffer2[64] = {0};
+    buffer2[32] = 0x80;
+    buffer2[62] = 1;
+    uint32_t s[8];
+    sha256::Initialize(s);
+    Transform(s, in, 1);
+    Transform(s, padding1, 1);
+    for (int i = 0; i < 8; i++) {
+        WriteBE32(buffer2 + 4 * i, s[i]);
+    }
+    sha256::Initialize(s);
+    Transform(s, buffer2, 1);
+    for (int i = 0; i < 8; i++) {
+        WriteBE32(out + 4 * i, s[i]);
+    }
+}
+
+/** Hashes eight 64-byte inputs at once, if the CPU supports it */
+TransformD64Type TransformD64_8way = nullptr;
+
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+/** Whether the OS saves the AVX registers on context switches */
+bool AVXEnabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+
+/** Checks an 8-way double SHA-256 against TransformD64, on distinct inputs and in place */
+bool SelfTestD64(TransformD64Type tr)
+{
+    unsigned char in[8 * 64], expected[8 * 32], out[8 * 64];
+    uint32_t x = 0;
+    for (unsigned char& c : in) {
+        x = x * 1103515245 + 12345;
+        c = x >> 16;
+    }
+    for (int i = 0; i < 8; i++) {
+        TransformD64(expected + 32 * i, in + 64 * i);
+    }
+    tr(out, in);
+    if (memcmp(out, expected, sizeof(expected))) return false;
+    memcpy(out, in, sizeof(in));
+    tr(out, out);
+    return memcmp(out, expected, sizeof(expected)) == 0;
+}
+#endif
+
 } // namespace
 
 std::string SHA256AutoDetect()
 {
+    std::string ret = "standard";
 #if defined(EXPERIMENTAL_ASM) && (defined(__x86_64__) || defined(__amd64__))
     uint32_t eax, ebx, ecx, edx;
     if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx >> 19) & 1) {
         Transform = sha256_sse4::Transform;
-        assert(SelfTest(Transform));
-        return "sse4";
+        ret = "sse4";
     }
 #endif
-
     assert(SelfTest(Transform));
-    return "standard";
+
+    TransformD64_8way = nullptr;
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+    uint32_t a, b, c, d;
+    if (__get_cpuid(1, &a, &b, &c, &d) && ((c >> 27) & 1) && AVXEnabled() && __get_cpuid_max(0, nullptr) >= 7) {
+        __cpuid_count(7, 0, a, b, c, d);
+        if ((b >> 5) & 1) {
+            assert(SelfTestD64(sha256d64_avx2::TransformD64_8way));
+            TransformD64_8way = sha256d64_avx2::TransformD64_8way;
+            ret += ",avx2(8way)";
+        }
+    }
+#endif
+    return ret;
 }
 
 ////// SHA-256
@@ -247,3 +327,21 @@ CSHA256& CSHA256::Reset()
     sha256::Initialize(s);
     return *this;
 }
+
+void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
+{
+    if (TransformD64_8way) {
+        while (blocks >= 8) {
+            TransformD64_8way(out, in);
+            out += 256;
+            in += 512;
+            blocks -= 8;
+        }
+    }
+    while (blocks) {
+        TransformD64(out, in);
+        out += 32;
+        in += 64;
+        --blocks;
+    }
+}
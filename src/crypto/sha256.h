@@ -31,4 +31,9 @@ public:
  */
 std::string SHA256AutoDetect();
 
+/** Compute the double SHA-256 of each of the blocks 64-byte inputs at in, writing the 32-byte hashes to out, which
+ *  may start at in: every input is read before its hash is written, and hashes never overwrite later inputs.
+ */
+void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks);
+
 #endif // BITCOIN_CRYPTO_SHA256_H
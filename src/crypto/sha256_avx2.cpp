@@ -0,0 +1,161 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// AVX2 version of the double SHA-256 of 64-byte inputs, hashing eight of them at once, one per 32-bit lane.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "crypto/common.h"
+
+namespace sha256d64_avx2
+{
+namespace {
+
+const uint32_t K256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const uint32_t INIT[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+uint32_t inline ScalarSigma0(uint32_t x) { return (x >> 7 | x << 25) ^ (x >> 18 | x << 14) ^ (x >> 3); }
+uint32_t inline ScalarSigma1(uint32_t x) { return (x >> 17 | x << 15) ^ (x >> 19 | x << 13) ^ (x >> 10); }
+
+/**
+ * Message schedule of the block padding a 64-byte message, with the round constants added in. It is the same for
+ * every input, so the second transform of the first hash only needs the rounds.
+ */
+struct PaddingSchedule
+{
+    uint32_t wk[64];
+
+    PaddingSchedule()
+    {
+        uint32_t w[64] = {0x80000000};
+        w[15] = 512;
+        for (int i = 16; i < 64; i++) {
+            w[i] = ScalarSigma1(w[i - 2]) + w[i - 7] + ScalarSigma0(w[i - 15]) + w[i - 16];
+        }
+        for (int i = 0; i < 64; i++) {
+            wk[i] = w[i] + K256[i];
+        }
+    }
+};
+
+__m256i inline K(uint32_t x) { return _mm256_set1_epi32(x); }
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Add(__m256i x, __m256i y, __m256i z) { return Add(Add(x, y), z); }
+__m256i inline Add(__m256i x, __m256i y, __m256i z, __m256i w) { return Add(Add(x, y), Add(z, w)); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline Xor(__m256i x, __m256i y, __m256i z) { return Xor(Xor(x, y), z); }
+__m256i inline Or(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+__m256i inline And(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+__m256i inline Rotr(__m256i x, int n) { return Or(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n)); }
+
+__m256i inline Ch(__m256i x, __m256i y, __m256i z) { return Xor(z, And(x, Xor(y, z))); }
+__m256i inline Maj(__m256i x, __m256i y, __m256i z) { return Or(And(x, y), And(z, Or(x, y))); }
+__m256i inline Sigma0(__m256i x) { return Xor(Rotr(x, 2), Rotr(x, 13), Rotr(x, 22)); }
+__m256i inline Sigma1(__m256i x) { return Xor(Rotr(x, 6), Rotr(x, 11), Rotr(x, 25)); }
+__m256i inline sigma0(__m256i x) { return Xor(Rotr(x, 7), Rotr(x, 18), _mm256_srli_epi32(x, 3)); }
+__m256i inline sigma1(__m256i x) { return Xor(Rotr(x, 17), Rotr(x, 19), _mm256_srli_epi32(x, 10)); }
+
+/** Sixty-four rounds on the state s, where wk(i) returns the message word plus the round constant of round i */
+template<typename WK>
+void inline Rounds(__m256i* s, WK wk)
+{
+    __m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    for (int i = 0; i < 64; i++) {
+        __m256i t1 = Add(h, Sigma1(e), Ch(e, f, g), wk(i));
+        __m256i t2 = Add(Sigma0(a), Maj(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = Add(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = Add(t1, t2);
+    }
+    s[0] = Add(s[0], a);
+    s[1] = Add(s[1], b);
+    s[2] = Add(s[2], c);
+    s[3] = Add(s[3], d);
+    s[4] = Add(s[4], e);
+    s[5] = Add(s[5], f);
+    s[6] = Add(s[6], g);
+    s[7] = Add(s[7], h);
+}
+
+/** One transform of s with the message words w, whose schedule is expanded in place as the rounds go */
+void inline Transform(__m256i* s, __m256i* w)
+{
+    Rounds(s, [w](int i) {
+        if (i >= 16) {
+            w[i & 15] = Add(w[i & 15], sigma1(w[(i - 2) & 15]), w[(i - 7) & 15], sigma0(w[(i - 15) & 15]));
+        }
+        return Add(w[i & 15], K(K256[i]));
+    });
+}
+
+void inline Initialize(__m256i* s)
+{
+    for (int i = 0; i < 8; i++) {
+        s[i] = K(INIT[i]);
+    }
+}
+
+}
+
+/** Double SHA-256 of the eight 64-byte inputs at in, to the eight 32-byte outputs at out, which may overlap in */
+void TransformD64_8way(unsigned char* out, const unsigned char* in)
+{
+    static const PaddingSchedule padding;
+    __m256i s[8], w[16];
+
+    // Lane j hashes the input at in + 64 * j
+    for (int i = 0; i < 16; i++) {
+        const unsigned char* p = in + 4 * i;
+        w[i] = _mm256_setr_epi32(ReadBE32(p), ReadBE32(p + 64), ReadBE32(p + 128), ReadBE32(p + 192),
+                                 ReadBE32(p + 256), ReadBE32(p + 320), ReadBE32(p + 384), ReadBE32(p + 448));
+    }
+    Initialize(s);
+    Transform(s, w);
+    Rounds(s, [](int i) { return K(padding.wk[i]); });
+
+    // Hash the 32-byte digest, padded
+    for (int i = 0; i < 8; i++) {
+        w[i] = s[i];
+    }
+    w[8] = K(0x80000000);
+    for (int i = 9; i < 15; i++) {
+        w[i] = _mm256_setzero_si256();
+    }
+    w[15] = K(256);
+    Initialize(s);
+    Transform(s, w);
+
+    uint32_t words[8][8];
+    for (int i = 0; i < 8; i++) {
+        _mm256_storeu_si256((__m256i*)words[i], s[i]);
+    }
+    for (int j = 0; j < 8; j++) {
+        for (int i = 0; i < 8; i++) {
+            WriteBE32(out + 32 * j + 4 * i, words[i][j]);
+        }
+    }
+}
+
+}
+
+#endif
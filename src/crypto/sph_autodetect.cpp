@@ -0,0 +1,170 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#if defined(HAVE_CONFIG_H)
+#include "config/bitcoin-config.h"
+#endif
+
+#include "crypto/sph_autodetect.h"
+#include "crypto/Lyra2.h"
+#include "crypto/sph_cubehash.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+namespace cubehash_sse2
+{
+void Rounds(uint32_t* state, unsigned n);
+}
+#endif
+
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+#include <cpuid.h>
+namespace cubehash_avx2
+{
+void Rounds(uint32_t* state, unsigned n);
+}
+namespace lyra2_avx2
+{
+void AbsorbBlock(uint64_t* state, const uint64_t* in);
+void AbsorbBlockBlake2Safe(uint64_t* state, const uint64_t* in);
+void Squeeze(uint64_t* state, unsigned char* out, unsigned int len);
+void ReducedSqueezeRow0(uint64_t* state, uint64_t* rowOut, uint64_t nCols);
+void ReducedDuplexRow1(uint64_t* state, uint64_t* rowIn, uint64_t* rowOut, uint64_t nCols);
+void ReducedDuplexRowSetup(uint64_t* state, uint64_t* rowIn, uint64_t* rowInOut, uint64_t* rowOut, uint64_t nCols);
+void ReducedDuplexRow(uint64_t* state, uint64_t* rowIn, uint64_t* rowInOut, uint64_t* rowOut, uint64_t nCols);
+int Lyra2_4way(void* const* K, uint64_t kLen, const void* const* pwd, uint64_t pwdlen, const void* const* salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols, uint64_t* wholeMatrix);
+
+const lyra2_impl impl = {
+    AbsorbBlock,
+    AbsorbBlockBlake2Safe,
+    Squeeze,
+    ReducedSqueezeRow0,
+    ReducedDuplexRow1,
+    ReducedDuplexRowSetup,
+    ReducedDuplexRow,
+    Lyra2_4way
+};
+}
+#endif
+
+namespace {
+
+/** Checks a round function against the portable one, for one and for several groups of sixteen rounds */
+bool SelfTest(sph_cubehash_rounds_fn rounds)
+{
+    for (unsigned n = 1; n <= 10; n += 9) {
+        uint32_t state[32], expected[32];
+        uint32_t x = n;
+        for (uint32_t& word : state) {
+            x = x * 1103515245 + 12345;
+            word = x ^ (x >> 16);
+        }
+        memcpy(expected, state, sizeof(state));
+        sph_cubehash_rounds_generic(expected, n);
+        rounds(state, n);
+        if (memcmp(state, expected, sizeof(state)) != 0) return false;
+    }
+    return true;
+}
+
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+/**
+ * Checks a Lyra2 implementation against the portable one, with the parameters of lyra2re2 and lyra2re and with keys
+ * of several squeezed blocks, on LYRA2_LANES different inputs. Leaves the implementation selected if it passes.
+ */
+bool SelfTest(const lyra2_impl* impl)
+{
+    static const uint64_t params[][4] = {{32, 1, 4, 4}, {32, 1, 8, 8}, {200, 1, 5, 3}};
+    for (const uint64_t* p : params) {
+        const uint64_t kLen = p[0], timeCost = p[1], nRows = p[2], nCols = p[3];
+        unsigned char pwd[LYRA2_LANES][40], expected[LYRA2_LANES][200] = {}, key[LYRA2_LANES][200] = {}, lanes[LYRA2_LANES][200] = {};
+        uint64_t matrix[LYRA2_LANES * LYRA2_MATRIX_INT64(8, 8)];
+        void* keys[LYRA2_LANES];
+        const void* pwds[LYRA2_LANES];
+        uint32_t x = kLen + nRows;
+        for (int l = 0; l < LYRA2_LANES; l++) {
+            for (unsigned char& c : pwd[l]) {
+                x = x * 1103515245 + 12345;
+                c = x >> 16;
+            }
+            keys[l] = lanes[l];
+            pwds[l] = pwd[l];
+        }
+        LYRA2_set_impl(nullptr);
+        for (int l = 0; l < LYRA2_LANES; l++) {
+            LYRA2_scratch(expected[l], kLen, pwd[l], 40, pwd[l], 32, timeCost, nRows, nCols, matrix);
+        }
+        LYRA2_set_impl(impl);
+        for (int l = 0; l < LYRA2_LANES; l++) {
+            LYRA2_scratch(key[l], kLen, pwd[l], 40, pwd[l], 32, timeCost, nRows, nCols, matrix);
+        }
+        LYRA2_4way(keys, kLen, pwds, 40, pwds, 32, timeCost, nRows, nCols, matrix);
+        if (memcmp(key, expected, sizeof(key)) != 0 || memcmp(lanes, expected, sizeof(lanes)) != 0) {
+            LYRA2_set_impl(nullptr);
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Whether the OS saves the AVX registers on context switches */
+bool AVXEnabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+#endif
+
+}
+
+std::string CubeHashAutoDetect()
+{
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+    uint32_t eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && ((ecx >> 27) & 1) && AVXEnabled() && __get_cpuid_max(0, nullptr) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        if ((ebx >> 5) & 1) {
+            if (SelfTest(cubehash_avx2::Rounds)) {
+                sph_cubehash_set_rounds(cubehash_avx2::Rounds);
+                return "avx2";
+            }
+            sph_cubehash_set_rounds(nullptr);
+            return "standard, the avx2 implementation failed its self-test";
+        }
+    }
+#endif
+
+#if defined(__SSE2__)
+    if (SelfTest(cubehash_sse2::Rounds)) {
+        sph_cubehash_set_rounds(cubehash_sse2::Rounds);
+        return "sse2";
+    }
+    sph_cubehash_set_rounds(nullptr);
+    return "standard, the sse2 implementation failed its self-test";
+#else
+    sph_cubehash_set_rounds(nullptr);
+    return "standard";
+#endif
+}
+
+std::string Lyra2AutoDetect()
+{
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+    uint32_t eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && ((ecx >> 27) & 1) && AVXEnabled() && __get_cpuid_max(0, nullptr) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        if ((ebx >> 5) & 1) {
+            if (SelfTest(&lyra2_avx2::impl))
+                return "avx2";
+            LYRA2_set_impl(nullptr);
+            return "standard, the avx2 implementation failed its self-test";
+        }
+    }
+#endif
+
+    LYRA2_set_impl(nullptr);
+    return "standard";
+}
@@ -0,0 +1,22 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_CRYPTO_SPH_AUTODETECT_H
+#define BITCOIN_CRYPTO_SPH_AUTODETECT_H
+
+#include <string>
+
+/**
+ * Autodetect the best available round function for the CubeHash of the sph library, which dominates the cost of
+ * lyra2re2, and select it after checking it against the portable code. Returns the name of the implementation.
+ */
+std::string CubeHashAutoDetect();
+
+/**
+ * Autodetect the best available implementation of the Lyra2 sponge and of LYRA2_4way, and select it after checking
+ * it against the portable code. Returns the name of the implementation.
+ */
+std::string Lyra2AutoDetect();
+
+#endif // BITCOIN_CRYPTO_SPH_AUTODETECT_H
@@ -39,6 +39,10 @@
 #include <stddef.h>
 #include "sph_types.h"
 
+#ifdef __cplusplus
+extern "C"{
+#endif
+
 /**
  * Output size (in bits) for BMW-224.
  */
@@ -317,5 +321,9 @@ void sph_bmw512_addbits_and_close(
 
 #endif
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
 
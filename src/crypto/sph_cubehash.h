@@ -40,6 +40,10 @@
 #include <stddef.h>
 #include "sph_types.h"
 
+#ifdef __cplusplus
+extern "C"{
+#endif
+
 /**
  * Output size (in bits) for CubeHash-224.
  */
@@ -282,5 +286,34 @@ void sph_cubehash512_close(void *cc, void *dst);
 void sph_cubehash512_addbits_and_close(
 	void *cc, unsigned ub, unsigned n, void *dst);
 
+/**
+ * Type for an implementation of the CubeHash round function: it applies
+ * <code>n</code> times sixteen rounds to the 32-word state.
+ */
+typedef void (*sph_cubehash_rounds_fn)(sph_u32 *state, unsigned n);
+
+/**
+ * Apply <code>n</code> times sixteen CubeHash rounds to the state, with
+ * the portable code of this file.
+ *
+ * @param state   the 32-word state
+ * @param n       the number of sixteen round groups
+ */
+void sph_cubehash_rounds_generic(sph_u32 *state, unsigned n);
+
+/**
+ * Select the round function used by all CubeHash contexts, e.g. a vector
+ * implementation chosen at runtime; <code>NULL</code> restores the
+ * portable code. This must be done before any hashing starts, as the
+ * selection is not synchronized.
+ *
+ * @param fn   the round function, or <code>NULL</code>
+ */
+void sph_cubehash_set_rounds(sph_cubehash_rounds_fn fn);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
 
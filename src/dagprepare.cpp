@@ -0,0 +1,144 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dagprepare.h"
+
+#include "chain.h"
+#include "crypto/dag.h"
+#include "dagstore.h"
+#include "util.h"
+#include "utiltime.h"
+#include "validation.h"
+#include "validationinterface.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+/** Forwards new tips to the preparation thread */
+class CDAGPrepareNotifier : public CValidationInterface
+{
+protected:
+    void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
+};
+
+std::mutex cs_dagprepare;
+std::condition_variable cond_dagprepare;
+/** Height of the latest DAG tip not yet looked at by the thread, -1 if none */
+int nPendingHeight = -1;
+/** Whether DAG tables were queued for writing or the tip moved since the thread last flushed them */
+bool fFlushTables = false;
+bool fDAGPrepareInterrupted = false;
+int nPrepareDistance = DEFAULT_DAG_PREPARE_DISTANCE;
+std::thread threadDAGPrepare;
+std::unique_ptr<CDAGPrepareNotifier> pDAGPrepareNotifier;
+
+void CDAGPrepareNotifier::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload)
+{
+    // The epochs around the tip stay resident whatever headers far from it are checked.
+    CDAGSystem::SetTipEpoch(CDAGSystem::GetEpoch(pindexNew->nHeight));
+    std::lock_guard<std::mutex> lock(cs_dagprepare);
+    fFlushTables = true;
+    if (nPrepareDistance > 0 && (pindexNew->nVersion & 0x00000100))
+        nPendingHeight = pindexNew->nHeight;
+    cond_dagprepare.notify_one();
+}
+
+void ThreadDAGPrepare()
+{
+    int64_t nPreparedEpoch = -1;
+    bool fPreparedGraph = false;
+    while (true) {
+        int nHeight;
+        bool fFlush;
+        {
+            std::unique_lock<std::mutex> lock(cs_dagprepare);
+            cond_dagprepare.wait(lock, [] { return fDAGPrepareInterrupted || nPendingHeight >= 0 || fFlushTables; });
+            if (fDAGPrepareInterrupted)
+                return;
+            nHeight = nPendingHeight;
+            nPendingHeight = -1;
+            fFlush = fFlushTables;
+            fFlushTables = false;
+        }
+
+        // Persist the tables header checks generated, off the validation path
+        if (fFlush)
+            FlushDAGStore();
+        if (nHeight < 0)
+            continue;
+
+        uint64_t epoch = CDAGSystem::GetEpoch(nHeight);
+        uint64_t nextEpoch = CDAGSystem::GetEpoch(nHeight + nPrepareDistance);
+        if (nextEpoch == epoch)
+            continue;
+        // Only spend memory on the next graph if this node already uses one for the current epoch.
+        bool fGraph = CDAGSystem::HasGraph(epoch);
+        if ((int64_t)nextEpoch == nPreparedEpoch && (fPreparedGraph || !fGraph))
+            continue;
+
+        LogPrintf("Preparing DAG %s for epoch %u at height %d\n", fGraph ? "cache and graph" : "cache", nextEpoch, nHeight);
+        int64_t nStart = GetTimeMillis();
+        if (!CDAGSystem::PrepareEpoch(nextEpoch, fGraph))
+            continue;
+        nPreparedEpoch = nextEpoch;
+        fPreparedGraph = fGraph;
+        LogPrintf("Prepared DAG for epoch %u in %dms\n", nextEpoch, GetTimeMillis() - nStart);
+    }
+}
+
+} // namespace
+
+void NotifyDAGTablesPending()
+{
+    std::lock_guard<std::mutex> lock(cs_dagprepare);
+    fFlushTables = true;
+    cond_dagprepare.notify_one();
+}
+
+void StartDAGPrepare()
+{
+    nPrepareDistance = gArgs.GetArg("-dagprepare", DEFAULT_DAG_PREPARE_DISTANCE);
+    assert(!pDAGPrepareNotifier);
+    fDAGPrepareInterrupted = false;
+    {
+        LOCK(cs_main);
+        // Catch up on the tip we start with, later tips arrive through the validation interface.
+        if (chainActive.Tip()) {
+            CDAGSystem::SetTipEpoch(CDAGSystem::GetEpoch(chainActive.Height()));
+            if (chainActive.Tip()->nVersion & 0x00000100)
+                nPendingHeight = chainActive.Height();
+        }
+    }
+    if (nPrepareDistance <= 0)
+        LogPrintf("DAG preparation disabled\n");
+    // The thread also persists DAG tables, so it runs even if preparation is disabled.
+    NotifyDAGTablesPending();
+    threadDAGPrepare = std::thread(&TraceThread<void (*)()>, "dagprepare", &ThreadDAGPrepare);
+    pDAGPrepareNotifier.reset(new CDAGPrepareNotifier());
+    RegisterValidationInterface(pDAGPrepareNotifier.get());
+}
+
+void InterruptDAGPrepare()
+{
+    std::lock_guard<std::mutex> lock(cs_dagprepare);
+    fDAGPrepareInterrupted = true;
+    cond_dagprepare.notify_all();
+}
+
+void StopDAGPrepare()
+{
+    if (pDAGPrepareNotifier) {
+        UnregisterValidationInterface(pDAGPrepareNotifier.get());
+        pDAGPrepareNotifier.reset();
+    }
+    if (threadDAGPrepare.joinable()) {
+        threadDAGPrepare.join();
+        // Write whatever was queued after the thread stopped
+        FlushDAGStore();
+    }
+}
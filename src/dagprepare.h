@@ -0,0 +1,26 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Background generation of the next epoch's DAG data.
+ */
+#ifndef BITCOIN_DAGPREPARE_H
+#define BITCOIN_DAGPREPARE_H
+
+/** Default for -dagprepare, the number of blocks before an epoch boundary at which the next epoch is built */
+static const int DEFAULT_DAG_PREPARE_DISTANCE = 50;
+
+/**
+ * Start following the active tip's DAG epoch, and a thread that keeps the DAG cache (and the
+ * graph, if this node has built one for the current epoch) of the epoch following the active
+ * tip ready before it is needed.
+ */
+void StartDAGPrepare();
+void InterruptDAGPrepare();
+void StopDAGPrepare();
+
+/** Wake the DAG preparation thread to write and check the DAG tables queued for it, see FlushDAGStore */
+void NotifyDAGTablesPending();
+
+#endif // BITCOIN_DAGPREPARE_H
@@ -0,0 +1,318 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dagstore.h"
+
+#include "crypto/sha256.h"
+#include "dagprepare.h"
+#include "util.h"
+#include "utiltime.h"
+
+#include <memory>
+#include <mutex>
+#include <string.h>
+#include <vector>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+/** On-disk header preceding the words of a persisted CDAGTable */
+struct DAGFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t type;
+    uint64_t epoch;
+    uint64_t bytes;
+    uint8_t seed[32];
+    uint8_t checksum[CSHA256::OUTPUT_SIZE];
+    uint8_t padding[32];
+};
+static_assert(sizeof(DAGFileHeader) == 128, "DAG file header must keep the data 128 byte aligned");
+const char DAG_FILE_MAGIC[8] = {'C', 'H', 'N', 'C', 'D', 'A', 'G', '\0'};
+
+void ChecksumWords(const uint32_t* data, uint64_t words, uint8_t* out)
+{
+    CSHA256().Write((const unsigned char*)data, words * sizeof(uint32_t)).Finalize(out);
+}
+
+bool ReadHeader(const fs::path& path, DAGFileHeader& header)
+{
+    FILE* file = fsbridge::fopen(path, "rb");
+    if (!file)
+        return false;
+    bool fRead = fread(&header, sizeof(header), 1, file) == 1;
+    fclose(file);
+    return fRead;
+}
+
+const char* TableName(CDAGTable::Type type)
+{
+    return type == CDAGTable::GRAPH ? "graph" : "cache";
+}
+
+/** Whether epoch is the tip's, the one before it or the one after it */
+bool IsTipWindowEpoch(uint64_t epoch, uint64_t tipEpoch)
+{
+    return epoch + 1 >= tipEpoch && epoch <= tipEpoch + 1;
+}
+
+/** A generated table waiting to be written by FlushDAGStore */
+struct PendingTable {
+    CDAGTable::Type type;
+    uint64_t epoch;
+    std::array<uint8_t, 32> seed;
+    std::shared_ptr<const CDAGTable> table;
+};
+
+std::mutex cs_dagstore;
+/** Directory the tables are persisted in, empty if persistence is disabled */
+fs::path pathDAGStore;
+std::vector<PendingTable> vPendingWrites;
+/** Mapped graphs, only held weakly so that checking them never keeps an evicted graph alive */
+std::vector<std::pair<uint64_t, std::weak_ptr<const CDAGTable>>> vPendingChecks;
+/** Tip epoch the files were last pruned for */
+uint64_t nPrunedEpoch = CDAGSystem::NO_EPOCH;
+
+fs::path GetTablePath(const fs::path& dir, CDAGTable::Type type, uint64_t epoch)
+{
+    return dir / strprintf("%s-%u.dat", TableName(type), epoch);
+}
+
+std::shared_ptr<const CDAGTable> LoadTable(CDAGTable::Type type, uint64_t epoch, const std::array<uint8_t, 32>& seed, uint64_t nBytes)
+{
+    fs::path path;
+    {
+        std::lock_guard<std::mutex> lock(cs_dagstore);
+        if (pathDAGStore.empty())
+            return nullptr;
+        path = GetTablePath(pathDAGStore, type, epoch);
+    }
+    int64_t nStart = GetTimeMillis();
+    std::shared_ptr<CDAGTable> table = std::make_shared<CDAGTable>();
+    if (!LoadDAGTable(path, type, epoch, seed, nBytes, *table))
+        return nullptr;
+    LogPrintf("Loaded DAG %s for epoch %u from disk in %dms\n", TableName(type), epoch, GetTimeMillis() - nStart);
+    if (type == CDAGTable::GRAPH) {
+        {
+            std::lock_guard<std::mutex> lock(cs_dagstore);
+            vPendingChecks.emplace_back(epoch, table);
+        }
+        NotifyDAGTablesPending();
+    }
+    return table;
+}
+
+void SaveTable(CDAGTable::Type type, uint64_t epoch, const std::array<uint8_t, 32>& seed, std::shared_ptr<const CDAGTable> table)
+{
+    {
+        std::lock_guard<std::mutex> lock(cs_dagstore);
+        if (pathDAGStore.empty())
+            return;
+        vPendingWrites.push_back(PendingTable{type, epoch, seed, std::move(table)});
+    }
+    // Writing is left to a background thread, so that checking a header never waits for the disk.
+    NotifyDAGTablesPending();
+}
+
+/** Removes the files of epochs outside of the tip's window, and the temporary files of interrupted writes */
+void PruneTables(const fs::path& dir, uint64_t tipEpoch)
+{
+    try {
+        for (fs::directory_iterator it(dir); it != fs::directory_iterator(); ++it) {
+            const std::string name = it->path().filename().string();
+            // Both prefixes, "cache-" and "graph-", are 6 characters long
+            bool fTable = name.compare(0, 6, "cache-") == 0 || name.compare(0, 6, "graph-") == 0;
+            if (!fTable)
+                continue;
+            if (it->path().extension() == ".new") {
+                LogPrintf("Removing incomplete DAG file %s\n", name);
+                fs::remove(it->path());
+                continue;
+            }
+            if (it->path().extension() != ".dat")
+                continue;
+            uint64_t fileEpoch = strtoull(name.c_str() + 6, nullptr, 10);
+            if (tipEpoch != CDAGSystem::NO_EPOCH && !IsTipWindowEpoch(fileEpoch, tipEpoch)) {
+                LogPrintf("Removing stale DAG file %s\n", name);
+                fs::remove(it->path());
+            }
+        }
+    } catch (const fs::filesystem_error& e) {
+        LogPrintf("Unable to prune DAG files: %s\n", e.what());
+    }
+}
+
+} // namespace
+
+bool LoadDAGTable(const fs::path& path, CDAGTable::Type type, uint64_t epoch, const std::array<uint8_t, 32>& seed, uint64_t nBytes, CDAGTable& table)
+{
+    DAGFileHeader header;
+    FILE* file = fsbridge::fopen(path, "rb");
+    if (!file)
+        return false;
+    bool fHeader = fread(&header, sizeof(header), 1, file) == 1;
+    if (!fHeader || memcmp(header.magic, DAG_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != DAG_FILE_VERSION ||
+        header.type != type || header.epoch != epoch || header.bytes != nBytes || memcmp(header.seed, seed.data(), seed.size()) != 0) {
+        fclose(file);
+        LogPrintf("DAG file %s does not match epoch %u, ignoring it\n", path.string(), epoch);
+        return false;
+    }
+    const uint64_t words = nBytes / sizeof(uint32_t);
+#ifndef WIN32
+    // Map the whole file read-only and shared, so other processes mapping the same epoch share its pages. They are
+    // only read in as hashing touches them.
+    size_t nSize = sizeof(header) + nBytes;
+    struct stat st;
+    if (fstat(fileno(file), &st) != 0 || (uint64_t)st.st_size != nSize) {
+        fclose(file);
+        LogPrintf("DAG file %s is truncated, ignoring it\n", path.string());
+        return false;
+    }
+    void* mapping = mmap(nullptr, nSize, PROT_READ, MAP_SHARED, fileno(file), 0);
+    fclose(file);
+    if (mapping == MAP_FAILED) {
+        LogPrintf("Unable to map DAG file %s\n", path.string());
+        return false;
+    }
+    std::shared_ptr<const void> owner(mapping, [nSize](const void* p) { munmap(const_cast<void*>(p), nSize); });
+    CDAGTable loaded((const uint32_t*)((const char*)mapping + sizeof(header)), words, std::move(owner));
+#else
+    std::vector<uint32_t> vRead(words);
+    bool fRead = fread(vRead.data(), sizeof(uint32_t), words, file) == words;
+    fclose(file);
+    if (!fRead) {
+        LogPrintf("DAG file %s is truncated, ignoring it\n", path.string());
+        return false;
+    }
+    CDAGTable loaded(std::move(vRead));
+#endif
+    // A cache is small and every header check reads it, so it is checked right away
+    if (type == CDAGTable::CACHE) {
+        uint8_t checksum[CSHA256::OUTPUT_SIZE];
+        ChecksumWords(loaded.data(), loaded.size(), checksum);
+        if (memcmp(checksum, header.checksum, sizeof(checksum)) != 0) {
+            LogPrintf("DAG file %s is corrupt, ignoring it\n", path.string());
+            return false;
+        }
+    }
+    table = std::move(loaded);
+    return true;
+}
+
+bool WriteDAGTable(const fs::path& path, CDAGTable::Type type, uint64_t epoch, const std::array<uint8_t, 32>& seed, const CDAGTable& table)
+{
+    DAGFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DAG_FILE_MAGIC, sizeof(header.magic));
+    header.version = DAG_FILE_VERSION;
+    header.type = type;
+    header.epoch = epoch;
+    header.bytes = table.size() * sizeof(uint32_t);
+    memcpy(header.seed, seed.data(), seed.size());
+    ChecksumWords(table.data(), table.size(), header.checksum);
+
+    // Write to a temporary file and rename it over the target, so readers never map a partial file.
+    fs::path pathTmp = path;
+    pathTmp += ".new";
+    FILE* file = fsbridge::fopen(pathTmp, "wb");
+    if (!file)
+        return false;
+    bool fOk = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(table.data(), sizeof(uint32_t), table.size(), file) == table.size();
+    if (fOk)
+        FileCommit(file);
+    fclose(file);
+    if (!fOk || !RenameOver(pathTmp, path)) {
+        fs::remove(pathTmp);
+        return false;
+    }
+    return true;
+}
+
+bool VerifyDAGTable(const fs::path& path, const CDAGTable& table)
+{
+    DAGFileHeader header;
+    if (!ReadHeader(path, header) || header.bytes != table.size() * sizeof(uint32_t))
+        return false;
+    uint8_t checksum[CSHA256::OUTPUT_SIZE];
+    ChecksumWords(table.data(), table.size(), checksum);
+    return memcmp(checksum, header.checksum, sizeof(checksum)) == 0;
+}
+
+void SetDAGStoreDir(const fs::path& path)
+{
+    fs::path dir = path;
+    if (!dir.empty()) {
+        try {
+            fs::create_directories(dir);
+        } catch (const fs::filesystem_error& e) {
+            LogPrintf("Unable to create DAG directory %s, not persisting DAG data: %s\n", dir.string(), e.what());
+            dir.clear();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(cs_dagstore);
+        pathDAGStore = dir;
+        vPendingWrites.clear();
+        vPendingChecks.clear();
+        nPrunedEpoch = CDAGSystem::NO_EPOCH;
+    }
+    CDAGSystem::LoadTable = dir.empty() ? nullptr : LoadTable;
+    CDAGSystem::SaveTable = dir.empty() ? nullptr : SaveTable;
+}
+
+void FlushDAGStore()
+{
+    fs::path dir;
+    std::vector<PendingTable> vWrites;
+    std::vector<std::pair<uint64_t, std::weak_ptr<const CDAGTable>>> vChecks;
+    const uint64_t tipEpoch = CDAGSystem::GetTipEpoch();
+    bool fPrune;
+    {
+        std::lock_guard<std::mutex> lock(cs_dagstore);
+        if (pathDAGStore.empty())
+            return;
+        dir = pathDAGStore;
+        vWrites.swap(vPendingWrites);
+        vChecks.swap(vPendingChecks);
+        fPrune = tipEpoch != nPrunedEpoch;
+        nPrunedEpoch = tipEpoch;
+    }
+
+    for (const PendingTable& pending : vWrites) {
+        // Until the tip is known every table is kept, as any of them may turn out to be in its window.
+        if (tipEpoch != CDAGSystem::NO_EPOCH && !IsTipWindowEpoch(pending.epoch, tipEpoch))
+            continue;
+        int64_t nStart = GetTimeMillis();
+        if (!WriteDAGTable(GetTablePath(dir, pending.type, pending.epoch), pending.type, pending.epoch, pending.seed, *pending.table)) {
+            LogPrintf("Unable to write DAG %s for epoch %u to %s\n", TableName(pending.type), pending.epoch, dir.string());
+            continue;
+        }
+        LogPrintf("Wrote DAG %s for epoch %u to disk in %dms\n", TableName(pending.type), pending.epoch, GetTimeMillis() - nStart);
+    }
+
+    // Only miners use graphs, and the blocks they find are checked against the cache, so a corrupt graph can
+    // go unnoticed for the little while it takes to get here.
+    for (const auto& check : vChecks) {
+        std::shared_ptr<const CDAGTable> table = check.second.lock();
+        if (!table)
+            continue;
+        const fs::path path = GetTablePath(dir, CDAGTable::GRAPH, check.first);
+        if (VerifyDAGTable(path, *table))
+            continue;
+        LogPrintf("DAG file %s is corrupt, removing it\n", path.string());
+        CDAGSystem::DropGraph(check.first);
+        try {
+            fs::remove(path);
+        } catch (const fs::filesystem_error& e) {
+            LogPrintf("Unable to remove DAG file %s: %s\n", path.string(), e.what());
+        }
+    }
+
+    if (fPrune)
+        PruneTables(dir, tipEpoch);
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Persistence of DAG caches and graphs in the data directory, so that a restarted node maps them back instead of
+ * generating them again.
+ */
+#ifndef BITCOIN_DAGSTORE_H
+#define BITCOIN_DAGSTORE_H
+
+#include "crypto/dag.h"
+#include "fs.h"
+
+#include <array>
+#include <stdint.h>
+
+/** Default for -dagpersist */
+static const bool DEFAULT_DAG_PERSIST = true;
+/** Version of the file format written by WriteDAGTable */
+static const uint32_t DAG_FILE_VERSION = 1;
+
+/**
+ * Maps a file previously written by WriteDAGTable into table. Returns false, leaving the table untouched, if the
+ * file is missing, truncated or was written for another epoch, seed or size. Only caches are checked against their
+ * checksum here, as checking a graph would read all of it. See VerifyDAGTable.
+ */
+bool LoadDAGTable(const fs::path& path, CDAGTable::Type type, uint64_t epoch, const std::array<uint8_t, 32>& seed, uint64_t nBytes, CDAGTable& table);
+/** Atomically writes table, preceded by a versioned and checksummed header, to path */
+bool WriteDAGTable(const fs::path& path, CDAGTable::Type type, uint64_t epoch, const std::array<uint8_t, 32>& seed, const CDAGTable& table);
+/** Returns whether table matches the checksum in the header of the file at path */
+bool VerifyDAGTable(const fs::path& path, const CDAGTable& table);
+
+/**
+ * Persist DAG caches and graphs to files in path and have CDAGSystem map them back from there instead of generating
+ * them. An empty path disables persistence.
+ */
+void SetDAGStoreDir(const fs::path& path);
+/**
+ * Writes the tables generated since the last call that still belong to the active tip's window, checks the graphs
+ * mapped since against their checksums and removes the files of epochs that left the window. Writing and checking
+ * a graph take a while, so this is called by the DAG preparation thread.
+ */
+void FlushDAGStore();
+
+#endif // BITCOIN_DAGSTORE_H
@@ -14,6 +14,9 @@
 #include <memenv.h>
 #include <stdint.h>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <sstream>
 
 class CBitcoinLevelDBLogger : public leveldb::Logger {
 public:
@@ -73,14 +76,57 @@ public:
     }
 };
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+/** LRU block cache which counts lookups and hits, for getdbstats */
+class CCountingCache : public leveldb::Cache {
+private:
+    std::unique_ptr<leveldb::Cache> cache;
+    std::atomic<uint64_t> nLookups;
+    std::atomic<uint64_t> nHits;
+
+public:
+    explicit CCountingCache(size_t nCapacity) : cache(leveldb::NewLRUCache(nCapacity)), nLookups(0), nHits(0) {}
+
+    Handle* Insert(const leveldb::Slice& key, void* value, size_t charge, void (*deleter)(const leveldb::Slice& key, void* value)) override
+    {
+        return cache->Insert(key, value, charge, deleter);
+    }
+
+    Handle* Lookup(const leveldb::Slice& key) override
+    {
+        Handle* handle = cache->Lookup(key);
+        nLookups++;
+        if (handle) nHits++;
+        return handle;
+    }
+
+    void Release(Handle* handle) override { cache->Release(handle); }
+    void* Value(Handle* handle) override { return cache->Value(handle); }
+    void Erase(const leveldb::Slice& key) override { cache->Erase(key); }
+    uint64_t NewId() override { return cache->NewId(); }
+    void Prune() override { cache->Prune(); }
+    size_t TotalCharge() const override { return cache->TotalCharge(); }
+
+    uint64_t GetLookups() const { return nLookups; }
+    uint64_t GetHits() const { return nHits; }
+};
+
+static leveldb::Options GetOptions(size_t nCacheSize, const CDBOptions& dbopts, leveldb::Cache* pcache)
 {
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
+    options.block_cache = pcache;
+    options.block_size = dbopts.nBlockSize;
+    // up to two write buffers may be held in memory simultaneously
+    options.write_buffer_size = dbopts.nWriteBufferSize ? dbopts.nWriteBufferSize : nCacheSize / 4;
+    options.filter_policy = dbopts.nBloomBits > 0 ? leveldb::NewBloomFilterPolicy(dbopts.nBloomBits) : nullptr;
     options.compression = leveldb::kNoCompression;
-    options.max_open_files = 64;
+    if (dbopts.fCompression) {
+#ifdef HAVE_SNAPPY
+        options.compression = leveldb::kSnappyCompression;
+#else
+        LogPrintf("Warning: LevelDB compression requested, but built without Snappy; not compressing\n");
+#endif
+    }
+    options.max_open_files = dbopts.nMaxOpenFiles;
     options.info_log = new CBitcoinLevelDBLogger();
     if (leveldb::kMajorVersion > 1 || (leveldb::kMajorVersion == 1 && leveldb::kMinorVersion >= 16)) {
         // LevelDB versions before 1.16 consider short writes to be corruption. Only trigger error
@@ -90,14 +136,15 @@ static leveldb::Options GetOptions(size_t nCacheSize)
     return options;
 }
 
-CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate)
+CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate, const CDBOptions& dbopts) : dboptions(dbopts)
 {
     penv = nullptr;
     readoptions.verify_checksums = true;
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
-    options = GetOptions(nCacheSize);
+    pcache = new CCountingCache(nCacheSize / 2);
+    options = GetOptions(nCacheSize, dboptions, pcache);
     options.create_if_missing = true;
     if (fMemory) {
         penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -149,7 +196,8 @@ CDBWrapper::~CDBWrapper()
     options.filter_policy = nullptr;
     delete options.info_log;
     options.info_log = nullptr;
-    delete options.block_cache;
+    delete pcache;
+    pcache = nullptr;
     options.block_cache = nullptr;
     delete penv;
     options.env = nullptr;
@@ -189,6 +237,58 @@ bool CDBWrapper::IsEmpty()
     return !(it->Valid());
 }
 
+bool CDBWrapper::GetProperty(const std::string& name, std::string& value) const
+{
+    return pdb->GetProperty(name, &value);
+}
+
+void CDBWrapper::GetCacheStats(uint64_t& nLookups, uint64_t& nHits) const
+{
+    nLookups = pcache->GetLookups();
+    nHits = pcache->GetHits();
+}
+
+std::vector<CDBLevelStats> CDBWrapper::GetLevelStats() const
+{
+    std::vector<CDBLevelStats> levels;
+    std::string value;
+    while (GetProperty(strprintf("leveldb.num-files-at-level%u", levels.size()), value)) {
+        levels.emplace_back();
+        levels.back().nFiles = atoi(value);
+    }
+
+    // Lines of "leveldb.sstables" are "--- level <n> ---", followed by " <file number>:<bytes>[<key range>]" for each file
+    if (GetProperty("leveldb.sstables", value)) {
+        std::istringstream stream(value);
+        std::string line;
+        int level = -1;
+        while (std::getline(stream, line)) {
+            unsigned long long number, bytes;
+            if (sscanf(line.c_str(), "--- level %d ---", &level) == 1) continue;
+            if (level >= 0 && level < (int)levels.size() && sscanf(line.c_str(), " %llu:%llu[", &number, &bytes) == 2) {
+                levels[level].nBytes += bytes;
+            }
+        }
+    }
+
+    // "leveldb.stats" has a line "<level> <files> <MB> <compaction seconds> <MB read> <MB written>" for each level in use
+    if (GetProperty("leveldb.stats", value)) {
+        std::istringstream stream(value);
+        std::string line;
+        while (std::getline(stream, line)) {
+            int level, files;
+            double size, time, read, write;
+            if (sscanf(line.c_str(), "%d %d %lf %lf %lf %lf", &level, &files, &size, &time, &read, &write) == 6 &&
+                level >= 0 && level < (int)levels.size()) {
+                levels[level].dCompactionTime = time;
+                levels[level].dCompactionRead = read;
+                levels[level].dCompactionWrite = write;
+            }
+        }
+    }
+    return levels;
+}
+
 CDBIterator::~CDBIterator() { delete piter; }
 bool CDBIterator::Valid() { return piter->Valid(); }
 void CDBIterator::SeekToFirst() { piter->SeekToFirst(); }
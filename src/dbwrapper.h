@@ -19,6 +19,43 @@
 static const size_t DBWRAPPER_PREALLOC_KEY_SIZE = 64;
 static const size_t DBWRAPPER_PREALLOC_VALUE_SIZE = 1024;
 
+//! Default maximum number of open files per database
+static const int DEFAULT_DB_MAX_OPEN_FILES = 64;
+//! Default uncompressed size of a table block (bytes)
+static const int DEFAULT_DB_BLOCK_SIZE = 4096;
+//! Default bloom filter bits per key
+static const int DEFAULT_DB_BLOOM_BITS = 10;
+//! Default for compressing table blocks with Snappy
+static const bool DEFAULT_DB_COMPRESSION = false;
+
+/** LevelDB tunables of a CDBWrapper, besides its cache size */
+struct CDBOptions
+{
+    int nMaxOpenFiles;
+    size_t nBlockSize;
+    //! Size of the memtable, or 0 for a quarter of the cache size
+    size_t nWriteBufferSize;
+    //! Bloom filter bits per key, or 0 for no bloom filter
+    int nBloomBits;
+    bool fCompression;
+
+    CDBOptions() : nMaxOpenFiles(DEFAULT_DB_MAX_OPEN_FILES), nBlockSize(DEFAULT_DB_BLOCK_SIZE), nWriteBufferSize(0),
+        nBloomBits(DEFAULT_DB_BLOOM_BITS), fCompression(DEFAULT_DB_COMPRESSION) {}
+};
+
+/** Statistics of one level of a CDBWrapper */
+struct CDBLevelStats
+{
+    int nFiles;
+    uint64_t nBytes;
+    //! Time spent compacting into this level, and megabytes read and written doing so
+    double dCompactionTime;
+    double dCompactionRead;
+    double dCompactionWrite;
+
+    CDBLevelStats() : nFiles(0), nBytes(0), dCompactionTime(0), dCompactionRead(0), dCompactionWrite(0) {}
+};
+
 class dbwrapper_error : public std::runtime_error
 {
 public:
@@ -26,6 +63,7 @@ public:
 };
 
 class CDBWrapper;
+class CCountingCache;
 
 /** These should be considered an implementation detail of the specific database.
  */
@@ -180,6 +218,12 @@ private:
     //! custom environment this database is using (may be nullptr in case of default environment)
     leveldb::Env* penv;
 
+    //! tunables the database was opened with
+    CDBOptions dboptions;
+
+    //! block cache, counting lookups and hits
+    CCountingCache* pcache;
+
     //! database options used
     leveldb::Options options;
 
@@ -217,8 +261,9 @@ public:
      * @param[in] fWipe       If true, remove all existing data.
      * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If false, XOR
      *                        with a zero'd byte array.
+     * @param[in] dbopts      LevelDB tunables.
      */
-    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false);
+    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false, const CDBOptions& dbopts = CDBOptions());
     ~CDBWrapper();
 
     template <typename K, typename V>
@@ -306,6 +351,17 @@ public:
      */
     bool IsEmpty();
 
+    const CDBOptions& GetDBOptions() const { return dboptions; }
+
+    /** Read a LevelDB property such as "leveldb.stats". Returns false if it is unknown. */
+    bool GetProperty(const std::string& name, std::string& value) const;
+
+    /** Number of lookups in the block cache so far, and how many of them hit */
+    void GetCacheStats(uint64_t& nLookups, uint64_t& nHits) const;
+
+    /** Files, bytes and compaction work of each level */
+    std::vector<CDBLevelStats> GetLevelStats() const;
+
     template<typename K>
     size_t EstimateSize(const K& key_begin, const K& key_end) const
     {
@@ -11,11 +11,17 @@
 
 #include "addrman.h"
 #include "amount.h"
+#include "base58.h"
 #include "chain.h"
 #include "chainparams.h"
 #include "checkpoints.h"
 #include "compat/sanity.h"
 #include "consensus/validation.h"
+#include "crypto/dag.h"
+#include "crypto/scrypt.h"
+#include "crypto/sph_autodetect.h"
+#include "dagprepare.h"
+#include "dagstore.h"
 #include "fs.h"
 #include "httpserver.h"
 #include "httprpc.h"
@@ -28,12 +34,15 @@
 #include "policy/feerate.h"
 #include "policy/fees.h"
 #include "policy/policy.h"
+#include "pow.h"
+#include "powcache.h"
 #include "rpc/server.h"
 #include "rpc/register.h"
 #include "rpc/blockchain.h"
 #include "script/standard.h"
 #include "script/sigcache.h"
 #include "scheduler.h"
+#include "stratum.h"
 #include "timedata.h"
 #include "txdb.h"
 #include "txmempool.h"
@@ -66,10 +75,6 @@
 #include "zmq/zmqnotificationinterface.h"
 #endif
 
-#ifdef USE_SSE2
-#include "crypto/scrypt.h"
-#endif
-
 bool fFeeEstimatesInitialized = false;
 static const bool DEFAULT_PROXYRANDOMIZE = true;
 static const bool DEFAULT_REST_ENABLE = false;
@@ -167,6 +172,9 @@ void Interrupt(boost::thread_group& threadGroup)
     InterruptRPC();
     InterruptREST();
     InterruptTorControl();
+    InterruptDAGPrepare();
+    InterruptMining();
+    InterruptStratumServer();
     if (g_connman)
         g_connman->Interrupt();
     threadGroup.interrupt_all();
@@ -191,17 +199,21 @@ void Shutdown()
     StopREST();
     StopRPC();
     StopHTTPServer();
+    StopStratumServer();
+    StopMining();
 #ifdef ENABLE_WALLET
     for (CWalletRef pwallet : vpwallets) {
         pwallet->Flush(false);
     }
 #endif
     MapPort(false);
+    UnregisterValidationInterface(&blockTemplateCache);
     UnregisterValidationInterface(peerLogic.get());
     peerLogic.reset();
     g_connman.reset();
 
     StopTorControl();
+    StopDAGPrepare();
     UnregisterNodeSignals(GetNodeSignals());
     if (fDumpMempoolLater && gArgs.GetArg("-persistmempool", DEFAULT_PERSIST_MEMPOOL)) {
         DumpMempool();
@@ -241,6 +253,8 @@ void Shutdown()
         }
         delete pcoinsTip;
         pcoinsTip = nullptr;
+        delete pcoinsflushview;
+        pcoinsflushview = nullptr;
         delete pcoinscatcher;
         pcoinscatcher = nullptr;
         delete pcoinsdbview;
@@ -355,11 +369,21 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-daemon", _("Run in the background as a daemon and accept commands"));
 #endif
     }
+    strUsage += HelpMessageOpt("-dagpersist", strprintf(_("Keep DAG caches and graphs in the data directory and map them from there on startup (default: %u)"), DEFAULT_DAG_PERSIST));
+    strUsage += HelpMessageOpt("-dagprepare=<n>", strprintf(_("Build the next epoch's DAG data once the tip is within <n> blocks of the epoch boundary (0 to disable, default: %u)"), DEFAULT_DAG_PREPARE_DISTANCE));
+    strUsage += HelpMessageOpt("-dagthreads=<n>", strprintf(_("Set the number of threads used to generate DAGs and verify received headers (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"),
+        -GetNumCores(), MAX_DAG_THREADS, DEFAULT_DAG_THREADS));
     strUsage += HelpMessageOpt("-datadir=<dir>", _("Specify data directory"));
     if (showDebug) {
         strUsage += HelpMessageOpt("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize));
+        strUsage += HelpMessageOpt("-chainstatemaxopenfiles=<n>, -blockindexmaxopenfiles=<n>", strprintf("Maximum number of files LevelDB keeps open for the chainstate or block index database (minimum 20, default: %u)", DEFAULT_DB_MAX_OPEN_FILES));
+        strUsage += HelpMessageOpt("-chainstateblocksize=<n>, -blockindexblocksize=<n>", strprintf("Size of LevelDB table blocks in bytes (minimum 1024, default: %u)", DEFAULT_DB_BLOCK_SIZE));
+        strUsage += HelpMessageOpt("-chainstatewritebuffer=<n>, -blockindexwritebuffer=<n>", "Size of the LevelDB write buffer in megabytes (default: 0 = a quarter of the database cache)");
+        strUsage += HelpMessageOpt("-chainstatebloombits=<n>, -blockindexbloombits=<n>", strprintf("Bits per key of LevelDB bloom filters, 0 to disable them (default: %u)", DEFAULT_DB_BLOOM_BITS));
+        strUsage += HelpMessageOpt("-chainstatecompression, -blockindexcompression", strprintf("Compress LevelDB table blocks with Snappy, if built with it (default: %u)", DEFAULT_DB_COMPRESSION));
     }
     strUsage += HelpMessageOpt("-dbcache=<n>", strprintf(_("Set database cache size in megabytes (%d to %d, default: %d)"), nMinDbCache, nMaxDbCache, nDefaultDbCache));
+    strUsage += HelpMessageOpt("-dbcachekeep=<n>", strprintf(_("Keep the most recently used coins cached across flushes, up to <n> percent of the coin cache (0 to %d, default: %d)"), nMaxDbCacheKeep, nDefaultDbCacheKeep));
     if (showDebug)
         strUsage += HelpMessageOpt("-feefilter", strprintf("Tell other nodes to filter invs to us by our mempool min fee (default: %u)", DEFAULT_FEEFILTER));
     strUsage += HelpMessageOpt("-loadblock=<file>", _("Imports blocks from external blk000??.dat file on startup"));
@@ -373,6 +397,8 @@ std::string HelpMessage(HelpMessageMode mode)
 #ifndef WIN32
     strUsage += HelpMessageOpt("-pid=<file>", strprintf(_("Specify pid file (default: %s)"), BITCOIN_PID_FILENAME));
 #endif
+    strUsage += HelpMessageOpt("-prefetchthreads=<n>", strprintf(_("Set the number of threads reading the coins spent by a block from the database before connecting it (0 to %d, 0 or 1 = no prefetching, default: %d)"),
+        MAX_PREFETCH_THREADS, DEFAULT_PREFETCH_THREADS));
     strUsage += HelpMessageOpt("-prune=<n>", strprintf(_("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks, and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex and -rescan. "
             "Warning: Reverting this setting requires re-downloading the entire blockchain. "
             "(default: 0 = disable pruning blocks, 1 = allow manual pruning via RPC, >%u = automatically prune block files to stay under the specified target size in MiB)"), MIN_DISK_SPACE_FOR_BLOCK_FILES / 1024 / 1024));
@@ -442,6 +468,7 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-checkblocks=<n>", strprintf(_("How many blocks to check at startup (default: %u, 0 = all)"), DEFAULT_CHECKBLOCKS));
         strUsage += HelpMessageOpt("-checklevel=<n>", strprintf(_("How thorough the block verification of -checkblocks is (0-4, default: %u)"), DEFAULT_CHECKLEVEL));
         strUsage += HelpMessageOpt("-checkblockindex", strprintf("Do a full consistency check for mapBlockIndex, setBlockIndexCandidates, chainActive and mapBlocksUnlinked occasionally. Also sets -checkmempool (default: %u)", defaultChainParams->DefaultConsistencyChecks()));
+        strUsage += HelpMessageOpt("-checkblockreadpow", strprintf("Recheck the proof of work of every block read from disk (default: %u)", DEFAULT_CHECK_BLOCK_READ_POW));
         strUsage += HelpMessageOpt("-checkmempool=<n>", strprintf("Run checks every <n> transactions (default: %u)", defaultChainParams->DefaultConsistencyChecks()));
         strUsage += HelpMessageOpt("-checkpoints", strprintf("Disable expensive verification for known chain history (default: %u)", DEFAULT_CHECKPOINTS_ENABLED));
         strUsage += HelpMessageOpt("-disablesafemode", strprintf("Disable safemode, override a real safe mode event (default: %u)", DEFAULT_DISABLE_SAFEMODE));
@@ -467,6 +494,7 @@ std::string HelpMessage(HelpMessageMode mode)
     {
         strUsage += HelpMessageOpt("-logtimemicros", strprintf("Add microsecond precision to debug timestamps (default: %u)", DEFAULT_LOGTIMEMICROS));
         strUsage += HelpMessageOpt("-mocktime=<n>", "Replace actual time with <n> seconds since epoch (default: 0)");
+        strUsage += HelpMessageOpt("-maxpowcachesize=<n>", strprintf("Limit size of the valid proof of work cache to <n> MiB (default: %u)", DEFAULT_MAX_POW_CACHE_SIZE));
         strUsage += HelpMessageOpt("-maxsigcachesize=<n>", strprintf("Limit sum of signature cache and script execution cache sizes to <n> MiB (default: %u)", DEFAULT_MAX_SIG_CACHE_SIZE));
         strUsage += HelpMessageOpt("-maxtipage=<n>", strprintf("Maximum tip age in seconds to consider node in initial block download (default: %u)", DEFAULT_MAX_TIP_AGE));
     }
@@ -502,6 +530,9 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-blockmintxfee=<amt>", strprintf(_("Set lowest fee rate (in %s/kB) for transactions to be included in block creation. (default: %s)"), CURRENCY_UNIT, FormatMoney(DEFAULT_BLOCK_MIN_TX_FEE)));
     if (showDebug)
         strUsage += HelpMessageOpt("-blockversion=<n>", "Override block version to test forking scenarios");
+    strUsage += HelpMessageOpt("-gen", strprintf(_("Generate coins (default: %u)"), DEFAULT_GENERATE));
+    strUsage += HelpMessageOpt("-genaddress=<addr>", _("Address the coins generated by -gen are sent to"));
+    strUsage += HelpMessageOpt("-genproclimit=<n>", strprintf(_("Set the number of threads for coin generation if enabled (-1 = all cores, default: %d)"), DEFAULT_GENERATE_THREADS));
 
     strUsage += HelpMessageGroup(_("RPC server options:"));
     strUsage += HelpMessageOpt("-server", _("Accept command line and JSON-RPC commands"));
@@ -520,6 +551,17 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-rpcservertimeout=<n>", strprintf("Timeout during HTTP requests (default: %d)", DEFAULT_HTTP_SERVER_TIMEOUT));
     }
 
+    strUsage += HelpMessageGroup(_("Stratum server options:"));
+    strUsage += HelpMessageOpt("-stratum", strprintf(_("Accept Stratum mining connections (default: %u)"), DEFAULT_STRATUM_ENABLE));
+    strUsage += HelpMessageOpt("-stratumaddress=<addr>", _("Address the blocks found by Stratum miners pay to"));
+    strUsage += HelpMessageOpt("-stratumbind=<addr>[:port]", _("Bind to given address to listen for Stratum connections. Port is optional and overrides -stratumport. This option can be specified multiple times (default: 127.0.0.1 and ::1 i.e., localhost)"));
+    strUsage += HelpMessageOpt("-stratumport=<port>", strprintf(_("Listen for Stratum connections on <port> (default: %u)"), DEFAULT_STRATUM_PORT));
+    strUsage += HelpMessageOpt("-stratumdifficulty=<n>", strprintf(_("Accept shares meeting the proof-of-work limit divided by <n> (default: %d)"), DEFAULT_STRATUM_DIFFICULTY));
+    strUsage += HelpMessageOpt("-stratumthreads=<n>", strprintf(_("Set the number of threads to validate Stratum shares (default: %d)"), DEFAULT_STRATUM_THREADS));
+    if (showDebug) {
+        strUsage += HelpMessageOpt("-stratumworkqueue=<n>", strprintf("Set the depth of the work queue to validate Stratum shares (default: %d)", DEFAULT_STRATUM_WORKQUEUE));
+    }
+
     return strUsage;
 }
 
@@ -975,6 +1017,7 @@ bool AppInitParameterInteraction()
         mempool.setSanityCheck(1.0 / ratio);
     }
     fCheckBlockIndex = gArgs.GetBoolArg("-checkblockindex", chainparams.DefaultConsistencyChecks());
+    fCheckBlockReadPoW = gArgs.GetBoolArg("-checkblockreadpow", DEFAULT_CHECK_BLOCK_READ_POW);
     fCheckpointsEnabled = gArgs.GetBoolArg("-checkpoints", DEFAULT_CHECKPOINTS_ENABLED);
 
     hashAssumeValid = uint256S(gArgs.GetArg("-assumevalid", chainparams.GetConsensus().defaultAssumeValid.GetHex()));
@@ -1007,6 +1050,17 @@ bool AppInitParameterInteraction()
     else if (nScriptCheckThreads > MAX_SCRIPTCHECK_THREADS)
         nScriptCheckThreads = MAX_SCRIPTCHECK_THREADS;
 
+    // Like nScriptCheckThreads, nPrefetchThreads counts the thread connecting the block, so 1 means no concurrency
+    nPrefetchThreads = std::min<int>(gArgs.GetArg("-prefetchthreads", DEFAULT_PREFETCH_THREADS), MAX_PREFETCH_THREADS);
+    if (nPrefetchThreads <= 1)
+        nPrefetchThreads = 0;
+
+    // -dagthreads=0 means one DAG generation thread per core
+    int nDAGThreads = gArgs.GetArg("-dagthreads", DEFAULT_DAG_THREADS);
+    if (nDAGThreads <= 0)
+        nDAGThreads += GetNumCores();
+    CDAGSystem::nGraphThreads = std::max(1, std::min(nDAGThreads, MAX_DAG_THREADS));
+
     // block pruning; get the amount of disk space (in MiB) to allot for block & undo files
     int64_t nPruneArg = gArgs.GetArg("-prune", 0);
     if (nPruneArg < 0) {
@@ -1056,6 +1110,11 @@ bool AppInitParameterInteraction()
             return InitError(AmountErrMsg("blockmintxfee", gArgs.GetArg("-blockmintxfee", "")));
     }
 
+    if (gArgs.GetBoolArg("-gen", DEFAULT_GENERATE) && !CBitcoinAddress(gArgs.GetArg("-genaddress", "")).IsValid())
+        return InitError(strprintf(_("Invalid or missing -genaddress address: '%s'"), gArgs.GetArg("-genaddress", "")));
+    if (gArgs.GetBoolArg("-stratum", DEFAULT_STRATUM_ENABLE) && !CBitcoinAddress(gArgs.GetArg("-stratumaddress", "")).IsValid())
+        return InitError(strprintf(_("Invalid or missing -stratumaddress address: '%s'"), gArgs.GetArg("-stratumaddress", "")));
+
     // Feerate used to define dust.  Shouldn't be changed lightly as old
     // implementations may inadvertently create non-standard transactions
     if (gArgs.IsArgSet("-dustrelayfee"))
@@ -1169,6 +1228,13 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string dag_algo = DAGAutoDetect();
+    LogPrintf("Using the '%s' DAG implementation\n", dag_algo);
+    std::string cubehash_algo = CubeHashAutoDetect();
+    LogPrintf("Using the '%s' CubeHash implementation\n", cubehash_algo);
+    std::string lyra2_algo = Lyra2AutoDetect();
+    LogPrintf("Using the '%s' Lyra2 implementation\n", lyra2_algo);
+    LogPrintf("%s\n", scrypt_detect_avx2());
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1220,6 +1286,15 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
     InitSignatureCache();
     InitScriptExecutionCache();
+    InitPoWCache();
+
+    if (gArgs.GetBoolArg("-dagpersist", DEFAULT_DAG_PERSIST))
+        SetDAGStoreDir(GetDataDir() / "dag");
+    CDAGSystem::GraphInterrupt = ShutdownRequested;
+    CDAGSystem::GraphLog = [](const std::string& strMessage) { LogPrintf("%s\n", strMessage); };
+    CDAGSystem::GraphProgress = [](uint64_t epoch, int nProgress) {
+        uiInterface.ShowProgress(nProgress < 100 ? strprintf(_("Generating DAG for epoch %u..."), epoch) : "", nProgress);
+    };
 
     LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
@@ -1227,6 +1302,14 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
             threadGroup.create_thread(&ThreadScriptCheck);
     }
 
+    LogPrintf("Using %u threads for input prefetching\n", nPrefetchThreads);
+    for (int i = 0; i < nPrefetchThreads - 1; i++)
+        threadGroup.create_thread(&ThreadCoinPrefetch);
+
+    LogPrintf("Using %u threads for header verification\n", CDAGSystem::nGraphThreads);
+    for (int i = 0; i < CDAGSystem::nGraphThreads - 1; i++)
+        threadGroup.create_thread(&ThreadHashimoto);
+
     // Start the lightweight task scheduler thread
     CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue, &scheduler);
     threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
@@ -1269,6 +1352,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
     peerLogic.reset(new PeerLogicValidation(&connman));
     RegisterValidationInterface(peerLogic.get());
+    RegisterValidationInterface(&blockTemplateCache);
     RegisterNodeSignals(GetNodeSignals());
 
     // sanitize comments per BIP-0014, format user agent and check total size
@@ -1405,6 +1489,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
             try {
                 UnloadBlockIndex();
                 delete pcoinsTip;
+                delete pcoinsflushview;
                 delete pcoinsdbview;
                 delete pcoinscatcher;
                 delete pblocktree;
@@ -1477,7 +1562,8 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                 }
 
                 // The on-disk coinsdb is now in a good state, create the cache
-                pcoinsTip = new CCoinsViewCache(pcoinscatcher);
+                pcoinsflushview = new CCoinsViewBackgroundFlush(pcoinscatcher, pcoinsdbview);
+                pcoinsTip = new CCoinsViewCache(pcoinsflushview);
 
                 bool is_coinsview_empty = fReset || fReindexChainState || pcoinsTip->GetBestBlock().IsNull();
                 if (!is_coinsview_empty) {
@@ -1646,6 +1732,8 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     if (gArgs.GetBoolArg("-listenonion", DEFAULT_LISTEN_ONION))
         StartTorControl(threadGroup, scheduler);
 
+    StartDAGPrepare();
+
     Discover(threadGroup);
 
     // Map ports with UPnP
@@ -1700,6 +1788,16 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
         return false;
     }
 
+    // Generate coins in the background
+    if (!StartMining(chainparams))
+        return InitError(_("Invalid -genaddress"));
+
+    if (gArgs.GetBoolArg("-stratum", DEFAULT_STRATUM_ENABLE)) {
+        if (!InitStratumServer())
+            return InitError(_("Unable to start Stratum server. See debug log for details."));
+        StartStratumServer();
+    }
+
     // ********************************************************* Step 12: finished
 
     SetRPCWarmupFinished();
@@ -5,7 +5,9 @@
 #ifndef BITCOIN_MEMUSAGE_H
 #define BITCOIN_MEMUSAGE_H
 
+#include "arenamap.h"
 #include "indirectmap.h"
+#include "prevector.h"
 
 #include <stdlib.h>
 
@@ -116,6 +118,14 @@ static inline size_t IncrementalDynamicUsage(const std::map<X, Y, Z>& m)
     return MallocUsage(sizeof(stl_tree_node<std::pair<const X, Y> >));
 }
 
+// arenamap allocates its entries in chunks, besides the list of chunks and the index
+
+template<typename X, typename Y, typename Z>
+static inline size_t DynamicUsage(const arenamap<X, Y, Z>& m)
+{
+    return MallocUsage(m.chunk_bytes()) * m.chunk_count() + MallocUsage(m.chunk_list_bytes()) + MallocUsage(m.index_bytes());
+}
+
 // indirectmap has underlying map with pointer as key
 
 template<typename X, typename Y>
@@ -7,12 +7,15 @@
 
 #include "amount.h"
 #include "chain.h"
+#include "base58.h"
 #include "chainparams.h"
 #include "coins.h"
 #include "consensus/consensus.h"
 #include "consensus/tx_verify.h"
 #include "consensus/merkle.h"
 #include "consensus/validation.h"
+#include "crypto/dag.h"
+#include "crypto/Lyra2RE.h"
 #include "hash.h"
 #include "crypto/scrypt.h"
 #include "validation.h"
@@ -29,7 +32,10 @@
 #include "validationinterface.h"
 
 #include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <queue>
+#include <thread>
 #include <utility>
 
 //////////////////////////////////////////////////////////////////////////////
@@ -47,6 +53,8 @@ uint64_t nLastBlockTx = 0;
 uint64_t nLastBlockSize = 0;
 uint64_t nLastBlockWeight = 0;
 
+CBlockTemplateCache blockTemplateCache;
+
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev)
 {
     int64_t nOldTime = pblock->nTime;
@@ -128,6 +136,16 @@ void BlockAssembler::resetBlock()
 }
 
 std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& scriptPubKeyIn, bool fMineWitnessTx)
+{
+    return CreateBlock(nullptr, scriptPubKeyIn, fMineWitnessTx);
+}
+
+std::unique_ptr<CBlockTemplate> BlockAssembler::UpdateBlock(const CBlockTemplate& prev, const CScript& scriptPubKeyIn, bool fMineWitnessTx)
+{
+    return CreateBlock(&prev, scriptPubKeyIn, fMineWitnessTx);
+}
+
+std::unique_ptr<CBlockTemplate> BlockAssembler::CreateBlock(const CBlockTemplate* prev, const CScript& scriptPubKeyIn, bool fMineWitnessTx)
 {
     int64_t nTimeStart = GetTimeMicros();
 
@@ -169,6 +187,19 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     // transaction (which in most cases can be a no-op).
     fIncludeWitness = IsWitnessEnabled(pindexPrev, chainparams.GetConsensus()) && fMineWitnessTx;
 
+    if (prev) {
+        // Same tip, so the transactions of prev are still final and in a valid order. Whatever
+        // descends from them is picked up by addPackageTxs through inBlock.
+        if (prev->block.hashPrevBlock != pindexPrev->GetBlockHash())
+            return nullptr;
+        for (size_t i = 1; i < prev->block.vtx.size(); i++) {
+            CTxMemPool::txiter it = mempool.mapTx.find(prev->block.vtx[i]->GetHash());
+            if (it == mempool.mapTx.end() || (!fIncludeWitness && it->GetTx().HasWitness()))
+                return nullptr;
+            AddToBlock(it);
+        }
+    }
+
     int nPackagesSelected = 0;
     int nDescendantsUpdated = 0;
     addPackageTxs(nPackagesSelected, nDescendantsUpdated);
@@ -485,11 +516,314 @@ void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned
         hashPrevBlock = pblock->hashPrevBlock;
     }
     ++nExtraNonce;
+    SetExtraNonce(pblock, pindexPrev, nExtraNonce);
+}
+
+static void SetCoinbaseExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int nExtraNonce)
+{
     unsigned int nHeight = pindexPrev->nHeight+1; // Height first in coinbase required for block.version=2
     CMutableTransaction txCoinbase(*pblock->vtx[0]);
     txCoinbase.vin[0].scriptSig = (CScript() << nHeight << CScriptNum(nExtraNonce)) + COINBASE_FLAGS;
     assert(txCoinbase.vin[0].scriptSig.size() <= 100);
 
     pblock->vtx[0] = MakeTransactionRef(std::move(txCoinbase));
+}
+
+void SetExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int nExtraNonce)
+{
+    SetCoinbaseExtraNonce(pblock, pindexPrev, nExtraNonce);
     pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
 }
+
+void SetExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int nExtraNonce, const std::vector<uint256>& vMerkleBranch)
+{
+    SetCoinbaseExtraNonce(pblock, pindexPrev, nExtraNonce);
+    pblock->hashMerkleRoot = ComputeMerkleRootFromBranch(pblock->vtx[0]->GetHash(), vMerkleBranch, 0);
+}
+
+std::shared_ptr<const CCachedBlockTemplate> CBlockTemplateCache::Get(const CChainParams& chainparams, bool fSupportsSegwit)
+{
+    AssertLockHeld(cs_main);
+    std::shared_ptr<const CCachedBlockTemplate> cached;
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        cached = pcached;
+    }
+    const CBlockIndex* pindexTip = chainActive.Tip();
+    const unsigned int nTransactionsUpdated = mempool.GetTransactionsUpdated();
+    const int64_t nNow = GetTime();
+    if (cached && cached->pindexPrev == pindexTip && cached->fSupportsSegwit == fSupportsSegwit &&
+        (cached->nTransactionsUpdated == nTransactionsUpdated || nNow - cached->nTimeUpdated <= UPDATE_INTERVAL))
+        return cached;
+
+    std::shared_ptr<CCachedBlockTemplate> entry = std::make_shared<CCachedBlockTemplate>();
+    entry->pindexPrev = pindexTip;
+    entry->nTransactionsUpdated = nTransactionsUpdated;
+    entry->fSupportsSegwit = fSupportsSegwit;
+    entry->nTimeUpdated = nNow;
+
+    CScript scriptDummy = CScript() << OP_TRUE;
+    std::unique_ptr<CBlockTemplate> pblocktemplate;
+    if (cached && cached->pindexPrev == pindexTip && cached->fSupportsSegwit == fSupportsSegwit &&
+        nNow - cached->nTimeCreated <= CREATE_INTERVAL) {
+        pblocktemplate = BlockAssembler(chainparams).UpdateBlock(*cached->pblocktemplate, scriptDummy, fSupportsSegwit);
+        entry->nTimeCreated = cached->nTimeCreated;
+    }
+    if (!pblocktemplate) {
+        pblocktemplate = BlockAssembler(chainparams).CreateNewBlock(scriptDummy, fSupportsSegwit);
+        entry->nTimeCreated = nNow;
+    }
+    if (!pblocktemplate)
+        return nullptr;
+    entry->pblocktemplate = std::move(pblocktemplate);
+
+    std::lock_guard<std::mutex> lock(cs);
+    pcached = entry;
+    return pcached;
+}
+
+void CBlockTemplateCache::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload)
+{
+    std::lock_guard<std::mutex> lock(cs);
+    pcached.reset();
+}
+
+void CBlockTemplateCache::TransactionAddedToMempool(const CTransactionRef &ptxn)
+{
+    // Taking csBestBlock orders this with a long poll that is about to wait, so the notification isn't lost
+    {
+        boost::unique_lock<boost::mutex> lock(csBestBlock);
+    }
+    cvBlockChange.notify_all();
+}
+
+bool ScanNonces(CBlockHeader& header, uint64_t nCount, const arith_uint256& bnTarget)
+{
+    const bool fDAG = header.nVersion & 0x00000100;
+    // Only the nonce changes, so the first 64 bytes of the header are absorbed once for all of them
+    lyra2re2_midstate midstate;
+    if (fDAG)
+        lyra2re2_midstate_init(&midstate, (const char*)&header);
+    for (; nCount > 0; nCount--, header.nNonce++) {
+        if (fDAG) {
+            // The mix of the winning hash is the header's hashMix, so it never has to be recomputed
+            CHashimotoResult res = CDAGSystem::FastHashimoto(header, midstate);
+            if (UintToArith256(res.GetResult()) <= bnTarget) {
+                header.hashMix = res.GetCmix();
+                return true;
+            }
+        } else if (UintToArith256(header.GetPoWHash()) <= bnTarget) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// Internal miner
+//
+
+namespace {
+
+/** Number of nonces a mining thread tries between checks for a newer template */
+static const uint64_t MINING_SCAN_BATCH = 256;
+/** Seconds after which a template is rebuilt to pick up new mempool transactions */
+static const int64_t MINING_TEMPLATE_REFRESH = 60;
+
+/** Template shared by all mining threads, each of them scanning its own slice of the nonce space */
+struct CMiningWork {
+    /** Value of nMiningWorkId the template was published under */
+    unsigned int nId;
+    CBlock block;
+    /** Merkle branch of the coinbase, to roll the extra nonce without hashing the whole tree */
+    std::vector<uint256> vMerkleBranch;
+    const CBlockIndex* pindexPrev;
+    arith_uint256 bnTarget;
+    /** Value of nMiningTipUpdates the template was built at */
+    unsigned int nTipUpdates;
+    unsigned int nTransactionsUpdated;
+    int64_t nTime;
+};
+
+/** Counts new tips, which make the current template stale */
+class CMinerNotifier : public CValidationInterface
+{
+protected:
+    void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
+};
+
+std::atomic<unsigned int> nMiningTipUpdates(0);
+/** Identifies the current template, so threads still mining an older one notice without taking cs_miningwork */
+std::atomic<unsigned int> nMiningWorkId(0);
+std::atomic<bool> fMiningInterrupted(false);
+std::vector<std::thread> vMiningThreads;
+std::unique_ptr<CMinerNotifier> pMinerNotifier;
+CScript scriptMining;
+
+std::mutex cs_miningwork;
+/** Current template, replaced by the first thread that finds it stale or runs out of nonces */
+std::shared_ptr<const CMiningWork> pMiningWork;
+/** Extra nonce of the current template, restarted on every new tip */
+unsigned int nMiningExtraNonce = 0;
+
+void CMinerNotifier::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload)
+{
+    nMiningTipUpdates++;
+}
+
+bool IsMiningWorkStale(const CMiningWork& work)
+{
+    if (work.nId != nMiningWorkId || work.nTipUpdates != nMiningTipUpdates)
+        return true;
+    return mempool.GetTransactionsUpdated() != work.nTransactionsUpdated && GetTime() - work.nTime > MINING_TEMPLATE_REFRESH;
+}
+
+/**
+ * Returns the template to mine on after prev. That is the current template, unless it is still prev and prev is
+ * stale, has had its nonce space exhausted or has just been solved. An exhausted template only needs the next extra
+ * nonce, and gets it from the coinbase's merkle branch. Otherwise a new one is built.
+ */
+std::shared_ptr<const CMiningWork> GetMiningWork(const std::shared_ptr<const CMiningWork>& prev, bool fExhausted, bool fSolved, const CChainParams& chainparams)
+{
+    std::lock_guard<std::mutex> lock(cs_miningwork);
+    if (pMiningWork && (pMiningWork != prev || (!fExhausted && !fSolved && !IsMiningWorkStale(*pMiningWork))))
+        return pMiningWork;
+
+    std::shared_ptr<CMiningWork> work;
+    if (pMiningWork && fExhausted && !fSolved && !IsMiningWorkStale(*pMiningWork)) {
+        work = std::make_shared<CMiningWork>(*pMiningWork);
+        SetExtraNonce(&work->block, work->pindexPrev, ++nMiningExtraNonce, work->vMerkleBranch);
+        work->nId = ++nMiningWorkId;
+        pMiningWork = work;
+        return pMiningWork;
+    }
+
+    work = std::make_shared<CMiningWork>();
+    work->nTipUpdates = nMiningTipUpdates;
+    work->nTransactionsUpdated = mempool.GetTransactionsUpdated();
+    work->nTime = GetTime();
+    try {
+        LOCK(cs_main);
+        std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(chainparams).CreateNewBlock(scriptMining));
+        if (!pblocktemplate)
+            throw std::runtime_error("no block template");
+        work->block = pblocktemplate->block;
+        work->pindexPrev = chainActive.Tip();
+        if (!pMiningWork || pMiningWork->block.hashPrevBlock != work->block.hashPrevBlock)
+            nMiningExtraNonce = 0;
+        work->vMerkleBranch = BlockMerkleBranch(work->block, 0);
+        SetExtraNonce(&work->block, work->pindexPrev, ++nMiningExtraNonce, work->vMerkleBranch);
+    } catch (const std::runtime_error& e) {
+        LogPrintf("ChancoinMiner: couldn't create a new block: %s\n", e.what());
+        pMiningWork.reset();
+        return nullptr;
+    }
+    work->bnTarget.SetCompact(work->block.nBits);
+    work->nId = ++nMiningWorkId;
+    pMiningWork = work;
+    return pMiningWork;
+}
+
+void ThreadMiner(int nThread, int nThreads, const CChainParams& chainparams)
+{
+    // Thread nThread scans nonces [nBegin, nEnd) of every template
+    const uint64_t nBegin = ((uint64_t)1 << 32) * nThread / nThreads;
+    const uint64_t nEnd = ((uint64_t)1 << 32) * (nThread + 1) / nThreads;
+    std::shared_ptr<const CMiningWork> work;
+    bool fExhausted = false;
+    bool fSolved = false;
+    while (!fMiningInterrupted) {
+        // Blocks found on an old tip would only be orphaned, wait until the chain has caught up
+        if (!chainparams.MineBlocksOnDemand() && IsInitialBlockDownload()) {
+            MilliSleep(1000);
+            continue;
+        }
+        work = GetMiningWork(work, fExhausted, fSolved, chainparams);
+        fExhausted = false;
+        fSolved = false;
+        if (!work) {
+            MilliSleep(1000);
+            continue;
+        }
+
+        CBlockHeader header = work->block.GetBlockHeader();
+        header.nNonce = nBegin;
+        uint64_t nNonce = nBegin;
+        bool fFound = false;
+        while (!fMiningInterrupted) {
+            uint64_t nCount = std::min(MINING_SCAN_BATCH, nEnd - nNonce);
+            if (ScanNonces(header, nCount, work->bnTarget)) {
+                fFound = true;
+                break;
+            }
+            nNonce += nCount;
+            if (nNonce == nEnd) {
+                fExhausted = true;
+                break;
+            }
+            if (IsMiningWorkStale(*work))
+                break;
+        }
+        if (!fFound)
+            continue;
+
+        // Move every thread on to a template built after this block, whether or not it gets accepted
+        fSolved = true;
+        std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>(work->block);
+        pblock->nNonce = header.nNonce;
+        pblock->hashMix = header.hashMix;
+        LogPrintf("ChancoinMiner: proof-of-work found for block %s at height %d\n", pblock->GetHash().ToString(), pblock->height);
+        if (!ProcessNewBlock(chainparams, pblock, true, nullptr))
+            LogPrintf("ChancoinMiner: block %s was not accepted\n", pblock->GetHash().ToString());
+    }
+}
+
+} // namespace
+
+bool StartMining(const CChainParams& chainparams)
+{
+    if (!gArgs.GetBoolArg("-gen", DEFAULT_GENERATE))
+        return true;
+    CBitcoinAddress address(gArgs.GetArg("-genaddress", ""));
+    if (!address.IsValid())
+        return false;
+    scriptMining = GetScriptForDestination(address.Get());
+
+    int nThreads = gArgs.GetArg("-genproclimit", DEFAULT_GENERATE_THREADS);
+    if (nThreads < 0)
+        nThreads = GetNumCores();
+    if (nThreads == 0)
+        return true;
+
+    assert(!pMinerNotifier);
+    fMiningInterrupted = false;
+    pMinerNotifier.reset(new CMinerNotifier());
+    RegisterValidationInterface(pMinerNotifier.get());
+    LogPrintf("Starting %d mining threads\n", nThreads);
+    for (int i = 0; i < nThreads; i++) {
+        vMiningThreads.emplace_back([i, nThreads, &chainparams] {
+            TraceThread("miner", [i, nThreads, &chainparams] { ThreadMiner(i, nThreads, chainparams); });
+        });
+    }
+    return true;
+}
+
+void InterruptMining()
+{
+    fMiningInterrupted = true;
+}
+
+void StopMining()
+{
+    for (std::thread& thread : vMiningThreads) {
+        thread.join();
+    }
+    vMiningThreads.clear();
+    if (pMinerNotifier) {
+        UnregisterValidationInterface(pMinerNotifier.get());
+        pMinerNotifier.reset();
+    }
+    std::lock_guard<std::mutex> lock(cs_miningwork);
+    pMiningWork.reset();
+}
@@ -8,12 +8,15 @@
 
 #include "primitives/block.h"
 #include "txmempool.h"
+#include "validationinterface.h"
 
 #include <stdint.h>
 #include <memory>
+#include <mutex>
 #include "boost/multi_index_container.hpp"
 #include "boost/multi_index/ordered_index.hpp"
 
+class arith_uint256;
 class CBlockIndex;
 class CChainParams;
 class CScript;
@@ -21,6 +24,10 @@ class CScript;
 namespace Consensus { struct Params; };
 
 static const bool DEFAULT_PRINTPRIORITY = false;
+/** Default for -gen */
+static const bool DEFAULT_GENERATE = false;
+/** Default for -genproclimit (-1 = one thread per core) */
+static const int DEFAULT_GENERATE_THREADS = -1;
 
 struct CBlockTemplate
 {
@@ -169,9 +176,17 @@ public:
 
     /** Construct a new block template with coinbase to scriptPubKeyIn */
     std::unique_ptr<CBlockTemplate> CreateNewBlock(const CScript& scriptPubKeyIn, bool fMineWitnessTx=true);
+    /**
+     * Construct a new block template that keeps the transactions of prev, a template built on the current tip, and
+     * fills the space it left with the best packages of the mempool. Returns nullptr if prev was built on another
+     * tip or any of its transactions has left the mempool, in which case CreateNewBlock has to be used instead.
+     */
+    std::unique_ptr<CBlockTemplate> UpdateBlock(const CBlockTemplate& prev, const CScript& scriptPubKeyIn, bool fMineWitnessTx=true);
 
 private:
     // utility functions
+    /** Construct a new block template, starting from the transactions of prev if it is not null */
+    std::unique_ptr<CBlockTemplate> CreateBlock(const CBlockTemplate* prev, const CScript& scriptPubKeyIn, bool fMineWitnessTx);
     /** Clear the block's state and prepare for assembling a new block */
     void resetBlock();
     /** Add a tx to the block */
@@ -206,6 +221,73 @@ private:
 
 /** Modify the extranonce in a block */
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce);
+/** Set the extranonce of a block's coinbase and update its merkle root */
+void SetExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int nExtraNonce);
+/**
+ * Set the extranonce of a block's coinbase and update its merkle root from vMerkleBranch, the coinbase's branch as
+ * returned by BlockMerkleBranch(*pblock, 0), which only costs log2 of the number of transactions in hashes.
+ */
+void SetExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int nExtraNonce, const std::vector<uint256>& vMerkleBranch);
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
 
+/** A template served by CBlockTemplateCache, along with the chain and mempool state it was built from */
+struct CCachedBlockTemplate
+{
+    std::shared_ptr<const CBlockTemplate> pblocktemplate;
+    const CBlockIndex* pindexPrev;
+    /** Value of mempool.GetTransactionsUpdated() the template is up to date with */
+    unsigned int nTransactionsUpdated;
+    bool fSupportsSegwit;
+    /** Time the template was last built from scratch */
+    int64_t nTimeCreated;
+    /** Time the template was last brought up to date with the mempool */
+    int64_t nTimeUpdated;
+
+    CAmount GetFees() const { return -pblocktemplate->vTxFees[0]; }
+};
+
+/**
+ * Template shared by all getblocktemplate callers, keyed on the tip and the mempool's transactions updated counter.
+ * A new tip gets a template built from scratch, while mempool changes are folded into the current one with
+ * BlockAssembler::UpdateBlock. The template is dropped as soon as a new tip is signalled, and every signal wakes
+ * up long polls waiting on cvBlockChange.
+ */
+class CBlockTemplateCache : public CValidationInterface
+{
+public:
+    /** Seconds a template keeps being served after the mempool changed, before it is updated */
+    static const int64_t UPDATE_INTERVAL = 5;
+    /** Seconds after which a template is built from scratch, so that better packages can displace its transactions */
+    static const int64_t CREATE_INTERVAL = 60;
+
+    /** Return the template for the current tip, building or updating it if needed. Requires cs_main. */
+    std::shared_ptr<const CCachedBlockTemplate> Get(const CChainParams& chainparams, bool fSupportsSegwit);
+
+protected:
+    void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
+    void TransactionAddedToMempool(const CTransactionRef &ptxn) override;
+
+private:
+    std::mutex cs;
+    std::shared_ptr<const CCachedBlockTemplate> pcached;
+};
+
+extern CBlockTemplateCache blockTemplateCache;
+
+/**
+ * Try nCount nonces of header, starting at header.nNonce, against bnTarget. Returns true with header.nNonce set to
+ * the first solution and, for DAG headers, header.hashMix set to the mix of its hash. Otherwise the nonce is left
+ * nCount past where it started.
+ */
+bool ScanNonces(CBlockHeader& header, uint64_t nCount, const arith_uint256& bnTarget);
+
+/**
+ * Start the internal miner if -gen is set, with -genproclimit threads mining to -genaddress. The threads share one
+ * template, rebuilt on a new tip or mempool change, and each of them scans its own slice of the nonce space.
+ * Returns false if -genaddress is not a valid address.
+ */
+bool StartMining(const CChainParams& chainparams);
+void InterruptMining();
+void StopMining();
+
 #endif // BITCOIN_MINER_H
@@ -1030,8 +1030,13 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
                 if (send && (mi->second->nStatus & BLOCK_HAVE_DATA))
                 {
                     std::shared_ptr<const CBlock> pblock;
+                    std::shared_ptr<const std::vector<unsigned char>> pblockRaw;
                     if (a_recent_block && a_recent_block->GetHash() == (*mi).second->GetBlockHash()) {
                         pblock = a_recent_block;
+                    } else if (inv.type == MSG_WITNESS_BLOCK) {
+                        // Witness blocks are sent as serialized on disk, without a round trip through CBlock
+                        if (!ReadRawBlockFromDisk(pblockRaw, (*mi).second, Params().MessageStart()))
+                            assert(!"cannot load block from disk");
                     } else {
                         // Send block from disk
                         std::shared_ptr<CBlock> pblockRead = std::make_shared<CBlock>();
@@ -1041,8 +1046,22 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
                     }
                     if (inv.type == MSG_BLOCK)
                         connman.PushMessage(pfrom, msgMaker.Make(SERIALIZE_TRANSACTION_NO_WITNESS, NetMsgType::BLOCK, *pblock));
-                    else if (inv.type == MSG_WITNESS_BLOCK)
-                        connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::BLOCK, *pblock));
+                    else if (inv.type == MSG_WITNESS_BLOCK) {
+                        if (pblockRaw) {
+                            CSerializedNetMsg msg;
+                            msg.command = NetMsgType::BLOCK;
+                            if (pblockRaw.use_count() == 1) {
+                                // Not held by the raw block cache (too big, or already evicted), so the block is moved
+                                msg.data = std::move(*std::const_pointer_cast<std::vector<unsigned char>>(pblockRaw));
+                            } else {
+                                // The cache shares the block, the send buffer gets its own copy
+                                msg.data = *pblockRaw;
+                            }
+                            connman.PushMessage(pfrom, std::move(msg));
+                        } else {
+                            connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::BLOCK, *pblock));
+                        }
+                    }
                     else if (inv.type == MSG_FILTERED_BLOCK)
                     {
                         bool sendMerkleBlock = false;
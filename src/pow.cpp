@@ -7,10 +7,15 @@
 
 #include "arith_uint256.h"
 #include "chain.h"
+#include "checkqueue.h"
+#include "powcache.h"
 #include "primitives/block.h"
 #include "uint256.h"
 #include "util.h"
 #include "crypto/dag.h"
+#include "crypto/scrypt.h"
+
+#include <functional>
 
 unsigned int KimotoGravityWell(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params& params) {
 
@@ -142,32 +147,28 @@ unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nF
     return bnNew.GetCompact();
 }
 
-bool CheckProofOfWork(CBlockHeader header, const Consensus::Params& params, bool fFast, bool fNoCheckHashMix)
+static bool GetTarget(unsigned int nBits, const Consensus::Params& params, arith_uint256& bnTarget)
 {
     bool fNegative;
     bool fOverflow;
-    arith_uint256 bnTarget;
-    CDAGSystem sys;
-    bnTarget.SetCompact(header.nBits, &fNegative, &fOverflow);
+    bnTarget.SetCompact(nBits, &fNegative, &fOverflow);
 
     // Check range
-    if (fNegative || bnTarget == 0 || fOverflow || bnTarget > UintToArith256(params.powLimit))
+    return !(fNegative || bnTarget == 0 || fOverflow || bnTarget > UintToArith256(params.powLimit));
+}
+
+static bool CheckProofOfWorkUncached(const CBlockHeader& header, const Consensus::Params& params, bool fFast, bool fNoCheckHashMix)
+{
+    arith_uint256 bnTarget;
+    if (!GetTarget(header.nBits, params, bnTarget))
         return false;
 
     if (header.nVersion & 0x00000100) {
-        if (!fFast) {
-            CHashimotoResult res = sys.Hashimoto(header);
-            if (header.hashMix != res.GetCmix() && !fNoCheckHashMix)
-                return false;
-        } else {
-            CHashimotoResult res = sys.FastHashimoto(header);
-            if (header.hashMix != res.GetCmix() && !fNoCheckHashMix)
-                return false;
-            if (UintToArith256(res.GetResult()) > bnTarget)
-                return false;
-            else
-                return true;
-        }
+        // The hashimoto result is the header's PoW hash, so check it directly instead of hashing again in GetPoWHash
+        CHashimotoResult res = fFast ? CDAGSystem::FastHashimoto(header) : CDAGSystem::Hashimoto(header);
+        if (header.hashMix != res.GetCmix() && !fNoCheckHashMix)
+            return false;
+        return UintToArith256(res.GetResult()) <= bnTarget;
     }
 
     // Check proof of work matches claimed amount
@@ -177,6 +178,144 @@ bool CheckProofOfWork(CBlockHeader header, const Consensus::Params& params, bool
     return true;
 }
 
+bool CheckProofOfWork(const CBlockHeader& header, const Consensus::Params& params, bool fFast, bool fNoCheckHashMix)
+{
+    // Mining attempts are neither found in nor worth adding to the cache
+    if (fNoCheckHashMix)
+        return CheckProofOfWorkUncached(header, params, fFast, fNoCheckHashMix);
+
+    uint256 entry = PoWCacheEntry(header, params);
+    if (PoWCacheContains(entry))
+        return true;
+    if (!CheckProofOfWorkUncached(header, params, fFast, fNoCheckHashMix))
+        return false;
+    PoWCacheInsert(entry);
+    return true;
+}
+
+/** Hashimoto of a run of up to CDAGSystem::HEADER_LANES headers of one epoch, queued by HashimotoBatch */
+class CHashimotoCheck
+{
+private:
+    const CBlockHeader *headers;
+    size_t n;
+    CHashimotoResult *results;
+
+public:
+    CHashimotoCheck() : headers(nullptr), n(0), results(nullptr) {}
+    CHashimotoCheck(const CBlockHeader *headersIn, size_t nIn, CHashimotoResult *resultsIn) :
+        headers(headersIn), n(nIn), results(resultsIn) {}
+
+    bool operator()()
+    {
+        CDAGSystem::HashimotoRun(headers, n, results);
+        return true;
+    }
+
+    void swap(CHashimotoCheck& check)
+    {
+        std::swap(headers, check.headers);
+        std::swap(n, check.n);
+        std::swap(results, check.results);
+    }
+};
+
+/** Every run takes on the order of a millisecond, so workers take few of them at a time */
+static CCheckQueue<CHashimotoCheck> hashimotoqueue(4);
+
+void ThreadHashimoto()
+{
+    RenameThread("bitcoin-hashimoto");
+    hashimotoqueue.Thread();
+}
+
+void HashimotoBatch(const std::vector<CBlockHeader>& headers, std::vector<CHashimotoResult>& results)
+{
+    results.assign(headers.size(), CHashimotoResult(uint128(), uint256()));
+    // Split the headers into runs of up to HEADER_LANES headers of the same epoch
+    std::vector<CHashimotoCheck> vChecks;
+    for (size_t begin = 0; begin < headers.size(); ) {
+        const uint64_t epoch = CDAGSystem::GetEpoch(headers[begin].height);
+        size_t end = begin + 1;
+        while (end < headers.size() && end - begin < CDAGSystem::HEADER_LANES && CDAGSystem::GetEpoch(headers[end].height) == epoch)
+            end++;
+        vChecks.emplace_back(&headers[begin], end - begin, &results[begin]);
+        begin = end;
+    }
+    CCheckQueueControl<CHashimotoCheck> control(&hashimotoqueue);
+    control.Add(vChecks);
+    control.Wait();
+}
+
+std::vector<bool> CheckProofOfWorkBatch(const std::vector<CBlockHeader>& headers, const Consensus::Params& params)
+{
+    std::vector<bool> vValid(headers.size(), false);
+    // Positions of the headers still to be hashed, DAG headers and legacy scrypt headers apart
+    std::vector<size_t> vDAGPos, vLegacyPos;
+    std::vector<uint256> vEntries(headers.size());
+    for (size_t i = 0; i < headers.size(); i++) {
+        vEntries[i] = PoWCacheEntry(headers[i], params);
+        if (PoWCacheContains(vEntries[i])) {
+            vValid[i] = true;
+            continue;
+        }
+        if (headers[i].nVersion & 0x00000100) {
+            vDAGPos.push_back(i);
+        } else {
+            vLegacyPos.push_back(i);
+        }
+    }
+
+    // Hash in chunks that start at a single header and double in size as long as every header passes, so that a
+    // peer sending invalid headers costs us at most one header more than the valid proof of work it sent along.
+    auto checkChunks = [&](const std::vector<size_t>& vPos, const std::function<void(const std::vector<size_t>&, std::vector<uint256>&)>& hash) {
+        size_t nChunk = 1;
+        std::vector<uint256> vHashes;
+        for (size_t begin = 0; begin < vPos.size(); nChunk *= 2) {
+            size_t end = std::min(vPos.size(), begin + nChunk);
+            std::vector<size_t> vChunk(vPos.begin() + begin, vPos.begin() + end);
+            hash(vChunk, vHashes);
+            for (size_t i = 0; i < vChunk.size(); i++) {
+                arith_uint256 bnTarget;
+                if (!GetTarget(headers[vChunk[i]].nBits, params, bnTarget) || UintToArith256(vHashes[i]) > bnTarget)
+                    return false;
+                vValid[vChunk[i]] = true;
+                PoWCacheInsert(vEntries[vChunk[i]]);
+            }
+            begin = end;
+        }
+        return true;
+    };
+
+    bool fValid = checkChunks(vDAGPos, [&](const std::vector<size_t>& vChunk, std::vector<uint256>& vHashes) {
+        std::vector<CBlockHeader> vHeaders;
+        for (size_t pos : vChunk) {
+            vHeaders.push_back(headers[pos]);
+        }
+        std::vector<CHashimotoResult> results;
+        HashimotoBatch(vHeaders, results);
+        vHashes.clear();
+        for (size_t i = 0; i < vHeaders.size(); i++) {
+            // A header claiming the wrong mix gets a hash that can never meet a target
+            vHashes.push_back(vHeaders[i].hashMix == results[i].GetCmix() ? results[i].GetResult() : ArithToUint256(~arith_uint256()));
+        }
+    });
+    if (!fValid)
+        return vValid;
+
+    checkChunks(vLegacyPos, [&](const std::vector<size_t>& vChunk, std::vector<uint256>& vHashes) {
+        vHashes.resize(vChunk.size());
+        std::vector<const char*> vInputs;
+        std::vector<char*> vOutputs;
+        for (size_t i = 0; i < vChunk.size(); i++) {
+            vInputs.push_back((const char*)&headers[vChunk[i]].nVersion);
+            vOutputs.push_back((char*)vHashes[i].begin());
+        }
+        scrypt_1024_1_1_256_batch(vInputs.data(), vOutputs.data(), vChunk.size());
+    });
+    return vValid;
+}
+
 unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params& params) {
 
     int RetargetMode = 1;
@@ -9,9 +9,11 @@
 #include "consensus/params.h"
 
 #include <stdint.h>
+#include <vector>
 
 class CBlockHeader;
 class CBlockIndex;
+class CHashimotoResult;
 class uint256;
 class uint128;
 
@@ -21,6 +23,20 @@ unsigned int GetNextWorkRequired_legacy(const CBlockIndex* pindexLast, const CBl
 unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nFirstBlockTime, const Consensus::Params&);
 
 /** Check whether a block hash satisfies the proof-of-work requirement specified by nBits */
-bool CheckProofOfWork(CBlockHeader header, const Consensus::Params&, bool fFast = false, bool fNoCheckHashMix = false);
+bool CheckProofOfWork(const CBlockHeader& header, const Consensus::Params&, bool fFast = false, bool fNoCheckHashMix = false);
+/** Runs one of the worker threads HashimotoBatch spreads its headers over, next to the calling thread */
+void ThreadHashimoto();
+/**
+ * Runs the hashimoto function on every header using the cache, in runs of CDAGSystem::HashimotoRun spread over the
+ * calling thread and the ThreadHashimoto threads. results[i] is the same as CDAGSystem::Hashimoto(headers[i]).
+ */
+void HashimotoBatch(const std::vector<CBlockHeader>& headers, std::vector<CHashimotoResult>& results);
+/**
+ * Check the proof of work of many headers at once, verifying the DAG headers among them together with
+ * HashimotoBatch and the legacy scrypt headers with scrypt_1024_1_1_256_batch. Entry i is true if
+ * headers[i] is known to satisfy its requirement; headers that fail, or are hashed after a failing header, are left
+ * to CheckProofOfWork.
+ */
+std::vector<bool> CheckProofOfWorkBatch(const std::vector<CBlockHeader>& headers, const Consensus::Params&);
 
 #endif // BITCOIN_POW_H
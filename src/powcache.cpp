@@ -0,0 +1,124 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "powcache.h"
+
+#include "consensus/params.h"
+#include "crypto/sha256.h"
+#include "primitives/block.h"
+#include "random.h"
+#include "script/sigcache.h"
+#include "util.h"
+
+#include "cuckoocache.h"
+
+#include <atomic>
+
+#include <boost/thread.hpp>
+
+namespace {
+/**
+ * Valid proof of work cache, to avoid recomputing a header's scrypt or hashimoto hash every time it is checked
+ * again: when its block arrives, and whenever the block is read back from disk.
+ */
+class CPoWCache
+{
+private:
+    //! Entries are SHA256(nonce || header hash || proof of work limit):
+    uint256 nonce;
+    typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
+    map_type setValid;
+    boost::shared_mutex cs_powcache;
+    size_t nElements;
+    std::atomic<uint64_t> nHits;
+    std::atomic<uint64_t> nMisses;
+
+public:
+    CPoWCache() : nHits(0), nMisses(0)
+    {
+        GetRandBytes(nonce.begin(), 32);
+        // Usable before InitPoWCache, which resizes it
+        nElements = setValid.setup_bytes(0);
+    }
+
+    void ComputeEntry(uint256& entry, const CBlockHeader& header, const Consensus::Params& params)
+    {
+        uint256 hash = header.GetHash();
+        CSHA256().Write(nonce.begin(), 32).Write(hash.begin(), 32).Write(params.powLimit.begin(), 32).Finalize(entry.begin());
+    }
+
+    bool Get(const uint256& entry)
+    {
+        bool fFound;
+        {
+            boost::shared_lock<boost::shared_mutex> lock(cs_powcache);
+            fFound = setValid.contains(entry, false);
+        }
+        if (fFound)
+            ++nHits;
+        else
+            ++nMisses;
+        return fFound;
+    }
+
+    void Set(const uint256& entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_powcache);
+        setValid.insert(entry);
+    }
+
+    size_t setup_bytes(size_t n)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_powcache);
+        nElements = setValid.setup_bytes(n);
+        return nElements;
+    }
+
+    PoWCacheStats GetStats()
+    {
+        PoWCacheStats stats;
+        {
+            boost::shared_lock<boost::shared_mutex> lock(cs_powcache);
+            stats.nElements = nElements;
+        }
+        stats.nHits = nHits;
+        stats.nMisses = nMisses;
+        return stats;
+    }
+};
+
+static CPoWCache powCache;
+} // namespace
+
+uint256 PoWCacheEntry(const CBlockHeader& header, const Consensus::Params& params)
+{
+    uint256 entry;
+    powCache.ComputeEntry(entry, header, params);
+    return entry;
+}
+
+bool PoWCacheContains(const uint256& entry)
+{
+    return powCache.Get(entry);
+}
+
+void PoWCacheInsert(const uint256& entry)
+{
+    powCache.Set(entry);
+}
+
+PoWCacheStats GetPoWCacheStats()
+{
+    return powCache.GetStats();
+}
+
+void InitPoWCache()
+{
+    // nMaxCacheSize is unsigned. If -maxpowcachesize is set to zero,
+    // setup_bytes creates the minimum possible cache (2 elements).
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, gArgs.GetArg("-maxpowcachesize", DEFAULT_MAX_POW_CACHE_SIZE)), MAX_MAX_POW_CACHE_SIZE) * ((size_t) 1 << 20);
+    size_t nElems = powCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for proof of work cache, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
+}
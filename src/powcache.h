@@ -0,0 +1,39 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_POWCACHE_H
+#define BITCOIN_POWCACHE_H
+
+#include "uint256.h"
+
+#include <stdint.h>
+
+// Valid proofs of work are remembered in 32 byte entries, so 4MB hold over 130000 headers
+static const unsigned int DEFAULT_MAX_POW_CACHE_SIZE = 4;
+// Maximum proof of work cache size allowed
+static const int64_t MAX_MAX_POW_CACHE_SIZE = 1024;
+
+class CBlockHeader;
+namespace Consensus { struct Params; }
+
+struct PoWCacheStats
+{
+    size_t nElements;
+    uint64_t nHits;
+    uint64_t nMisses;
+};
+
+/** Salted cache entry of header's proof of work, which is valid or not depending on params' limit */
+uint256 PoWCacheEntry(const CBlockHeader& header, const Consensus::Params& params);
+/** Returns whether the proof of work of entry was found valid before, counting a hit or a miss */
+bool PoWCacheContains(const uint256& entry);
+/** Remembers that the proof of work of entry is valid */
+void PoWCacheInsert(const uint256& entry);
+/** Returns the cache's capacity and hit and miss counts */
+PoWCacheStats GetPoWCacheStats();
+
+// To be called once in AppInitMain/BasicTestingSetup to initialize the proof of work cache.
+void InitPoWCache();
+
+#endif // BITCOIN_POWCACHE_H
@@ -209,6 +209,7 @@ static bool rest_block(HTTPRequest* req,
         return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
 
     CBlock block;
+    std::shared_ptr<const std::vector<unsigned char>> pblockRaw;
     CBlockIndex* pblockindex = nullptr;
     {
         LOCK(cs_main);
@@ -219,12 +220,20 @@ static bool rest_block(HTTPRequest* req,
         if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not available (pruned data)");
 
-        if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
+        // Serialized blocks with witnesses are sent as they are on disk
+        if (rf != RF_JSON && RPCSerializationFlags() == 0) {
+            if (!ReadRawBlockFromDisk(pblockRaw, pblockindex, Params().MessageStart()))
+                return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        } else if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus())) {
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        }
     }
 
     CDataStream ssBlock(SER_NETWORK, PROTOCOL_VERSION | RPCSerializationFlags());
-    ssBlock << block;
+    if (pblockRaw)
+        ssBlock.write((const char*)pblockRaw->data(), pblockRaw->size());
+    else
+        ssBlock << block;
 
     switch (rf) {
     case RF_BINARY: {
@@ -15,6 +15,7 @@
 #include "core_io.h"
 #include "policy/feerate.h"
 #include "policy/policy.h"
+#include "powcache.h"
 #include "primitives/transaction.h"
 #include "rpc/server.h"
 #include "streams.h"
@@ -771,6 +772,14 @@ UniValue getblock(const JSONRPCRequest& request)
     if (fHavePruned && !(pblockindex->nStatus & BLOCK_HAVE_DATA) && pblockindex->nTx > 0)
         throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
 
+    // A serialized block with witnesses is its bytes on disk, so it doesn't need to be deserialized
+    if (verbosity <= 0 && RPCSerializationFlags() == 0) {
+        std::shared_ptr<const std::vector<unsigned char>> pblockRaw;
+        if (!ReadRawBlockFromDisk(pblockRaw, pblockindex, Params().MessageStart()))
+            throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
+        return HexStr(pblockRaw->begin(), pblockRaw->end());
+    }
+
     if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus()))
         // Block not found on disk. This could be because we have the block
         // header in our index but don't have the block (for example if a
@@ -1369,6 +1378,125 @@ UniValue getmempoolinfo(const JSONRPCRequest& request)
     return mempoolInfoToJSON();
 }
 
+UniValue getpowcacheinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getpowcacheinfo\n"
+            "\nReturns details on the cache of headers whose proof of work was found valid.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"elements\": xxxxx,           (numeric) Number of headers the cache can hold\n"
+            "  \"hits\": xxxxx,               (numeric) Number of checks answered from the cache\n"
+            "  \"misses\": xxxxx              (numeric) Number of checks that had to compute the proof of work hash\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getpowcacheinfo", "")
+            + HelpExampleRpc("getpowcacheinfo", "")
+        );
+
+    PoWCacheStats stats = GetPoWCacheStats();
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("elements", (int64_t)stats.nElements));
+    ret.push_back(Pair("hits", (int64_t)stats.nHits));
+    ret.push_back(Pair("misses", (int64_t)stats.nMisses));
+    return ret;
+}
+
+static UniValue DBStatsToJSON(const CDBWrapper& db)
+{
+    UniValue ret(UniValue::VOBJ);
+    const CDBOptions& dbopts = db.GetDBOptions();
+    UniValue options(UniValue::VOBJ);
+    options.push_back(Pair("maxopenfiles", dbopts.nMaxOpenFiles));
+    options.push_back(Pair("blocksize", (uint64_t)dbopts.nBlockSize));
+    options.push_back(Pair("writebuffer", (uint64_t)dbopts.nWriteBufferSize));
+    options.push_back(Pair("bloombits", dbopts.nBloomBits));
+    options.push_back(Pair("compression", dbopts.fCompression));
+    ret.push_back(Pair("options", options));
+
+    std::string value;
+    if (db.GetProperty("leveldb.approximate-memory-usage", value)) {
+        ret.push_back(Pair("memory", atoi64(value)));
+    }
+
+    uint64_t nLookups, nHits;
+    db.GetCacheStats(nLookups, nHits);
+    UniValue cache(UniValue::VOBJ);
+    cache.push_back(Pair("lookups", nLookups));
+    cache.push_back(Pair("hits", nHits));
+    cache.push_back(Pair("hitrate", nLookups ? (double)nHits / nLookups : 0.0));
+    ret.push_back(Pair("blockcache", cache));
+
+    UniValue levels(UniValue::VARR);
+    for (const CDBLevelStats& stats : db.GetLevelStats()) {
+        UniValue level(UniValue::VOBJ);
+        level.push_back(Pair("files", stats.nFiles));
+        level.push_back(Pair("bytes", stats.nBytes));
+        level.push_back(Pair("compaction_time", stats.dCompactionTime));
+        level.push_back(Pair("compaction_read_mb", stats.dCompactionRead));
+        level.push_back(Pair("compaction_write_mb", stats.dCompactionWrite));
+        levels.push_back(level);
+    }
+    ret.push_back(Pair("levels", levels));
+
+    if (db.GetProperty("leveldb.stats", value)) {
+        ret.push_back(Pair("stats", value));
+    }
+    return ret;
+}
+
+UniValue getdbstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getdbstats\n"
+            "\nReturns LevelDB statistics of the chainstate and block index databases.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"chainstate\": {                (json object) The chainstate database\n"
+            "    \"options\": {                 (json object) Tunables in effect\n"
+            "      \"maxopenfiles\": n,         (numeric) Maximum number of open files\n"
+            "      \"blocksize\": n,            (numeric) Size of table blocks in bytes\n"
+            "      \"writebuffer\": n,          (numeric) Size of the write buffer in bytes, 0 for a quarter of the cache\n"
+            "      \"bloombits\": n,            (numeric) Bloom filter bits per key, 0 for none\n"
+            "      \"compression\": true|false  (boolean) Whether Snappy compression was requested\n"
+            "    },\n"
+            "    \"memory\": n,                 (numeric) Approximate memory used by the block cache and write buffers, in bytes\n"
+            "    \"blockcache\": {              (json object) Block cache lookups since startup\n"
+            "      \"lookups\": n,              (numeric) Number of lookups\n"
+            "      \"hits\": n,                 (numeric) Number of lookups that found the block cached. Without compression, blocks of mmap()ed files are read in place and not cached\n"
+            "      \"hitrate\": x.xxx           (numeric) Fraction of lookups that hit\n"
+            "    },\n"
+            "    \"levels\": [                  (json array) One entry per level\n"
+            "      {\n"
+            "        \"files\": n,              (numeric) Number of table files\n"
+            "        \"bytes\": n,              (numeric) Size of the table files\n"
+            "        \"compaction_time\": x.x,  (numeric) Seconds spent compacting into this level\n"
+            "        \"compaction_read_mb\": n, (numeric) Megabytes read by those compactions\n"
+            "        \"compaction_write_mb\": n (numeric) Megabytes written by those compactions\n"
+            "      }, ...\n"
+            "    ],\n"
+            "    \"stats\": \"...\"              (string) LevelDB's own statistics table\n"
+            "  },\n"
+            "  \"blockindex\": { ... }          (json object) The block index database, as above\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getdbstats", "")
+            + HelpExampleRpc("getdbstats", "")
+        );
+
+    LOCK(cs_main);
+    UniValue ret(UniValue::VOBJ);
+    if (pcoinsdbview) {
+        ret.push_back(Pair("chainstate", DBStatsToJSON(pcoinsdbview->GetDB())));
+    }
+    if (pblocktree) {
+        ret.push_back(Pair("blockindex", DBStatsToJSON(*pblocktree)));
+    }
+    return ret;
+}
+
 UniValue preciousblock(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1)
@@ -1558,11 +1686,13 @@ static const CRPCCommand commands[] =
     { "blockchain",         "getblockhash",           &getblockhash,           true,  {"height"} },
     { "blockchain",         "getblockheader",         &getblockheader,         true,  {"blockhash","verbose"} },
     { "blockchain",         "getchaintips",           &getchaintips,           true,  {} },
+    { "blockchain",         "getdbstats",             &getdbstats,             true,  {} },
     { "blockchain",         "getdifficulty",          &getdifficulty,          true,  {} },
     { "blockchain",         "getmempoolancestors",    &getmempoolancestors,    true,  {"txid","verbose"} },
     { "blockchain",         "getmempooldescendants",  &getmempooldescendants,  true,  {"txid","verbose"} },
     { "blockchain",         "getmempoolentry",        &getmempoolentry,        true,  {"txid"} },
     { "blockchain",         "getmempoolinfo",         &getmempoolinfo,         true,  {} },
+    { "blockchain",         "getpowcacheinfo",        &getpowcacheinfo,        true,  {} },
     { "blockchain",         "getrawmempool",          &getrawmempool,          true,  {"verbose"} },
     { "blockchain",         "gettxout",               &gettxout,               true,  {"txid","n","include_mempool"} },
     { "blockchain",         "gettxoutsetinfo",        &gettxoutsetinfo,        true,  {} },
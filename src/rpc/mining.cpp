@@ -130,34 +130,33 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
             LOCK(cs_main);
             IncrementExtraNonce(pblock, chainActive.Tip(), nExtraNonce);
         }
-        while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount && !CheckProofOfWork(pblock->GetBlockHeader(), Params().GetConsensus(), true, true)) {
-            ++pblock->nNonce;
-            --nMaxTries;
-        }
+        arith_uint256 bnTarget;
+        bnTarget.SetCompact(pblock->nBits);
+        CBlockHeader header = pblock->GetBlockHeader();
+        bool fFound = ScanNonces(header, std::min<uint64_t>(nMaxTries, nInnerLoopCount), bnTarget);
+        // ScanNonces stops on the winning nonce without moving past it, but that nonce was tried as well
+        nMaxTries -= header.nNonce - pblock->nNonce + (fFound ? 1 : 0);
         int64_t nNow = GetTimeMillis();
         LogPrintf("%6.0f thousand hashes per second\n", nInnerLoopCount/((nNow - nStart)/1000.0)/1000.0);
+        if (fFound) {
+            // ScanNonces already filled in the hashMix of the winning hash
+            pblock->nNonce = header.nNonce;
+            pblock->hashMix = header.hashMix;
+            std::shared_ptr<const CBlock> shared_pblock = std::make_shared<const CBlock>(*pblock);
+            if (!ProcessNewBlock(Params(), shared_pblock, true, nullptr))
+                throw JSONRPCError(RPC_INTERNAL_ERROR, "ProcessNewBlock, block not accepted");
+            ++nHeight;
+            blockHashes.push_back(pblock->GetHash().GetHex());
+
+            //mark script as important because it was used at least for one coinbase output if the script came from the wallet
+            if (keepScript)
+            {
+                coinbaseScript->KeepScript();
+            }
+        }
         if (nMaxTries == 0) {
             break;
         }
-        if (pblock->nNonce == nInnerLoopCount) {
-            continue;
-        }
-        if(pblock->nVersion & 0x00000100) {
-            CDAGSystem sys;
-            CHashimotoResult res = sys.FastHashimoto(pblock->GetBlockHeader());
-            pblock->hashMix = res.GetCmix();
-        }
-        std::shared_ptr<const CBlock> shared_pblock = std::make_shared<const CBlock>(*pblock);
-        if (!ProcessNewBlock(Params(), shared_pblock, true, nullptr))
-            throw JSONRPCError(RPC_INTERNAL_ERROR, "ProcessNewBlock, block not accepted");
-        ++nHeight;
-        blockHashes.push_back(pblock->GetHash().GetHex());
-
-        //mark script as important because it was used at least for one coinbase output if the script came from the wallet
-        if (keepScript)
-        {
-            coinbaseScript->KeepScript();
-        }
     }
     return blockHashes;
 }
@@ -454,15 +453,24 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     if (IsInitialBlockDownload())
         throw JSONRPCError(RPC_CLIENT_IN_INITIAL_DOWNLOAD, "Chancoin is downloading blocks...");
 
-    static unsigned int nTransactionsUpdatedLast;
+    const struct VBDeploymentInfo& segwit_info = VersionBitsDeploymentInfo[Consensus::DEPLOYMENT_SEGWIT];
+    // If the caller is indicating segwit support, then allow CreateNewBlock()
+    // to select witness transactions, after segwit activates (otherwise
+    // don't).
+    bool fSupportsSegwit = setClientRules.find(segwit_info.name) != setClientRules.end();
 
     if (!lpval.isNull())
     {
-        // Wait to respond until either the best block changes, OR a minute has passed and there are more transactions
+        // Wait to respond until either the best block changes, the mempool allows a template with more fees,
+        // OR a minute has passed and there are more transactions
         uint256 hashWatchedChain;
         boost::system_time checktxtime;
         unsigned int nTransactionsUpdatedLastLP;
 
+        std::shared_ptr<const CCachedBlockTemplate> cached = blockTemplateCache.Get(Params(), fSupportsSegwit);
+        if (!cached)
+            throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
+
         if (lpval.isStr())
         {
             // Format: <hashBestChain><nTransactionsUpdatedLast>
@@ -474,10 +482,15 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
         else
         {
             // NOTE: Spec does not specify behaviour for non-string longpollid, but this makes testing easier
-            hashWatchedChain = chainActive.Tip()->GetBlockHash();
-            nTransactionsUpdatedLastLP = nTransactionsUpdatedLast;
+            hashWatchedChain = cached->pindexPrev->GetBlockHash();
+            nTransactionsUpdatedLastLP = cached->nTransactionsUpdated;
         }
 
+        // Fees of the template the caller has, if it is still the cached one. Otherwise any template is better.
+        CAmount nFeesWatched = -1;
+        if (cached->pindexPrev->GetBlockHash() == hashWatchedChain && cached->nTransactionsUpdated == nTransactionsUpdatedLastLP)
+            nFeesWatched = cached->GetFees();
+
         // Release the wallet and main lock while waiting
         LEAVE_CRITICAL_SECTION(cs_main);
         {
@@ -486,13 +499,28 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
             boost::unique_lock<boost::mutex> lock(csBestBlock);
             while (chainActive.Tip()->GetBlockHash() == hashWatchedChain && IsRPCRunning())
             {
-                if (!cvBlockChange.timed_wait(lock, checktxtime))
+                boost::system_time waketime = checktxtime;
+                if (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLastLP)
                 {
-                    // Timeout: Check transactions for update
-                    if (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLastLP)
+                    if (boost::get_system_time() >= checktxtime)
+                        break;
+                    lock.unlock();
+                    {
+                        LOCK(cs_main);
+                        cached = blockTemplateCache.Get(Params(), fSupportsSegwit);
+                    }
+                    lock.lock();
+                    if (!cached || cached->GetFees() > nFeesWatched)
                         break;
-                    checktxtime += boost::posix_time::seconds(10);
+                    // The cached template only catches up with the mempool after CBlockTemplateCache::UPDATE_INTERVAL
+                    if (mempool.GetTransactionsUpdated() != cached->nTransactionsUpdated)
+                        waketime = std::min(waketime, boost::get_system_time() + boost::posix_time::seconds(
+                            std::max<int64_t>(1, cached->nTimeUpdated + CBlockTemplateCache::UPDATE_INTERVAL + 1 - GetTime())));
                 }
+                // New transactions and tips notify cvBlockChange, anything else is checked for every 10 seconds
+                if (waketime <= boost::get_system_time())
+                    waketime = boost::get_system_time() + boost::posix_time::seconds(10);
+                cvBlockChange.timed_wait(lock, waketime);
             }
         }
         ENTER_CRITICAL_SECTION(cs_main);
@@ -502,42 +530,15 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
         // TODO: Maybe recheck connections/IBD and (if something wrong) send an expires-immediately template to stop miners?
     }
 
-    const struct VBDeploymentInfo& segwit_info = VersionBitsDeploymentInfo[Consensus::DEPLOYMENT_SEGWIT];
-    // If the caller is indicating segwit support, then allow CreateNewBlock()
-    // to select witness transactions, after segwit activates (otherwise
-    // don't).
-    bool fSupportsSegwit = setClientRules.find(segwit_info.name) != setClientRules.end();
-
     // Update block
-    static CBlockIndex* pindexPrev;
-    static int64_t nStart;
-    static std::unique_ptr<CBlockTemplate> pblocktemplate;
-    // Cache whether the last invocation was with segwit support, to avoid returning
-    // a segwit-block to a non-segwit caller.
-    static bool fLastTemplateSupportsSegwit = true;
-    if (pindexPrev != chainActive.Tip() ||
-        (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 5) ||
-        fLastTemplateSupportsSegwit != fSupportsSegwit)
-    {
-        // Clear pindexPrev so future calls make a new block, despite any failures from here on
-        pindexPrev = nullptr;
-
-        // Store the pindexBest used before CreateNewBlock, to avoid races
-        nTransactionsUpdatedLast = mempool.GetTransactionsUpdated();
-        CBlockIndex* pindexPrevNew = chainActive.Tip();
-        nStart = GetTime();
-        fLastTemplateSupportsSegwit = fSupportsSegwit;
-
-        // Create new block
-        CScript scriptDummy = CScript() << OP_TRUE;
-        pblocktemplate = BlockAssembler(Params()).CreateNewBlock(scriptDummy, fSupportsSegwit);
-        if (!pblocktemplate)
-            throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
-
-        // Need to update only after we know CreateNewBlock succeeded
-        pindexPrev = pindexPrevNew;
-    }
-    CBlock* pblock = &pblocktemplate->block; // pointer for convenience
+    std::shared_ptr<const CCachedBlockTemplate> cached = blockTemplateCache.Get(Params(), fSupportsSegwit);
+    if (!cached)
+        throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
+    const CBlockIndex* pindexPrev = cached->pindexPrev;
+    std::shared_ptr<const CBlockTemplate> pblocktemplate = cached->pblocktemplate;
+    // The template is shared with other callers, so the header is filled in on a copy
+    CBlock block(pblocktemplate->block);
+    CBlock* pblock = &block; // pointer for convenience
     const Consensus::Params& consensusParams = Params().GetConsensus();
 
     // Update nTime
@@ -659,7 +660,7 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     result.push_back(Pair("transactions", transactions));
     result.push_back(Pair("coinbaseaux", aux));
     result.push_back(Pair("coinbasevalue", (int64_t)pblock->vtx[0]->vout[0].nValue));
-    result.push_back(Pair("longpollid", chainActive.Tip()->GetBlockHash().GetHex() + i64tostr(nTransactionsUpdatedLast)));
+    result.push_back(Pair("longpollid", pindexPrev->GetBlockHash().GetHex() + i64tostr(cached->nTransactionsUpdated)));
     result.push_back(Pair("target", hashTarget.GetHex()));
     result.push_back(Pair("mintime", (int64_t)pindexPrev->GetMedianTimePast()+1));
     result.push_back(Pair("mutable", aMutable));
@@ -0,0 +1,713 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "stratum.h"
+
+#include "base58.h"
+#include "chain.h"
+#include "chainparams.h"
+#include "consensus/merkle.h"
+#include "crypto/common.h"
+#include "crypto/dag.h"
+#include "miner.h"
+#include "netbase.h"
+#include "primitives/transaction.h"
+#include "random.h"
+#include "script/standard.h"
+#include "streams.h"
+#include "timedata.h"
+#include "util.h"
+#include "utilstrencodings.h"
+#include "validation.h"
+#include "validationinterface.h"
+#include "workqueue.h"
+
+#include <univalue.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+#include <event2/listener.h>
+#include <event2/thread.h>
+
+/** Maximum length of a request line, past which the miner is disconnected */
+static const size_t MAX_STRATUM_LINE = 16384;
+/** Number of recent jobs that shares are accepted for */
+static const size_t MAX_STRATUM_JOBS = 16;
+/** Seconds between checks for a template with new transactions */
+static const int STRATUM_JOB_REFRESH = 30;
+/** Maximum number of miners connected through each listener */
+static const size_t MAX_STRATUM_CONNECTIONS = 256;
+
+void CreateStratumJob(const CBlockTemplate& blocktemplate, const CScript& scriptPubKey, const std::string& strId, CStratumJob& job)
+{
+    job.strId = strId;
+    job.block = blocktemplate.block;
+
+    // The height comes first in the scriptSig, and the extra nonces are pushed at its very end
+    CMutableTransaction coinbase(*job.block.vtx[0]);
+    coinbase.vout[0].scriptPubKey = scriptPubKey;
+    coinbase.vin[0].scriptSig = CScript() << job.block.height << std::vector<unsigned char>(STRATUM_EXTRANONCE1_SIZE + STRATUM_EXTRANONCE2_SIZE);
+    const CScript& scriptSig = coinbase.vin[0].scriptSig;
+
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS);
+    ss << coinbase;
+    // The scriptSig follows the version, the input count, the prevout and its own length
+    const size_t nEnd = 4 + 1 + 36 + GetSizeOfCompactSize(scriptSig.size()) + scriptSig.size();
+    const size_t nBegin = nEnd - STRATUM_EXTRANONCE1_SIZE - STRATUM_EXTRANONCE2_SIZE;
+    job.vchCoinbase1.assign(ss.begin(), ss.begin() + nBegin);
+    job.vchCoinbase2.assign(ss.begin() + nEnd, ss.end());
+
+    job.block.vtx[0] = MakeTransactionRef(std::move(coinbase));
+    job.vMerkleBranch = BlockMerkleBranch(job.block, 0);
+    job.seed = CDAGSystem::GetSeed(CDAGSystem::GetEpoch(job.block.height));
+    job.bnTarget.SetCompact(job.block.nBits);
+}
+
+bool GetStratumBlock(const CStratumJob& job, const std::vector<unsigned char>& vchExtraNonce1, const std::vector<unsigned char>& vchExtraNonce2,
+                     uint32_t nTime, uint32_t nNonce, CBlock& block)
+{
+    if (vchExtraNonce1.size() != STRATUM_EXTRANONCE1_SIZE || vchExtraNonce2.size() != STRATUM_EXTRANONCE2_SIZE)
+        return false;
+
+    std::vector<unsigned char> vchCoinbase(job.vchCoinbase1);
+    vchCoinbase.insert(vchCoinbase.end(), vchExtraNonce1.begin(), vchExtraNonce1.end());
+    vchCoinbase.insert(vchCoinbase.end(), vchExtraNonce2.begin(), vchExtraNonce2.end());
+    vchCoinbase.insert(vchCoinbase.end(), job.vchCoinbase2.begin(), job.vchCoinbase2.end());
+    CDataStream ss(vchCoinbase, SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS);
+    CMutableTransaction coinbase;
+    ss >> coinbase;
+    // The witness reserved value committed to by the template is not part of what miners see
+    coinbase.vin[0].scriptWitness = job.block.vtx[0]->vin[0].scriptWitness;
+
+    block = job.block;
+    block.vtx[0] = MakeTransactionRef(std::move(coinbase));
+    block.hashMerkleRoot = ComputeMerkleRootFromBranch(block.vtx[0]->GetHash(), job.vMerkleBranch, 0);
+    block.nTime = nTime;
+    block.nNonce = nNonce;
+    block.hashMix.SetNull();
+    return true;
+}
+
+namespace {
+
+/** A miner's connection. Share workers reply through it too, so bev is only used and freed with cs held. */
+struct StratumClient
+{
+    std::mutex cs;
+    struct bufferevent* bev;
+    struct evconnlistener* listener;
+    CService peer;
+    std::vector<unsigned char> vchExtraNonce1;
+    // Only used by the event loop thread
+    bool fSubscribed;
+    bool fAuthorized;
+    std::string strWorker;
+
+    StratumClient(struct bufferevent* bevIn, struct evconnlistener* listenerIn, const CService& peerIn, uint32_t nExtraNonce1) :
+        bev(bevIn), listener(listenerIn), peer(peerIn), vchExtraNonce1(STRATUM_EXTRANONCE1_SIZE), fSubscribed(false), fAuthorized(false)
+    {
+        WriteBE32(vchExtraNonce1.data(), nExtraNonce1);
+    }
+
+    void Send(const UniValue& msg)
+    {
+        std::string str = msg.write() + "\n";
+        std::lock_guard<std::mutex> lock(cs);
+        if (bev)
+            bufferevent_write(bev, str.data(), str.size());
+    }
+
+    void Reply(const UniValue& id, const UniValue& result)
+    {
+        UniValue msg(UniValue::VOBJ);
+        msg.push_back(Pair("id", id));
+        msg.push_back(Pair("result", result));
+        msg.push_back(Pair("error", NullUniValue));
+        Send(msg);
+    }
+
+    void ReplyError(const UniValue& id, int nCode, const std::string& strMessage)
+    {
+        UniValue error(UniValue::VARR);
+        error.push_back(nCode);
+        error.push_back(strMessage);
+        error.push_back(NullUniValue);
+        UniValue msg(UniValue::VOBJ);
+        msg.push_back(Pair("id", id));
+        msg.push_back(Pair("result", NullUniValue));
+        msg.push_back(Pair("error", error));
+        Send(msg);
+    }
+
+    void Notify(const std::string& strMethod, const UniValue& params)
+    {
+        UniValue msg(UniValue::VOBJ);
+        msg.push_back(Pair("id", NullUniValue));
+        msg.push_back(Pair("method", strMethod));
+        msg.push_back(Pair("params", params));
+        Send(msg);
+    }
+};
+
+/** Error codes of mining.submit replies */
+enum StratumError {
+    STRATUM_ERROR_OTHER = 20,
+    STRATUM_ERROR_JOB_NOT_FOUND = 21,
+    STRATUM_ERROR_DUPLICATE_SHARE = 22,
+    STRATUM_ERROR_LOW_DIFFICULTY = 23,
+    STRATUM_ERROR_UNAUTHORIZED = 24,
+    STRATUM_ERROR_NOT_SUBSCRIBED = 25,
+};
+
+struct StratumJobEntry
+{
+    CStratumJob job;
+    /** Template the job was made from, to tell whether the cached one has changed since */
+    std::shared_ptr<const CBlockTemplate> pblocktemplate;
+    std::mutex cs;
+    /** Hashes of the shares submitted for the job, to reject duplicates */
+    std::set<uint256> setShares;
+};
+
+/** Validates a mining.submit on a worker thread, and submits the block if the share solves it */
+class StratumShare
+{
+public:
+    StratumShare(const std::shared_ptr<StratumClient>& clientIn, const UniValue& idIn, const UniValue& paramsIn) :
+        client(clientIn), id(idIn), params(paramsIn)
+    {
+    }
+    void operator()();
+
+private:
+    std::shared_ptr<StratumClient> client;
+    UniValue id;
+    UniValue params;
+};
+
+/** Pushes a new job to miners as soon as the tip changes */
+class CStratumNotifier : public CValidationInterface
+{
+protected:
+    void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
+};
+
+//! libevent event loop, running the listeners, the connections and job notifications
+struct event_base* eventBase = nullptr;
+std::vector<struct evconnlistener*> vListeners;
+//! Pushes the current job to miners, activated by the job thread when it made a new one
+struct event* eventNotify = nullptr;
+std::thread threadStratum;
+//! Makes new jobs on every new tip and every STRATUM_JOB_REFRESH seconds, as templates take cs_main and can be slow
+std::thread threadStratumJob;
+std::mutex cs_jobUpdate;
+std::condition_variable condJobUpdate;
+bool fJobUpdate = false;
+bool fJobInterrupt = false;
+//! Work queue validating shares off the event loop thread
+WorkQueue<StratumShare>* workQueue = nullptr;
+std::unique_ptr<CStratumNotifier> pStratumNotifier;
+//! Connected miners and their number per listener, only used by the event loop thread
+std::map<struct bufferevent*, std::shared_ptr<StratumClient>> mapClients;
+std::map<struct evconnlistener*, size_t> mapListenerClients;
+uint32_t nNextExtraNonce1 = 0;
+unsigned int nJobCounter = 0;
+
+CScript scriptStratum;
+int64_t nStratumDifficulty = DEFAULT_STRATUM_DIFFICULTY;
+arith_uint256 bnShareTarget;
+
+std::mutex cs_jobs;
+//! Recent jobs, newest last
+std::deque<std::shared_ptr<StratumJobEntry>> vJobs;
+//! Whether the jobs made since the last notification voided older ones
+bool fNotifyClean = false;
+
+std::shared_ptr<StratumJobEntry> GetCurrentJob()
+{
+    std::lock_guard<std::mutex> lock(cs_jobs);
+    return vJobs.empty() ? nullptr : vJobs.back();
+}
+
+std::shared_ptr<StratumJobEntry> FindJob(const std::string& strId)
+{
+    std::lock_guard<std::mutex> lock(cs_jobs);
+    for (const std::shared_ptr<StratumJobEntry>& entry : vJobs) {
+        if (entry->job.strId == strId)
+            return entry;
+    }
+    return nullptr;
+}
+
+/**
+ * mining.notify parameters: job id, previous block hash, the two halves of the coinbase, the merkle branch of the
+ * coinbase, version, bits, time, whether older jobs are void, height and epoch seed. Hashes are hex in serialization
+ * order, and version, bits and time are hex of their big endian value.
+ */
+UniValue JobToUniv(const CStratumJob& job, bool fClean)
+{
+    UniValue branch(UniValue::VARR);
+    for (const uint256& hash : job.vMerkleBranch) {
+        branch.push_back(HexStr(hash.begin(), hash.end()));
+    }
+    UniValue params(UniValue::VARR);
+    params.push_back(job.strId);
+    params.push_back(HexStr(job.block.hashPrevBlock.begin(), job.block.hashPrevBlock.end()));
+    params.push_back(HexStr(job.vchCoinbase1));
+    params.push_back(HexStr(job.vchCoinbase2));
+    params.push_back(branch);
+    params.push_back(strprintf("%08x", (uint32_t)job.block.nVersion));
+    params.push_back(strprintf("%08x", job.block.nBits));
+    params.push_back(strprintf("%08x", job.block.nTime));
+    params.push_back(fClean);
+    params.push_back(job.block.height);
+    params.push_back(HexStr(job.seed.begin(), job.seed.end()));
+    return params;
+}
+
+bool ParseHex32(const UniValue& val, uint32_t& n)
+{
+    if (!val.isStr() || val.get_str().size() != 8 || !IsHex(val.get_str()))
+        return false;
+    n = ReadBE32(ParseHex(val.get_str()).data());
+    return true;
+}
+
+void StratumShare::operator()()
+{
+    // Parameters: worker name, job id, extra nonce 2, time and nonce
+    std::shared_ptr<StratumJobEntry> entry = FindJob(params[1].get_str());
+    if (!entry) {
+        client->ReplyError(id, STRATUM_ERROR_JOB_NOT_FOUND, "Job not found");
+        return;
+    }
+    uint32_t nTime, nNonce;
+    const std::string& strExtraNonce2 = params[2].get_str();
+    if (!IsHex(strExtraNonce2) || !ParseHex32(params[3], nTime) || !ParseHex32(params[4], nNonce)) {
+        client->ReplyError(id, STRATUM_ERROR_OTHER, "Invalid parameters");
+        return;
+    }
+    if (nTime < entry->job.block.nTime || nTime > GetAdjustedTime() + MAX_FUTURE_BLOCK_TIME) {
+        client->ReplyError(id, STRATUM_ERROR_OTHER, "Time out of range");
+        return;
+    }
+    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+    if (!GetStratumBlock(entry->job, client->vchExtraNonce1, ParseHex(strExtraNonce2), nTime, nNonce, *pblock)) {
+        client->ReplyError(id, STRATUM_ERROR_OTHER, "Invalid extra nonce");
+        return;
+    }
+
+    uint256 hash;
+    if (pblock->nVersion & 0x00000100) {
+        CHashimotoResult res = CDAGSystem::FastHashimoto(pblock->GetBlockHeader());
+        hash = res.GetResult();
+        pblock->hashMix = res.GetCmix();
+    } else {
+        hash = pblock->GetPoWHash();
+    }
+    if (UintToArith256(hash) > bnShareTarget && UintToArith256(hash) > entry->job.bnTarget) {
+        client->ReplyError(id, STRATUM_ERROR_LOW_DIFFICULTY, "Low difficulty share");
+        return;
+    }
+    // Only shares that were accepted are remembered, so that rejected ones can't fill the set
+    {
+        std::lock_guard<std::mutex> lock(entry->cs);
+        if (!entry->setShares.insert(hash).second) {
+            client->ReplyError(id, STRATUM_ERROR_DUPLICATE_SHARE, "Duplicate share");
+            return;
+        }
+    }
+    LogPrint(BCLog::STRATUM, "Stratum: share %s of job %s from %s\n", hash.ToString(), entry->job.strId, client->peer.ToString());
+
+    if (UintToArith256(hash) <= entry->job.bnTarget) {
+        LogPrintf("Stratum: proof-of-work found for block %s at height %d by %s\n", pblock->GetHash().ToString(), pblock->height, client->peer.ToString());
+        if (!ProcessNewBlock(Params(), pblock, true, nullptr))
+            LogPrintf("Stratum: block %s was not accepted\n", pblock->GetHash().ToString());
+    }
+    client->Reply(id, true);
+}
+
+/** Make a job from the current template, and have it pushed to miners if it differs from the last one */
+void UpdateJob()
+{
+    std::shared_ptr<const CCachedBlockTemplate> cached;
+    try {
+        LOCK(cs_main);
+        if (IsInitialBlockDownload())
+            return;
+        cached = blockTemplateCache.Get(Params(), true);
+    } catch (const std::runtime_error& e) {
+        LogPrintf("Stratum: couldn't create a new block: %s\n", e.what());
+        return;
+    }
+    if (!cached)
+        return;
+
+    std::shared_ptr<StratumJobEntry> current = GetCurrentJob();
+    if (current && current->pblocktemplate == cached->pblocktemplate)
+        return;
+    std::shared_ptr<StratumJobEntry> entry = std::make_shared<StratumJobEntry>();
+    CreateStratumJob(*cached->pblocktemplate, scriptStratum, strprintf("%x", ++nJobCounter), entry->job);
+    entry->pblocktemplate = cached->pblocktemplate;
+    // Shares of older jobs would only be stale once the tip moved on
+    const bool fClean = !current || current->job.block.hashPrevBlock != entry->job.block.hashPrevBlock;
+    {
+        std::lock_guard<std::mutex> lock(cs_jobs);
+        if (fClean)
+            vJobs.clear();
+        vJobs.push_back(entry);
+        if (vJobs.size() > MAX_STRATUM_JOBS)
+            vJobs.pop_front();
+        fNotifyClean |= fClean;
+    }
+    LogPrint(BCLog::STRATUM, "Stratum: job %s at height %d\n", entry->job.strId, entry->job.block.height);
+    event_active(eventNotify, 0, 0);
+}
+
+void ThreadStratumJob()
+{
+    RenameThread("bitcoin-stratumjob");
+    std::unique_lock<std::mutex> lock(cs_jobUpdate);
+    while (true) {
+        condJobUpdate.wait_for(lock, std::chrono::seconds(STRATUM_JOB_REFRESH), [] { return fJobUpdate || fJobInterrupt; });
+        if (fJobInterrupt)
+            break;
+        fJobUpdate = false;
+        lock.unlock();
+        UpdateJob();
+        lock.lock();
+    }
+}
+
+/** Push the newest job to miners. Jobs made since the last call are skipped, only the newest one matters. */
+void notify_cb(evutil_socket_t, short, void*)
+{
+    std::shared_ptr<StratumJobEntry> current;
+    bool fClean;
+    {
+        std::lock_guard<std::mutex> lock(cs_jobs);
+        if (vJobs.empty())
+            return;
+        current = vJobs.back();
+        fClean = fNotifyClean;
+        fNotifyClean = false;
+    }
+    LogPrint(BCLog::STRATUM, "Stratum: notifying job %s to %u miners\n", current->job.strId, mapClients.size());
+    const UniValue params = JobToUniv(current->job, fClean);
+    for (const auto& item : mapClients) {
+        if (item.second->fAuthorized)
+            item.second->Notify("mining.notify", params);
+    }
+}
+
+void CStratumNotifier::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload)
+{
+    if (fInitialDownload)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(cs_jobUpdate);
+        fJobUpdate = true;
+    }
+    condJobUpdate.notify_one();
+}
+
+void DisconnectClient(std::shared_ptr<StratumClient> client)
+{
+    LogPrint(BCLog::STRATUM, "Stratum: disconnecting %s\n", client->peer.ToString());
+    struct bufferevent* bev;
+    {
+        std::lock_guard<std::mutex> lock(client->cs);
+        bev = client->bev;
+        bufferevent_free(client->bev);
+        client->bev = nullptr;
+    }
+    mapClients.erase(bev);
+    mapListenerClients[client->listener]--;
+}
+
+/** Handle one request line. Returns false if the miner should be disconnected. */
+bool HandleRequest(const std::shared_ptr<StratumClient>& client, const std::string& strLine)
+{
+    UniValue request;
+    if (!request.read(strLine) || !request.isObject())
+        return false;
+    const UniValue& id = find_value(request, "id");
+    const UniValue& method = find_value(request, "method");
+    const UniValue& params = find_value(request, "params");
+    if (!method.isStr() || (!params.isNull() && !params.isArray()))
+        return false;
+    const std::string& strMethod = method.get_str();
+
+    if (strMethod == "mining.subscribe") {
+        client->fSubscribed = true;
+        UniValue subscription(UniValue::VARR);
+        subscription.push_back("mining.notify");
+        subscription.push_back(HexStr(client->vchExtraNonce1));
+        UniValue subscriptions(UniValue::VARR);
+        subscriptions.push_back(subscription);
+        UniValue result(UniValue::VARR);
+        result.push_back(subscriptions);
+        result.push_back(HexStr(client->vchExtraNonce1));
+        result.push_back((int)STRATUM_EXTRANONCE2_SIZE);
+        client->Reply(id, result);
+    } else if (strMethod == "mining.authorize") {
+        if (!client->fSubscribed) {
+            client->ReplyError(id, STRATUM_ERROR_NOT_SUBSCRIBED, "Not subscribed");
+            return true;
+        }
+        if (params.size() < 1 || !params[0].isStr()) {
+            client->ReplyError(id, STRATUM_ERROR_OTHER, "Invalid parameters");
+            return true;
+        }
+        // Blocks pay to -stratumaddress, so worker names are only used to tell miners apart in the log
+        client->fAuthorized = true;
+        client->strWorker = params[0].get_str();
+        LogPrint(BCLog::STRATUM, "Stratum: %s authorized as %s\n", client->peer.ToString(), SanitizeString(client->strWorker));
+        client->Reply(id, true);
+
+        UniValue difficulty(UniValue::VARR);
+        difficulty.push_back(nStratumDifficulty);
+        client->Notify("mining.set_difficulty", difficulty);
+        std::shared_ptr<StratumJobEntry> current = GetCurrentJob();
+        if (current)
+            client->Notify("mining.notify", JobToUniv(current->job, true));
+    } else if (strMethod == "mining.submit") {
+        if (!client->fAuthorized) {
+            client->ReplyError(id, STRATUM_ERROR_UNAUTHORIZED, "Unauthorized worker");
+            return true;
+        }
+        if (params.size() < 5) {
+            client->ReplyError(id, STRATUM_ERROR_OTHER, "Invalid parameters");
+            return true;
+        }
+        for (size_t i = 0; i < 5; i++) {
+            if (!params[i].isStr()) {
+                client->ReplyError(id, STRATUM_ERROR_OTHER, "Invalid parameters");
+                return true;
+            }
+        }
+        std::unique_ptr<StratumShare> share(new StratumShare(client, id, params));
+        if (workQueue->Enqueue(share.get())) {
+            share.release();
+        } else {
+            LogPrintf("WARNING: request rejected because Stratum work queue depth exceeded, it can be increased with the -stratumworkqueue= setting\n");
+            client->ReplyError(id, STRATUM_ERROR_OTHER, "Work queue depth exceeded");
+        }
+    } else {
+        client->ReplyError(id, STRATUM_ERROR_OTHER, "Method not found");
+    }
+    return true;
+}
+
+void readcb(struct bufferevent* bev, void*)
+{
+    auto it = mapClients.find(bev);
+    if (it == mapClients.end())
+        return;
+    std::shared_ptr<StratumClient> client = it->second;
+    struct evbuffer* input = bufferevent_get_input(bev);
+    size_t n_read_out = 0;
+    char* line;
+    while ((line = evbuffer_readln(input, &n_read_out, EVBUFFER_EOL_CRLF)) != nullptr) {
+        std::string strLine(line, n_read_out);
+        free(line);
+        if (!HandleRequest(client, strLine)) {
+            LogPrint(BCLog::STRATUM, "Stratum: invalid request from %s\n", client->peer.ToString());
+            DisconnectClient(client);
+            return;
+        }
+    }
+    if (evbuffer_get_length(input) > MAX_STRATUM_LINE) {
+        LogPrint(BCLog::STRATUM, "Stratum: request line from %s too long\n", client->peer.ToString());
+        DisconnectClient(client);
+    }
+}
+
+void eventcb(struct bufferevent* bev, short what, void*)
+{
+    if (!(what & (BEV_EVENT_EOF | BEV_EVENT_ERROR)))
+        return;
+    auto it = mapClients.find(bev);
+    if (it != mapClients.end())
+        DisconnectClient(it->second);
+}
+
+void accept_cb(struct evconnlistener* listener, evutil_socket_t fd, struct sockaddr* addr, int, void*)
+{
+    CService peer;
+    peer.SetSockAddr(addr);
+    if (mapListenerClients[listener] >= MAX_STRATUM_CONNECTIONS) {
+        LogPrint(BCLog::STRATUM, "Stratum: too many connections, rejecting %s\n", peer.ToString());
+        EVUTIL_CLOSESOCKET(fd);
+        return;
+    }
+    struct bufferevent* bev = bufferevent_socket_new(eventBase, fd, BEV_OPT_CLOSE_ON_FREE | BEV_OPT_THREADSAFE);
+    if (!bev) {
+        EVUTIL_CLOSESOCKET(fd);
+        return;
+    }
+    LogPrint(BCLog::STRATUM, "Stratum: accepted connection from %s\n", peer.ToString());
+    mapClients[bev] = std::make_shared<StratumClient>(bev, listener, peer, nNextExtraNonce1++);
+    mapListenerClients[listener]++;
+    bufferevent_setcb(bev, readcb, nullptr, eventcb, nullptr);
+    bufferevent_enable(bev, EV_READ | EV_WRITE);
+}
+
+/** Bind the Stratum server to -stratumbind, or to localhost */
+bool StratumBindAddresses(struct event_base* base)
+{
+    int defaultPort = gArgs.GetArg("-stratumport", DEFAULT_STRATUM_PORT);
+    std::vector<std::string> vBind = gArgs.GetArgs("-stratumbind");
+    if (vBind.empty()) {
+        vBind.push_back("::1");
+        vBind.push_back("127.0.0.1");
+    }
+
+    for (const std::string& strBind : vBind) {
+        CService addrBind;
+        struct sockaddr_storage sockaddr;
+        socklen_t len = sizeof(sockaddr);
+        if (!Lookup(strBind.c_str(), addrBind, defaultPort, false) || !addrBind.GetSockAddr((struct sockaddr*)&sockaddr, &len)) {
+            LogPrintf("Stratum: invalid bind address %s\n", strBind);
+            continue;
+        }
+        LogPrint(BCLog::STRATUM, "Binding Stratum on address %s\n", addrBind.ToString());
+        struct evconnlistener* listener = evconnlistener_new_bind(base, accept_cb, nullptr, LEV_OPT_CLOSE_ON_FREE | LEV_OPT_REUSEABLE, -1,
+                                                                  (struct sockaddr*)&sockaddr, len);
+        if (listener) {
+            vListeners.push_back(listener);
+        } else {
+            LogPrintf("Binding Stratum on address %s failed.\n", addrBind.ToString());
+        }
+    }
+    return !vListeners.empty();
+}
+
+void ThreadStratum(struct event_base* base)
+{
+    RenameThread("bitcoin-stratum");
+    LogPrint(BCLog::STRATUM, "Entering Stratum event loop\n");
+    event_base_dispatch(base);
+    LogPrint(BCLog::STRATUM, "Exited Stratum event loop\n");
+}
+
+void StratumWorkQueueRun(WorkQueue<StratumShare>* queue)
+{
+    RenameThread("bitcoin-stratumworker");
+    queue->Run();
+}
+
+} // namespace
+
+bool InitStratumServer()
+{
+    CBitcoinAddress address(gArgs.GetArg("-stratumaddress", ""));
+    if (!address.IsValid())
+        return false;
+    scriptStratum = GetScriptForDestination(address.Get());
+    nStratumDifficulty = std::max<int64_t>(gArgs.GetArg("-stratumdifficulty", DEFAULT_STRATUM_DIFFICULTY), 1);
+    bnShareTarget = UintToArith256(Params().GetConsensus().powLimit) / arith_uint256(nStratumDifficulty);
+    nNextExtraNonce1 = GetRand(std::numeric_limits<uint32_t>::max());
+
+#ifdef WIN32
+    evthread_use_windows_threads();
+#else
+    evthread_use_pthreads();
+#endif
+    eventBase = event_base_new();
+    if (!eventBase) {
+        LogPrintf("Stratum: Unable to create event_base\n");
+        return false;
+    }
+    if (!StratumBindAddresses(eventBase)) {
+        LogPrintf("Unable to bind any endpoint for Stratum server\n");
+        return false;
+    }
+    eventNotify = event_new(eventBase, -1, 0, notify_cb, nullptr);
+
+    int workQueueDepth = std::max((long)gArgs.GetArg("-stratumworkqueue", DEFAULT_STRATUM_WORKQUEUE), 1L);
+    workQueue = new WorkQueue<StratumShare>(workQueueDepth);
+    pStratumNotifier.reset(new CStratumNotifier());
+    RegisterValidationInterface(pStratumNotifier.get());
+    LogPrint(BCLog::STRATUM, "Initialized Stratum server\n");
+    return true;
+}
+
+void StartStratumServer()
+{
+    int nThreads = std::max((long)gArgs.GetArg("-stratumthreads", DEFAULT_STRATUM_THREADS), 1L);
+    LogPrintf("Stratum: starting %d worker threads\n", nThreads);
+    threadStratum = std::thread(ThreadStratum, eventBase);
+    for (int i = 0; i < nThreads; i++) {
+        std::thread worker(StratumWorkQueueRun, workQueue);
+        worker.detach();
+    }
+    // Have a job ready for the first miners
+    {
+        std::lock_guard<std::mutex> lock(cs_jobUpdate);
+        fJobUpdate = true;
+        fJobInterrupt = false;
+    }
+    threadStratumJob = std::thread(ThreadStratumJob);
+}
+
+void InterruptStratumServer()
+{
+    if (eventBase)
+        event_base_loopbreak(eventBase);
+    if (workQueue)
+        workQueue->Interrupt();
+    {
+        std::lock_guard<std::mutex> lock(cs_jobUpdate);
+        fJobInterrupt = true;
+    }
+    condJobUpdate.notify_one();
+}
+
+void StopStratumServer()
+{
+    if (pStratumNotifier) {
+        UnregisterValidationInterface(pStratumNotifier.get());
+        pStratumNotifier.reset();
+    }
+    if (threadStratumJob.joinable())
+        threadStratumJob.join();
+    if (threadStratum.joinable())
+        threadStratum.join();
+    if (workQueue) {
+        workQueue->WaitExit();
+        delete workQueue;
+        workQueue = nullptr;
+    }
+    while (!mapClients.empty()) {
+        DisconnectClient(mapClients.begin()->second);
+    }
+    for (struct evconnlistener* listener : vListeners) {
+        evconnlistener_free(listener);
+    }
+    vListeners.clear();
+    mapListenerClients.clear();
+    if (eventNotify) {
+        event_free(eventNotify);
+        eventNotify = nullptr;
+    }
+    if (eventBase) {
+        event_base_free(eventBase);
+        eventBase = nullptr;
+    }
+    std::lock_guard<std::mutex> lock(cs_jobs);
+    vJobs.clear();
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/**
+ * Stratum v1 mining server, running on its own libevent base.
+ */
+#ifndef BITCOIN_STRATUM_H
+#define BITCOIN_STRATUM_H
+
+#include "arith_uint256.h"
+#include "primitives/block.h"
+#include "script/script.h"
+#include "uint256.h"
+
+#include <array>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct CBlockTemplate;
+
+static const bool DEFAULT_STRATUM_ENABLE = false;
+static const int DEFAULT_STRATUM_PORT = 3333;
+static const int DEFAULT_STRATUM_THREADS = 2;
+static const int DEFAULT_STRATUM_WORKQUEUE = 64;
+/** Default for -stratumdifficulty: shares must meet the proof-of-work limit divided by this */
+static const int64_t DEFAULT_STRATUM_DIFFICULTY = 1;
+
+/** Bytes of the coinbase extra nonce picked by the server for each connection */
+static const unsigned int STRATUM_EXTRANONCE1_SIZE = 4;
+/** Bytes of the coinbase extra nonce picked by the miner for each share */
+static const unsigned int STRATUM_EXTRANONCE2_SIZE = 4;
+
+/**
+ * A block template as pushed to miners with mining.notify. The coinbase is split around the extra nonces, so that
+ * miners can rebuild it and fold it into the merkle root with the coinbase's merkle branch.
+ */
+struct CStratumJob
+{
+    std::string strId;
+    /** Template the job was made from, with the coinbase still missing its extra nonces */
+    CBlock block;
+    /** Serialized coinbase, without witness, before and after the extra nonces */
+    std::vector<unsigned char> vchCoinbase1;
+    std::vector<unsigned char> vchCoinbase2;
+    std::vector<uint256> vMerkleBranch;
+    /** Seed of the DAG epoch of the block's height */
+    std::array<uint8_t, 32> seed;
+    arith_uint256 bnTarget;
+};
+
+/** Make a job paying the template's coinbase value to scriptPubKey */
+void CreateStratumJob(const CBlockTemplate& blocktemplate, const CScript& scriptPubKey, const std::string& strId, CStratumJob& job);
+
+/**
+ * Fill in block from job and the fields of a mining.submit: the coinbase with both extra nonces, the merkle root, the
+ * time and the nonce. Returns false if the extra nonces don't have the expected sizes.
+ */
+bool GetStratumBlock(const CStratumJob& job, const std::vector<unsigned char>& vchExtraNonce1, const std::vector<unsigned char>& vchExtraNonce2,
+                     uint32_t nTime, uint32_t nNonce, CBlock& block);
+
+/** Initialize the Stratum server, binding -stratumbind. Requires -stratumaddress. */
+bool InitStratumServer();
+/** Start the Stratum event loop and share workers */
+void StartStratumServer();
+/** Stop accepting connections and work */
+void InterruptStratumServer();
+/** Stop the Stratum server and disconnect all miners */
+void StopStratumServer();
+
+#endif // BITCOIN_STRATUM_H
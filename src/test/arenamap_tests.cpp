@@ -0,0 +1,131 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "arenamap.h"
+#include "memusage.h"
+
+#include "test/test_bitcoin.h"
+
+#include <unordered_map>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+struct TestHasher
+{
+    // Few distinct hashes, so that probe sequences collide and wrap around
+    size_t operator()(uint32_t key) const { return key % 37; }
+};
+
+typedef arenamap<uint32_t, std::vector<uint32_t>, TestHasher> TestMap;
+
+void CheckEqual(const TestMap& map, const std::unordered_map<uint32_t, std::vector<uint32_t>>& real)
+{
+    BOOST_CHECK_EQUAL(map.size(), real.size());
+    BOOST_CHECK_EQUAL(map.empty(), real.empty());
+    size_t count = 0;
+    for (TestMap::const_iterator it = map.begin(); it != map.end(); ++it) {
+        auto itReal = real.find(it->first);
+        BOOST_CHECK(itReal != real.end() && itReal->second == it->second);
+        count++;
+    }
+    BOOST_CHECK_EQUAL(count, real.size());
+    for (const auto& entry : real) {
+        BOOST_CHECK(map.count(entry.first) == 1 && map.at(entry.first) == entry.second);
+    }
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(arenamap_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(arenamap_random)
+{
+    TestMap map;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> real;
+    for (int i = 0; i < 20000; i++) {
+        uint32_t key = InsecureRandRange(500);
+        switch (InsecureRandRange(5)) {
+        case 0:
+        case 1: {
+            bool inserted = map.emplace(key, std::vector<uint32_t>(1, i)).second;
+            BOOST_CHECK_EQUAL(inserted, real.emplace(key, std::vector<uint32_t>(1, i)).second);
+            break;
+        }
+        case 2:
+            map[key].push_back(i);
+            real[key].push_back(i);
+            break;
+        case 3:
+            BOOST_CHECK_EQUAL(map.erase(key), real.erase(key));
+            break;
+        case 4: {
+            TestMap::iterator it = map.find(key);
+            BOOST_CHECK_EQUAL(it == map.end(), real.count(key) == 0);
+            if (it != map.end()) {
+                map.erase(it);
+                real.erase(key);
+            }
+            break;
+        }
+        }
+        if (i % 1000 == 0) {
+            CheckEqual(map, real);
+        }
+    }
+    CheckEqual(map, real);
+
+    map.clear();
+    real.clear();
+    CheckEqual(map, real);
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(map), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(arenamap_erase_while_iterating)
+{
+    TestMap map;
+    for (uint32_t i = 0; i < 1000; i++) {
+        map.emplace(i, std::vector<uint32_t>(1, i));
+    }
+    size_t count = 0;
+    for (TestMap::iterator it = map.begin(); it != map.end(); ) {
+        count++;
+        if (it->first % 3) {
+            it = map.erase(it);
+        } else {
+            map.erase(it++);
+        }
+    }
+    BOOST_CHECK_EQUAL(count, 1000U);
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK(map.begin() == map.end());
+}
+
+BOOST_AUTO_TEST_CASE(arenamap_stable_references)
+{
+    TestMap map;
+    std::vector<uint32_t>& first = map[0];
+    first.push_back(7);
+    // Growing the index and adding chunks doesn't move entries
+    for (uint32_t i = 1; i < 1000; i++) {
+        map[i].push_back(i);
+    }
+    BOOST_CHECK(&first == &map.at(0));
+    BOOST_CHECK(first == std::vector<uint32_t>(1, 7));
+
+    // Erased positions are reused
+    size_t usage = memusage::DynamicUsage(map);
+    for (uint32_t i = 0; i < 500; i++) {
+        map.erase(i);
+    }
+    for (uint32_t i = 1000; i < 1500; i++) {
+        map[i];
+    }
+    BOOST_CHECK_EQUAL(memusage::DynamicUsage(map), usage);
+    BOOST_CHECK_EQUAL(map.size(), 1000U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,7 @@
 
 #include "coins.h"
 #include "script/standard.h"
+#include "txdb.h"
 #include "uint256.h"
 #include "undo.h"
 #include "utilstrencodings.h"
@@ -210,7 +211,12 @@ BOOST_AUTO_TEST_CASE(coins_cache_simulation_test)
             // Every 100 iterations, flush an intermediate cache
             if (stack.size() > 1 && InsecureRandBool() == 0) {
                 unsigned int flushIndex = InsecureRandRange(stack.size() - 1);
-                stack[flushIndex]->Flush();
+                if (InsecureRandBool()) {
+                    stack[flushIndex]->Flush();
+                } else {
+                    // Keep some of the cache
+                    stack[flushIndex]->FlushAndTrim(InsecureRandRange(stack[flushIndex]->DynamicMemoryUsage() + 1));
+                }
             }
         }
         if (InsecureRandRange(100) == 0) {
@@ -855,4 +861,105 @@ BOOST_AUTO_TEST_CASE(ccoins_write)
                     CheckWriteCoins(parent_value, child_value, parent_value, parent_flags, child_flags, parent_flags);
 }
 
+BOOST_AUTO_TEST_CASE(ccoins_cache_coin)
+{
+    CCoinsViewTest base;
+    CCoinsViewCacheTest cache(&base);
+    const COutPoint outpoint(InsecureRand256(), 0);
+    const Coin coin(CTxOut(10, CScript() << OP_TRUE), 1, false);
+
+    // A coin looked up ahead of time is cached clean, as a lookup through the cache would have
+    cache.CacheCoin(outpoint, Coin(coin));
+    BOOST_CHECK(cache.HaveCoinInCache(outpoint));
+    BOOST_CHECK(cache.map().at(outpoint).flags == 0);
+    cache.SelfTest();
+
+    // An outpoint that is cached already is left alone
+    cache.CacheCoin(outpoint, Coin(CTxOut(20, CScript() << OP_TRUE), 2, false));
+    BOOST_CHECK(cache.AccessCoin(outpoint) == coin);
+    cache.SelfTest();
+
+    // Nothing is written back
+    BOOST_CHECK(cache.Flush());
+    Coin tmp;
+    BOOST_CHECK(!base.GetCoin(outpoint, tmp));
+}
+
+BOOST_AUTO_TEST_CASE(ccoins_flush_and_trim)
+{
+    CCoinsViewTest base;
+    CCoinsViewCacheTest cache(&base);
+    std::vector<COutPoint> outpoints;
+    for (int i = 0; i < 1000; i++) {
+        outpoints.emplace_back(InsecureRand256(), 0);
+        cache.AddCoin(outpoints.back(), Coin(CTxOut(10, CScript() << OP_TRUE), 1, false), false);
+    }
+    // Use the first hundred coins again, and spend one of them
+    for (int i = 0; i < 100; i++) {
+        BOOST_CHECK(cache.HaveCoin(outpoints[i]));
+    }
+    BOOST_CHECK(cache.SpendCoin(outpoints[0]));
+
+    // Everything is written, and the most recently used coins are kept clean within a fifth of the cache
+    BOOST_CHECK(cache.FlushAndTrim(cache.DynamicMemoryUsage() / 5));
+    cache.SelfTest();
+    BOOST_CHECK(cache.GetCacheSize() >= 99 && cache.GetCacheSize() <= 200);
+    for (int i = 1; i < 100; i++) {
+        BOOST_CHECK(cache.HaveCoinInCache(outpoints[i]));
+    }
+    BOOST_CHECK(!cache.map().count(outpoints[0]));
+    for (const auto& entry : cache.map()) {
+        BOOST_CHECK(entry.second.flags == 0);
+    }
+    Coin tmp;
+    BOOST_CHECK(!base.GetCoin(outpoints[0], tmp));
+    for (int i = 1; i < 1000; i++) {
+        BOOST_CHECK(base.GetCoin(outpoints[i], tmp));
+    }
+
+    // A kept coin can still be spent, and that is written out
+    BOOST_CHECK(cache.SpendCoin(outpoints[1]));
+    BOOST_CHECK(cache.FlushAndTrim(0));
+    BOOST_CHECK(cache.GetCacheSize() == 0);
+    BOOST_CHECK(!base.GetCoin(outpoints[1], tmp) || tmp.IsSpent());
+}
+
+BOOST_FIXTURE_TEST_CASE(ccoins_background_flush, TestingSetup)
+{
+    CCoinsViewDB db(1 << 20, true);
+    CCoinsViewBackgroundFlush flush(&db, &db);
+    CCoinsViewCache cache(&flush);
+    const COutPoint outpoint(InsecureRand256(), 0);
+    const Coin coin(CTxOut(10, CScript() << OP_TRUE), 1, false);
+    const uint256 hashBlock1 = InsecureRand256(), hashBlock2 = InsecureRand256();
+    Coin tmp;
+
+    // The coin can be read while it is written, and ends up in the database
+    cache.AddCoin(outpoint, Coin(coin), false);
+    cache.SetBestBlock(hashBlock1);
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK(cache.GetCacheSize() == 0);
+    BOOST_CHECK(flush.GetBestBlock() == hashBlock1);
+    BOOST_CHECK(flush.GetCoin(outpoint, tmp) && tmp == coin);
+    BOOST_CHECK(cache.AccessCoin(outpoint) == coin);
+    BOOST_CHECK(flush.Sync());
+    // Nothing is held for the write once it is done
+    BOOST_CHECK_EQUAL(flush.DynamicMemoryUsage(), 0U);
+    BOOST_CHECK(db.GetBestBlock() == hashBlock1);
+    BOOST_CHECK(db.GetHeadBlocks().empty());
+    BOOST_CHECK(db.GetCoin(outpoint, tmp) && tmp == coin);
+
+    // Spending it is seen at once, and erases it from the database
+    BOOST_CHECK(cache.SpendCoin(outpoint));
+    cache.SetBestBlock(hashBlock2);
+    BOOST_CHECK(cache.Flush());
+    BOOST_CHECK(!flush.HaveCoin(outpoint));
+    BOOST_CHECK(!flush.GetCoin(outpoint, tmp));
+    BOOST_CHECK(!cache.HaveCoin(outpoint));
+    BOOST_CHECK(flush.Sync());
+    BOOST_CHECK(!flush.Failed());
+    BOOST_CHECK(db.GetBestBlock() == hashBlock2);
+    BOOST_CHECK(!db.HaveCoin(outpoint));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
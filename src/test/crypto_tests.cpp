@@ -3,13 +3,18 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "crypto/aes.h"
+#include "crypto/Lyra2.h"
+#include "crypto/Lyra2RE.h"
 #include "crypto/chacha20.h"
 #include "crypto/ripemd160.h"
 #include "crypto/sha1.h"
 #include "crypto/sha256.h"
 #include "crypto/sha512.h"
+#include "crypto/sph_autodetect.h"
+#include "crypto/sph_cubehash.h"
 #include "crypto/hmac_sha256.h"
 #include "crypto/hmac_sha512.h"
+#include "hash.h"
 #include "random.h"
 #include "utilstrencodings.h"
 #include "test/test_bitcoin.h"
@@ -268,6 +273,25 @@ BOOST_AUTO_TEST_CASE(sha256_testvectors) {
     TestSHA256(test1, "a316d55510b49662420f49d145d42fb83f31ef8dc016aa4e32df049991a91e26");
 }
 
+BOOST_AUTO_TEST_CASE(sha256d64)
+{
+    BOOST_TEST_MESSAGE("SHA256 implementation: " + SHA256AutoDetect());
+    // Numbers of inputs around the 8-way batches, hashed apart and in place
+    for (int blocks = 0; blocks <= 34; blocks++) {
+        std::vector<unsigned char> in(64 * blocks), out(32 * blocks), expected(32 * blocks);
+        for (unsigned char& c : in) {
+            c = InsecureRandBits(8);
+        }
+        for (int i = 0; i < blocks; i++) {
+            CHash256().Write(&in[64 * i], 64).Finalize(&expected[32 * i]);
+        }
+        SHA256D64(out.data(), in.data(), blocks);
+        BOOST_CHECK(out == expected);
+        SHA256D64(in.data(), in.data(), blocks);
+        BOOST_CHECK(std::equal(expected.begin(), expected.end(), in.begin()));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(sha512_testvectors) {
     TestSHA512("",
                "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
@@ -483,6 +507,139 @@ BOOST_AUTO_TEST_CASE(chacha20_testvector)
                  "fab78c9");
 }
 
+BOOST_AUTO_TEST_CASE(lyra2_scratch)
+{
+    // Known answers, computed with the implementation from before scratch matrices could be reused
+    std::vector<unsigned char> pwd(32), header(80), key(32), hash(32);
+    for (size_t i = 0; i < pwd.size(); i++) pwd[i] = i;
+    for (size_t i = 0; i < header.size(); i++) header[i] = i;
+    const std::string expected_key = "6e30062cecbe4c53612da9305a36d7e89ca9983efcf86498596d1751e718aa73";
+    BOOST_CHECK_EQUAL(LYRA2(key.data(), 32, pwd.data(), 32, pwd.data(), 32, 1, 4, 4), 0);
+    BOOST_CHECK_EQUAL(HexStr(key), expected_key);
+    std::vector<uint64_t> matrix(LYRA2_MATRIX_INT64(4, 4), ~(uint64_t)0);
+    BOOST_CHECK_EQUAL(LYRA2_scratch(key.data(), 32, pwd.data(), 32, pwd.data(), 32, 1, 4, 4, matrix.data()), 0);
+    BOOST_CHECK_EQUAL(HexStr(key), expected_key);
+    lyra2re2_hash((const char*)header.data(), (char*)hash.data());
+    BOOST_CHECK_EQUAL(HexStr(hash), "2246faafca15a01a35c81a3f801fe8338942565bdb75a505517372aa0c7afdd0");
+
+    // A reused scratch matrix must give the same key as a freshly allocated one
+    for (int i = 0; i < 4; i++) {
+        uint256 pwd = InsecureRand256();
+        uint256 expected, key;
+        BOOST_CHECK_EQUAL(LYRA2(expected.begin(), 32, pwd.begin(), 32, pwd.begin(), 32, 1, 4, 4), 0);
+        BOOST_CHECK_EQUAL(LYRA2_scratch(key.begin(), 32, pwd.begin(), 32, pwd.begin(), 32, 1, 4, 4, matrix.data()), 0);
+        BOOST_CHECK(key == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(lyra2re2_midstate_hash)
+{
+    // Hashing from a midstate must match the full hash for any change to the last 16 bytes
+    std::vector<unsigned char> input(80);
+    for (unsigned char& c : input) c = InsecureRandBits(8);
+    lyra2re2_midstate midstate;
+    lyra2re2_midstate_init(&midstate, (const char*)input.data());
+    for (int i = 0; i < 8; i++) {
+        for (int j = 64; j < 80; j++) input[j] = InsecureRandBits(8);
+        uint256 expected, hash;
+        lyra2re2_hash((const char*)input.data(), (char*)expected.begin());
+        lyra2re2_hash_midstate(&midstate, (const char*)input.data() + 64, (char*)hash.begin());
+        BOOST_CHECK(hash == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cubehash_implementations)
+{
+    // The autodetected round function must hash like the portable one, for inputs split across several blocks
+    std::vector<unsigned char> input(200);
+    for (unsigned char& c : input) c = InsecureRandBits(8);
+    std::vector<uint256> expected;
+    sph_cubehash_set_rounds(nullptr);
+    for (size_t len = 0; len <= input.size(); len += 7) {
+        sph_cubehash256_context ctx;
+        sph_cubehash256_init(&ctx);
+        sph_cubehash256(&ctx, input.data(), len / 3);
+        sph_cubehash256(&ctx, input.data() + len / 3, len - len / 3);
+        expected.emplace_back();
+        sph_cubehash256_close(&ctx, expected.back().begin());
+    }
+    uint256 lyra2re2_expected;
+    lyra2re2_hash((const char*)input.data(), (char*)lyra2re2_expected.begin());
+
+    BOOST_TEST_MESSAGE("CubeHash implementation: " + CubeHashAutoDetect());
+    for (size_t len = 0, i = 0; len <= input.size(); len += 7, i++) {
+        sph_cubehash256_context ctx;
+        uint256 hash;
+        sph_cubehash256_init(&ctx);
+        sph_cubehash256(&ctx, input.data(), len / 3);
+        sph_cubehash256(&ctx, input.data() + len / 3, len - len / 3);
+        sph_cubehash256_close(&ctx, hash.begin());
+        BOOST_CHECK(hash == expected[i]);
+    }
+    uint256 hash;
+    lyra2re2_hash((const char*)input.data(), (char*)hash.begin());
+    BOOST_CHECK(hash == lyra2re2_expected);
+}
+
+BOOST_AUTO_TEST_CASE(lyra2_implementations)
+{
+    // The autodetected sponge and LYRA2_4way must derive the portable keys, including keys of several blocks
+    static const uint64_t params[][4] = {{32, 1, 4, 4}, {32, 1, 8, 8}, {200, 1, 3, 5}, {96, 1, 6, 2}};
+    std::vector<std::vector<unsigned char>> pwds(LYRA2_LANES, std::vector<unsigned char>(32));
+    for (auto& pwd : pwds) {
+        for (unsigned char& c : pwd) c = InsecureRandBits(8);
+    }
+    std::vector<std::vector<unsigned char>> expected;
+    LYRA2_set_impl(nullptr);
+    for (const uint64_t* p : params) {
+        for (auto& pwd : pwds) {
+            expected.emplace_back(p[0]);
+            BOOST_CHECK_EQUAL(LYRA2(expected.back().data(), p[0], pwd.data(), 32, pwd.data(), 16, p[1], p[2], p[3]), 0);
+        }
+    }
+    std::vector<std::vector<unsigned char>> inputs(2 * LYRA2_LANES + 1, std::vector<unsigned char>(80));
+    std::vector<uint256> hashes_expected(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+        for (unsigned char& c : inputs[i]) c = InsecureRandBits(8);
+        lyra2re2_hash((const char*)inputs[i].data(), (char*)hashes_expected[i].begin());
+    }
+
+    BOOST_TEST_MESSAGE("Lyra2 implementation: " + Lyra2AutoDetect());
+    size_t i = 0;
+    for (const uint64_t* p : params) {
+        std::vector<uint64_t> matrix(LYRA2_LANES * LYRA2_MATRIX_INT64(p[2], p[3]));
+        std::vector<std::vector<unsigned char>> keys(LYRA2_LANES, std::vector<unsigned char>(p[0]));
+        void* k[LYRA2_LANES];
+        const void* pwd[LYRA2_LANES];
+        for (int l = 0; l < LYRA2_LANES; l++) {
+            std::vector<unsigned char> key(p[0]);
+            BOOST_CHECK_EQUAL(LYRA2_scratch(key.data(), p[0], pwds[l].data(), 32, pwds[l].data(), 16, p[1], p[2], p[3], matrix.data()), 0);
+            BOOST_CHECK(key == expected[i + l]);
+            k[l] = keys[l].data();
+            pwd[l] = pwds[l].data();
+        }
+        BOOST_CHECK_EQUAL(LYRA2_4way(k, p[0], pwd, 32, pwd, 16, p[1], p[2], p[3], matrix.data()), 0);
+        for (int l = 0; l < LYRA2_LANES; l++) {
+            BOOST_CHECK(keys[l] == expected[i + l]);
+        }
+        i += LYRA2_LANES;
+    }
+    // Batches of lyra2re2 hashes, with and without a short last group
+    for (size_t n = 1; n <= inputs.size(); n++) {
+        std::vector<uint256> hashes(n);
+        std::vector<const char*> in;
+        std::vector<char*> out;
+        for (size_t j = 0; j < n; j++) {
+            in.push_back((const char*)inputs[j].data());
+            out.push_back((char*)hashes[j].begin());
+        }
+        lyra2re2_hash_batch(in.data(), out.data(), n);
+        for (size_t j = 0; j < n; j++) {
+            BOOST_CHECK(hashes[j] == hashes_expected[j]);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(countbits_tests)
 {
     FastRandomContext ctx;
@@ -0,0 +1,154 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chainparams.h"
+#include "crypto/dag.h"
+#include "crypto/dag_sizes.h"
+#include "pow.h"
+#include "primitives/block.h"
+#include "test/test_bitcoin.h"
+
+#include <algorithm>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(dag_tests, BasicTestingSetup)
+
+static CBlockHeader DAGTestHeader(int32_t height)
+{
+    CBlockHeader header;
+    header.nVersion = 0x20000100;
+    header.hashPrevBlock.SetHex("00000000000000000000000000000000000000000000000000000000deadbeef");
+    header.hashMerkleRoot.SetHex("1111111111111111111111111111111111111111111111111111111111111111");
+    header.nTime = 1500000000 + height;
+    header.nBits = 0x1e0ffff0;
+    header.nNonce = 42 + height;
+    header.height = height;
+    return header;
+}
+
+BOOST_AUTO_TEST_CASE(hashimoto_light)
+{
+    struct {
+        int32_t height;
+        const char* cmix;
+        const char* result;
+    } vectors[] = {
+        {5, "37b3d53bf7ee6eb9afa8c779489cf53e", "11bb8e089e3f5c7c8acc54567cc65b0222cab0875debdfaf4cc44e2185a15a99"},
+        {12345, "b0572741941fdcbbb9f2025ed466c14a", "3d61ec404b1d1eec1b38b14179803cc0050784f9eed1ef49d27df138c98b4779"},
+        {3199, "fd839978c8a52f66c2eb6c7dcedc67ad", "cf79589404f0b2016f3389c8f9b78ad7f473c42fe1fa22b19d429b6477d74201"},
+    };
+    for (const auto& v : vectors) {
+        CHashimotoResult res = CDAGSystem::Hashimoto(DAGTestHeader(v.height));
+        BOOST_CHECK_EQUAL(res.GetCmix().GetHex(), v.cmix);
+        BOOST_CHECK_EQUAL(res.GetResult().GetHex(), v.result);
+    }
+
+    // Concurrent hashing, including the first use of an epoch, gives the same results
+    std::vector<std::thread> threads;
+    std::vector<std::string> results(4);
+    for (size_t t = 0; t < results.size(); t++) {
+        threads.emplace_back([&results, t] { results[t] = CDAGSystem::Hashimoto(DAGTestHeader(400 * 11 + t)).GetResult().GetHex(); });
+    }
+    for (std::thread& t : threads)
+        t.join();
+    for (size_t t = 0; t < results.size(); t++) {
+        BOOST_CHECK_EQUAL(results[t], CDAGSystem::Hashimoto(DAGTestHeader(400 * 11 + t)).GetResult().GetHex());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hashimoto_batch)
+{
+    // Runs of different lengths and epochs, so that both full and partial sets of node lanes are used
+    const int32_t heights[] = {5, 6, 7, 8, 9, 3199, 12345, 12340, 12341, 4400, 4401, 4402, 4403, 4404, 4405};
+    std::vector<CBlockHeader> headers;
+    for (int32_t height : heights) {
+        headers.push_back(DAGTestHeader(height));
+        headers.back().nBits = 0x207fffff;
+    }
+
+    // Spread the batches over worker threads, as the node does
+    boost::thread_group threadGroup;
+    for (int i = 0; i < 3; i++)
+        threadGroup.create_thread(&ThreadHashimoto);
+
+    std::vector<CHashimotoResult> results;
+    HashimotoBatch(headers, results);
+    BOOST_CHECK_EQUAL(results.size(), headers.size());
+    for (size_t i = 0; i < headers.size(); i++) {
+        CHashimotoResult res = CDAGSystem::Hashimoto(headers[i]);
+        BOOST_CHECK(results[i].GetCmix() == res.GetCmix());
+        BOOST_CHECK(results[i].GetResult() == res.GetResult());
+    }
+
+    // The batch check agrees with CheckProofOfWork up to the first failing header, and leaves non-DAG headers to it
+    const auto regtest = CreateChainParams(CBaseChainParams::REGTEST);
+    const Consensus::Params& params = regtest->GetConsensus();
+    for (size_t i = 0; i < headers.size(); i++)
+        headers[i].hashMix = results[i].GetCmix();
+    headers[2].nVersion = 0x20000000;
+    std::vector<bool> valid = CheckProofOfWorkBatch(headers, params);
+    BOOST_CHECK_EQUAL(valid.size(), headers.size());
+    BOOST_CHECK(!valid[2]);
+    bool fFailed = false;
+    int nValid = 0;
+    for (size_t i = 0; i < headers.size(); i++) {
+        if (i == 2)
+            continue;
+        bool fValid = CheckProofOfWork(headers[i], params);
+        BOOST_CHECK_EQUAL(valid[i], fValid && !fFailed);
+        fFailed |= !fValid;
+        nValid += valid[i];
+    }
+    BOOST_CHECK(nValid > 0);
+
+    // Nothing after a failing header is checked. The headers are changed so that none of them is cached yet.
+    for (CBlockHeader& header : headers)
+        header.nTime++;
+    HashimotoBatch(headers, results);
+    for (size_t i = 0; i < headers.size(); i++)
+        headers[i].hashMix = results[i].GetCmix();
+    headers[0].hashMix.SetNull();
+    valid = CheckProofOfWorkBatch(headers, params);
+    BOOST_CHECK(std::find(valid.begin(), valid.end(), true) == valid.end());
+
+    threadGroup.interrupt_all();
+    threadGroup.join_all();
+}
+
+BOOST_AUTO_TEST_CASE(dag_tip_window)
+{
+    CDAGSystem::SetTipEpoch(11);
+    for (int32_t epoch : {10, 11, 12, 40, 41, 42})
+        CDAGSystem::Hashimoto(DAGTestHeader(400 * epoch));
+    // Headers far from the tip only displace each other
+    for (uint64_t epoch : {10, 11, 12, 41, 42})
+        BOOST_CHECK(CDAGSystem::HasCache(epoch));
+    BOOST_CHECK(!CDAGSystem::HasCache(40));
+
+    // Moving the tip drops the epoch that left its window
+    CDAGSystem::SetTipEpoch(12);
+    BOOST_CHECK(!CDAGSystem::HasCache(10));
+    for (uint64_t epoch : {11, 12, 41, 42})
+        BOOST_CHECK(CDAGSystem::HasCache(epoch));
+}
+
+BOOST_AUTO_TEST_CASE(dag_sizes)
+{
+    for (uint64_t epoch = 0; epoch < DAG_SIZES_EPOCHS; epoch++) {
+        BOOST_CHECK_EQUAL(CDAGSystem::GetCacheSize(epoch), CDAGSystem::CalcCacheSize(epoch));
+        BOOST_CHECK_EQUAL(CDAGSystem::GetGraphSize(epoch), CDAGSystem::CalcGraphSize(epoch));
+    }
+    // Past the tables sizes are computed, and remembered for the next call
+    for (int i = 0; i < 2; i++) {
+        for (uint64_t epoch : {DAG_SIZES_EPOCHS, DAG_SIZES_EPOCHS + 1, (uint64_t)5000000}) {
+            BOOST_CHECK_EQUAL(CDAGSystem::GetCacheSize(epoch), CDAGSystem::CalcCacheSize(epoch));
+            BOOST_CHECK_EQUAL(CDAGSystem::GetGraphSize(epoch), CDAGSystem::CalcGraphSize(epoch));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
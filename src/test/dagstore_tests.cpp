@@ -0,0 +1,119 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "crypto/dag.h"
+#include "dagstore.h"
+#include "fs.h"
+#include "primitives/block.h"
+#include "test/test_bitcoin.h"
+
+#include <algorithm>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(dagstore_tests, BasicTestingSetup)
+
+static CBlockHeader DAGStoreTestHeader(int32_t height)
+{
+    CBlockHeader header;
+    header.nVersion = 0x20000100;
+    header.nTime = 1500000000 + height;
+    header.nBits = 0x1e0ffff0;
+    header.height = height;
+    return header;
+}
+
+static void CorruptLastByte(const fs::path& path)
+{
+    FILE* file = fsbridge::fopen(path, "r+b");
+    BOOST_REQUIRE(file);
+    fseek(file, -1, SEEK_END);
+    int last = fgetc(file);
+    fseek(file, -1, SEEK_END);
+    fputc(last ^ 0xff, file);
+    fclose(file);
+}
+
+BOOST_AUTO_TEST_CASE(dagstore_flush)
+{
+    fs::path ph = fs::temp_directory_path() / fs::unique_path();
+    SetDAGStoreDir(ph);
+    CDAGSystem::SetTipEpoch(21);
+    for (int32_t epoch : {20, 21, 60})
+        CDAGSystem::Hashimoto(DAGStoreTestHeader(400 * epoch));
+    // Nothing is written until the store is flushed, and then only the tip's window
+    BOOST_CHECK(!fs::exists(ph / "cache-21.dat"));
+    FlushDAGStore();
+    BOOST_CHECK(fs::exists(ph / "cache-20.dat"));
+    BOOST_CHECK(fs::exists(ph / "cache-21.dat"));
+    BOOST_CHECK(!fs::exists(ph / "cache-60.dat"));
+
+    // Files are pruned once the tip leaves their epochs behind, as are those of interrupted writes
+    fs::ofstream(ph / "cache-22.dat.new") << "partial";
+    CDAGSystem::SetTipEpoch(22);
+    FlushDAGStore();
+    BOOST_CHECK(!fs::exists(ph / "cache-20.dat"));
+    BOOST_CHECK(fs::exists(ph / "cache-21.dat"));
+    BOOST_CHECK(!fs::exists(ph / "cache-22.dat.new"));
+
+    SetDAGStoreDir(fs::path());
+    fs::remove_all(ph);
+}
+
+BOOST_AUTO_TEST_CASE(dagstore_table_persist)
+{
+    fs::path ph = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(ph);
+    fs::path path = ph / "cache-3.dat";
+
+    std::vector<uint32_t> words(1024);
+    for (size_t i = 0; i < words.size(); i++)
+        words[i] = InsecureRand32();
+    std::array<uint8_t, 32> seed;
+    seed.fill(0x42);
+    const uint64_t nBytes = words.size() * sizeof(uint32_t);
+
+    std::vector<uint32_t> copy(words);
+    CDAGTable table(std::move(copy));
+    BOOST_CHECK(!table.IsMapped());
+    BOOST_CHECK(WriteDAGTable(path, CDAGTable::CACHE, 3, seed, table));
+
+    CDAGTable loaded;
+    BOOST_CHECK(LoadDAGTable(path, CDAGTable::CACHE, 3, seed, nBytes, loaded));
+    BOOST_CHECK_EQUAL(loaded.size(), words.size());
+    BOOST_CHECK(std::equal(words.begin(), words.end(), loaded.data()));
+    BOOST_CHECK(VerifyDAGTable(path, loaded));
+
+    // Moving keeps the mapping alive
+    CDAGTable moved(std::move(loaded));
+    BOOST_CHECK(loaded.empty());
+    BOOST_CHECK(std::equal(words.begin(), words.end(), moved.data()));
+
+    // Any mismatch in the header rejects the file
+    CDAGTable rejected;
+    BOOST_CHECK(!LoadDAGTable(path, CDAGTable::GRAPH, 3, seed, nBytes, rejected));
+    BOOST_CHECK(!LoadDAGTable(path, CDAGTable::CACHE, 4, seed, nBytes, rejected));
+    BOOST_CHECK(!LoadDAGTable(path, CDAGTable::CACHE, 3, seed, nBytes - 4, rejected));
+    seed[0] ^= 1;
+    BOOST_CHECK(!LoadDAGTable(path, CDAGTable::CACHE, 3, seed, nBytes, rejected));
+    seed[0] ^= 1;
+    BOOST_CHECK(!LoadDAGTable(ph / "cache-5.dat", CDAGTable::CACHE, 5, seed, nBytes, rejected));
+
+    // As does a corrupted cache
+    CorruptLastByte(path);
+    BOOST_CHECK(!LoadDAGTable(path, CDAGTable::CACHE, 3, seed, nBytes, rejected));
+    BOOST_CHECK(rejected.empty());
+
+    // A corrupted graph is mapped without reading it, and only caught by VerifyDAGTable
+    fs::path pathGraph = ph / "graph-3.dat";
+    BOOST_CHECK(WriteDAGTable(pathGraph, CDAGTable::GRAPH, 3, seed, table));
+    CorruptLastByte(pathGraph);
+    CDAGTable graph;
+    BOOST_CHECK(LoadDAGTable(pathGraph, CDAGTable::GRAPH, 3, seed, nBytes, graph));
+    BOOST_CHECK(!VerifyDAGTable(pathGraph, graph));
+
+    fs::remove_all(ph);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
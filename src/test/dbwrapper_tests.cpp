@@ -117,6 +117,53 @@ BOOST_AUTO_TEST_CASE(dbwrapper_iterator)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_options_and_stats)
+{
+    fs::path ph = fs::temp_directory_path() / fs::unique_path();
+    CDBOptions dbopts;
+    dbopts.nBlockSize = 1024;
+    dbopts.nWriteBufferSize = 64 << 10;
+    dbopts.nBloomBits = 0;
+    CDBWrapper dbw(ph, (1 << 20), true, false, false, dbopts);
+    BOOST_CHECK_EQUAL(dbw.GetDBOptions().nBlockSize, 1024U);
+    BOOST_CHECK_EQUAL(dbw.GetDBOptions().nBloomBits, 0);
+
+    std::string value;
+    BOOST_CHECK(dbw.GetProperty("leveldb.stats", value));
+    BOOST_CHECK(!dbw.GetProperty("leveldb.nonexistent", value));
+
+    const uint32_t nKeys = 4000;
+    for (uint32_t i = 0; i < nKeys; i++) {
+        BOOST_CHECK(dbw.Write(std::make_pair('k', i), uint256S(strprintf("%x", i))));
+    }
+    // Push everything out of the write buffer into table files
+    dbw.CompactRange(std::make_pair('k', (uint32_t)0), std::make_pair('k', std::numeric_limits<uint32_t>::max()));
+
+    std::vector<CDBLevelStats> levels = dbw.GetLevelStats();
+    BOOST_CHECK(levels.size() > 1);
+    int nFiles = 0;
+    uint64_t nBytes = 0;
+    for (const CDBLevelStats& level : levels) {
+        nFiles += level.nFiles;
+        nBytes += level.nBytes;
+    }
+    BOOST_CHECK(nFiles > 0);
+    BOOST_CHECK(nBytes > nKeys * sizeof(uint256));
+
+    uint64_t nLookups, nHits;
+    dbw.GetCacheStats(nLookups, nHits);
+    uint64_t nLookupsBefore = nLookups;
+    uint256 res;
+    for (uint32_t i = 0; i < nKeys; i++) {
+        BOOST_CHECK(dbw.Read(std::make_pair('k', i), res));
+        BOOST_CHECK(res == uint256S(strprintf("%x", i)));
+    }
+    dbw.GetCacheStats(nLookups, nHits);
+    BOOST_CHECK(nLookups >= nLookupsBefore + nKeys);
+    // Uncompressed blocks of memory or mmap()ed files are read in place rather than cached
+    BOOST_CHECK(nHits <= nLookups);
+}
+
 // Test that we do not obfuscation if there is existing data.
 BOOST_AUTO_TEST_CASE(existing_data_no_obfuscate)
 {
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "chainparams.h"
+#include "coins.h"
 #include "validation.h"
 #include "net.h"
 
@@ -74,4 +75,59 @@ BOOST_AUTO_TEST_CASE(test_combiner_all)
     Test.disconnect(&ReturnTrue);
     BOOST_CHECK(Test());
 }
+
+BOOST_AUTO_TEST_CASE(raw_block_read)
+{
+    const CBlockIndex* pindex = chainActive.Tip();
+    CBlock block;
+    BOOST_REQUIRE(ReadBlockFromDisk(block, pindex, Params().GetConsensus()));
+    CDataStream ssBlock(SER_NETWORK, PROTOCOL_VERSION);
+    ssBlock << block;
+
+    std::shared_ptr<const std::vector<unsigned char>> pblockRaw;
+    BOOST_REQUIRE(ReadRawBlockFromDisk(pblockRaw, pindex, Params().MessageStart()));
+    BOOST_CHECK(std::vector<unsigned char>(ssBlock.begin(), ssBlock.end()) == *pblockRaw);
+
+    // Read again from the cache
+    std::shared_ptr<const std::vector<unsigned char>> pblockCached;
+    BOOST_REQUIRE(ReadRawBlockFromDisk(pblockCached, pindex, Params().MessageStart()));
+    BOOST_CHECK(pblockCached == pblockRaw);
+}
+
+BOOST_AUTO_TEST_CASE(prefetch_inputs)
+{
+    LOCK(cs_main);
+    // Coins that are only in the database, as after a flush
+    std::vector<COutPoint> vOutPoints;
+    for (int i = 0; i < 20; i++) {
+        vOutPoints.emplace_back(InsecureRand256(), i);
+        pcoinsTip->AddCoin(vOutPoints.back(), Coin(CTxOut(COIN, CScript() << OP_TRUE), 1, false), false);
+    }
+    BOOST_REQUIRE(pcoinsTip->Flush());
+    const COutPoint missing(InsecureRand256(), 0);
+
+    // A block spending them, an unknown coin, and an output of one of its own transactions
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(1);
+    CMutableTransaction tx;
+    for (const COutPoint& outpoint : vOutPoints)
+        tx.vin.emplace_back(outpoint);
+    tx.vin.emplace_back(missing);
+    tx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+    CMutableTransaction child;
+    child.vin.emplace_back(tx.GetHash(), 0);
+    child.vout.emplace_back(COIN, CScript() << OP_TRUE);
+    CBlock block;
+    block.vtx = {MakeTransactionRef(coinbase), MakeTransactionRef(tx), MakeTransactionRef(child)};
+
+    for (const COutPoint& outpoint : vOutPoints)
+        BOOST_CHECK(!pcoinsTip->HaveCoinInCache(outpoint));
+    PrefetchInputs(block);
+    for (const COutPoint& outpoint : vOutPoints)
+        BOOST_CHECK(pcoinsTip->HaveCoinInCache(outpoint));
+    BOOST_CHECK(!pcoinsTip->HaveCoinInCache(missing));
+    BOOST_CHECK(!pcoinsTip->HaveCoinInCache(COutPoint(tx.GetHash(), 0)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,7 +3,11 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "consensus/merkle.h"
+#include "miner.h"
 #include "test/test_bitcoin.h"
+#include "validation.h"
+
+#include <cmath>
 
 #include <boost/test/unit_test.hpp>
 
@@ -132,4 +136,30 @@ BOOST_AUTO_TEST_CASE(merkle_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(merkle_extranonce_branch)
+{
+    // Rolling the extra nonce with the coinbase's branch gives the same root as hashing the whole tree
+    for (int ntx : {1, 2, 3, 17, 100}) {
+        CBlock block;
+        block.vtx.resize(ntx);
+        for (int j = 0; j < ntx; j++) {
+            CMutableTransaction mtx;
+            mtx.vin.resize(1);
+            mtx.nLockTime = j;
+            block.vtx[j] = MakeTransactionRef(std::move(mtx));
+        }
+        const std::vector<uint256> branch = BlockMerkleBranch(block, 0);
+        BOOST_CHECK_EQUAL(branch.size(), ntx == 1 ? 0U : (size_t)std::ceil(std::log2(ntx)));
+        for (unsigned int nExtraNonce = 1; nExtraNonce <= 3; nExtraNonce++) {
+            CBlock block2 = block;
+            SetExtraNonce(&block, chainActive.Tip(), nExtraNonce);
+            SetExtraNonce(&block2, chainActive.Tip(), nExtraNonce, branch);
+            BOOST_CHECK(block2.vtx[0]->GetHash() == block.vtx[0]->GetHash());
+            BOOST_CHECK(block2.hashMerkleRoot == block.hashMerkleRoot);
+            BOOST_CHECK(block.hashMerkleRoot == BlockMerkleRoot(block));
+        }
+        BOOST_CHECK(BlockMerkleBranch(block, 0) == branch);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
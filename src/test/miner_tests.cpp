@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "arith_uint256.h"
 #include "chainparams.h"
 #include "coins.h"
 #include "consensus/consensus.h"
@@ -502,4 +503,70 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     fCheckpointsEnabled = true;
 }
 
+BOOST_AUTO_TEST_CASE(UpdateBlock_and_template_cache)
+{
+    const CChainParams& chainparams = Params();
+    CScript scriptPubKey = CScript() << OP_TRUE;
+    LOCK(cs_main);
+
+    std::unique_ptr<CBlockTemplate> pblocktemplate = AssemblerForTest(chainparams).CreateNewBlock(scriptPubKey);
+    BOOST_REQUIRE(pblocktemplate);
+    std::unique_ptr<CBlockTemplate> pupdated = AssemblerForTest(chainparams).UpdateBlock(*pblocktemplate, scriptPubKey);
+    BOOST_REQUIRE(pupdated);
+    BOOST_CHECK_EQUAL(pupdated->block.vtx.size(), 1U);
+    BOOST_CHECK(pupdated->block.hashPrevBlock == pblocktemplate->block.hashPrevBlock);
+
+    // A template on another tip, or with a transaction that is not in the mempool, can't be updated
+    CBlockTemplate other(*pblocktemplate);
+    other.block.hashPrevBlock = uint256();
+    BOOST_CHECK(!AssemblerForTest(chainparams).UpdateBlock(other, scriptPubKey));
+    other = *pblocktemplate;
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vout.resize(1);
+    other.block.vtx.push_back(MakeTransactionRef(tx));
+    BOOST_CHECK(!AssemblerForTest(chainparams).UpdateBlock(other, scriptPubKey));
+
+    // The cache serves the same template until the mempool changed and it is old enough to be updated
+    SetMockTime(GetTime());
+    CBlockTemplateCache cache;
+    std::shared_ptr<const CCachedBlockTemplate> cached = cache.Get(chainparams, true);
+    BOOST_REQUIRE(cached);
+    BOOST_CHECK(cached->pindexPrev == chainActive.Tip());
+    BOOST_CHECK(cache.Get(chainparams, true) == cached);
+    mempool.AddTransactionsUpdated(1);
+    BOOST_CHECK(cache.Get(chainparams, true) == cached);
+    SetMockTime(GetTime() + CBlockTemplateCache::UPDATE_INTERVAL + 1);
+    std::shared_ptr<const CCachedBlockTemplate> updated = cache.Get(chainparams, true);
+    BOOST_REQUIRE(updated);
+    BOOST_CHECK(updated != cached);
+    BOOST_CHECK_EQUAL(updated->nTransactionsUpdated, mempool.GetTransactionsUpdated());
+    BOOST_CHECK_EQUAL(updated->nTimeCreated, cached->nTimeCreated);
+
+    // Asking for a template without segwit support builds a new one
+    BOOST_CHECK(cache.Get(chainparams, false)->nTimeCreated == GetTime());
+    SetMockTime(0);
+}
+
+BOOST_AUTO_TEST_CASE(ScanNonces_nonce_range)
+{
+    CBlockHeader header;
+    header.nVersion = 4;
+    header.nTime = 1500000000;
+    header.nBits = 0x207fffff;
+
+    // Nothing meets a zero target, so the whole range is tried
+    header.nNonce = 100;
+    BOOST_CHECK(!ScanNonces(header, 10, arith_uint256()));
+    BOOST_CHECK_EQUAL(header.nNonce, 110U);
+
+    // Half of all hashes meet this target, so a solution is found well inside the range
+    arith_uint256 bnTarget;
+    bnTarget.SetCompact(header.nBits);
+    header.nNonce = 0;
+    BOOST_CHECK(ScanNonces(header, 64, bnTarget));
+    BOOST_CHECK(header.nNonce < 64);
+    BOOST_CHECK(UintToArith256(header.GetPoWHash()) <= bnTarget);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 #include "chain.h"
 #include "chainparams.h"
 #include "pow.h"
+#include "powcache.h"
 #include "random.h"
 #include "util.h"
 #include "test/test_bitcoin.h"
@@ -83,4 +84,37 @@ BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(pow_cache)
+{
+    const auto regtest = CreateChainParams(CBaseChainParams::REGTEST);
+    const auto main = CreateChainParams(CBaseChainParams::MAIN);
+    CBlockHeader header;
+    header.nVersion = 0x20000000;
+    header.nTime = 1500000000;
+    header.nBits = 0x207fffff;
+    header.hashPrevBlock = InsecureRand256();
+    while (!CheckProofOfWork(header, regtest->GetConsensus()))
+        header.nNonce++;
+
+    // A valid proof of work is found in the cache from then on
+    PoWCacheStats before = GetPoWCacheStats();
+    BOOST_CHECK(CheckProofOfWork(header, regtest->GetConsensus()));
+    PoWCacheStats after = GetPoWCacheStats();
+    BOOST_CHECK_EQUAL(after.nHits, before.nHits + 1);
+    BOOST_CHECK_EQUAL(after.nMisses, before.nMisses);
+
+    // But not for a limit it does not satisfy
+    BOOST_CHECK(!CheckProofOfWork(header, main->GetConsensus()));
+
+    // Nor is an invalid one
+    header.nNonce++;
+    while (CheckProofOfWork(header, regtest->GetConsensus()))
+        header.nNonce++;
+    before = GetPoWCacheStats();
+    BOOST_CHECK(!CheckProofOfWork(header, regtest->GetConsensus()));
+    after = GetPoWCacheStats();
+    BOOST_CHECK_EQUAL(after.nHits, before.nHits);
+    BOOST_CHECK_EQUAL(after.nMisses, before.nMisses + 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
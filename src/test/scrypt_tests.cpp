@@ -32,4 +32,29 @@ BOOST_AUTO_TEST_CASE(scrypt_hashtest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(scrypt_batch)
+{
+    // The batch must match the known hashes however its inputs fall into groups of lanes
+    const char* inputhex[2] = { "020000004c1271c211717198227392b029a64a7971931d351b387bb80db027f270411e398a07046f7d4a08dd815412a8712f874a7ebf0507e3878bd24e20a3b73fd750a667d2f451eac7471b00de6659", "0200000011503ee6a855e900c00cfdd98f5f55fffeaee9b6bf55bea9b852d9de2ce35828e204eef76acfd36949ae56d1fbe81c1ac9c0209e6331ad56414f9072506a77f8c6faf551eac7471b00389d01" };
+    const char* expected[2] = { "00000000002bef4107f882f6115e0b01f348d21195dacd3582aa2dabd7985806", "00000000003a0d11bdd5eb634e08b7feddcfbbf228ed35d250daf19f1c88fc94" };
+    scrypt_detect_avx2();
+    for (size_t n : {1, 2, SCRYPT_BATCH_LANES, SCRYPT_BATCH_LANES + 3}) {
+        std::vector<std::vector<unsigned char>> inputbytes;
+        std::vector<uint256> hashes(n);
+        std::vector<const char*> inputs;
+        std::vector<char*> outputs;
+        for (size_t i = 0; i < n; i++) {
+            inputbytes.push_back(ParseHex(inputhex[i % 2]));
+        }
+        for (size_t i = 0; i < n; i++) {
+            inputs.push_back((const char*)inputbytes[i].data());
+            outputs.push_back(BEGIN(hashes[i]));
+        }
+        scrypt_1024_1_1_256_batch(inputs.data(), outputs.data(), n);
+        for (size_t i = 0; i < n; i++) {
+            BOOST_CHECK_EQUAL(hashes[i].ToString(), expected[i % 2]);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,60 @@
+// Copyright (c) 2017 The Chancoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chainparams.h"
+#include "consensus/merkle.h"
+#include "miner.h"
+#include "stratum.h"
+#include "validation.h"
+
+#include "test/test_bitcoin.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(stratum_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(stratum_job_coinbase)
+{
+    const CChainParams& chainparams = Params();
+    std::unique_ptr<CBlockTemplate> pblocktemplate;
+    {
+        LOCK(cs_main);
+        pblocktemplate = BlockAssembler(chainparams).CreateNewBlock(CScript() << OP_TRUE);
+    }
+    BOOST_REQUIRE(pblocktemplate);
+    // Give the coinbase a merkle branch to fold into the root
+    for (int i = 0; i < 2; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout.n = i;
+        tx.vout.resize(1);
+        pblocktemplate->block.vtx.push_back(MakeTransactionRef(tx));
+    }
+    CScript scriptPayout = CScript() << OP_2;
+
+    CStratumJob job;
+    CreateStratumJob(*pblocktemplate, scriptPayout, "1", job);
+    BOOST_CHECK_EQUAL(job.strId, "1");
+    BOOST_CHECK(job.block.hashPrevBlock == pblocktemplate->block.hashPrevBlock);
+    BOOST_CHECK_EQUAL(job.vMerkleBranch.size(), 2U);
+
+    const std::vector<unsigned char> vchExtraNonce1{1, 2, 3, 4};
+    const std::vector<unsigned char> vchExtraNonce2{5, 6, 7, 8};
+    CBlock block;
+    BOOST_CHECK(!GetStratumBlock(job, vchExtraNonce1, std::vector<unsigned char>(3), 1, 2, block));
+    BOOST_REQUIRE(GetStratumBlock(job, vchExtraNonce1, vchExtraNonce2, 1, 2, block));
+    BOOST_CHECK_EQUAL(block.nTime, 1U);
+    BOOST_CHECK_EQUAL(block.nNonce, 2U);
+    BOOST_CHECK_EQUAL(block.height, pblocktemplate->block.height);
+
+    // The coinbase pays the template's value to the payout script, with both extra nonces at the end of its scriptSig
+    const CTransaction& coinbase = *block.vtx[0];
+    BOOST_CHECK(coinbase.vout[0].scriptPubKey == scriptPayout);
+    BOOST_CHECK_EQUAL(coinbase.vout[0].nValue, pblocktemplate->block.vtx[0]->vout[0].nValue);
+    const std::vector<unsigned char> vchExtraNonce{1, 2, 3, 4, 5, 6, 7, 8};
+    BOOST_CHECK(coinbase.vin[0].scriptSig == CScript() << block.height << vchExtraNonce);
+    BOOST_CHECK(block.hashMerkleRoot == BlockMerkleRoot(block));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -7,12 +7,17 @@
 #include "chainparams.h"
 #include "consensus/consensus.h"
 #include "consensus/validation.h"
+#include "crypto/dag.h"
+#include "crypto/scrypt.h"
+#include "crypto/sph_autodetect.h"
 #include "crypto/sha256.h"
 #include "fs.h"
 #include "key.h"
 #include "validation.h"
 #include "miner.h"
 #include "net_processing.h"
+#include "pow.h"
+#include "powcache.h"
 #include "pubkey.h"
 #include "random.h"
 #include "txdb.h"
@@ -35,12 +40,17 @@ extern void noui_connect();
 BasicTestingSetup::BasicTestingSetup(const std::string& chainName)
 {
         SHA256AutoDetect();
+        DAGAutoDetect();
+        CubeHashAutoDetect();
+        Lyra2AutoDetect();
+        scrypt_detect_avx2();
         RandomInit();
         ECC_Start();
         SetupEnvironment();
         SetupNetworking();
         InitSignatureCache();
         InitScriptExecutionCache();
+        InitPoWCache();
         fPrintToDebugLog = false; // don't want to write to debug.log file
         fCheckBlockIndex = true;
         SelectParams(chainName);
@@ -73,7 +83,8 @@ TestingSetup::TestingSetup(const std::string& chainName) : BasicTestingSetup(cha
         mempool.setSanityCheck(1.0);
         pblocktree = new CBlockTreeDB(1 << 20, true);
         pcoinsdbview = new CCoinsViewDB(1 << 23, true);
-        pcoinsTip = new CCoinsViewCache(pcoinsdbview);
+        pcoinsflushview = new CCoinsViewBackgroundFlush(pcoinsdbview, pcoinsdbview);
+        pcoinsTip = new CCoinsViewCache(pcoinsflushview);
         if (!LoadGenesisBlock(chainparams)) {
             throw std::runtime_error("LoadGenesisBlock failed.");
         }
@@ -86,6 +97,11 @@ TestingSetup::TestingSetup(const std::string& chainName) : BasicTestingSetup(cha
         nScriptCheckThreads = 3;
         for (int i=0; i < nScriptCheckThreads-1; i++)
             threadGroup.create_thread(&ThreadScriptCheck);
+        nPrefetchThreads = 3;
+        for (int i=0; i < nPrefetchThreads-1; i++)
+            threadGroup.create_thread(&ThreadCoinPrefetch);
+        for (int i=0; i < 2; i++)
+            threadGroup.create_thread(&ThreadHashimoto);
         g_connman = std::unique_ptr<CConnman>(new CConnman(0x1337, 0x1337)); // Deterministic randomness for tests.
         connman = g_connman.get();
         RegisterNodeSignals(GetNodeSignals());
@@ -100,6 +116,7 @@ TestingSetup::~TestingSetup()
         GetMainSignals().UnregisterBackgroundSignalScheduler();
         UnloadBlockIndex();
         delete pcoinsTip;
+        delete pcoinsflushview;
         delete pcoinsdbview;
         delete pblocktree;
         fs::remove_all(pathTemp);
@@ -15,6 +15,7 @@
 #include "init.h"
 
 #include <stdint.h>
+#include <algorithm>
 
 #include <boost/thread.hpp>
 
@@ -54,7 +55,18 @@ struct CoinEntry {
 
 }
 
-CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe) : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true) 
+CDBOptions ParseDBOptions(const std::string& strName)
+{
+    CDBOptions dbopts;
+    dbopts.nMaxOpenFiles = std::max(gArgs.GetArg("-" + strName + "maxopenfiles", DEFAULT_DB_MAX_OPEN_FILES), (int64_t)20);
+    dbopts.nBlockSize = std::max(gArgs.GetArg("-" + strName + "blocksize", DEFAULT_DB_BLOCK_SIZE), (int64_t)1024);
+    dbopts.nWriteBufferSize = std::max(gArgs.GetArg("-" + strName + "writebuffer", 0), (int64_t)0) << 20;
+    dbopts.nBloomBits = std::max(gArgs.GetArg("-" + strName + "bloombits", DEFAULT_DB_BLOOM_BITS), (int64_t)0);
+    dbopts.fCompression = gArgs.GetBoolArg("-" + strName + "compression", DEFAULT_DB_COMPRESSION);
+    return dbopts;
+}
+
+CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe) : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true, ParseDBOptions("chainstate"))
 {
 }
 
@@ -82,6 +94,12 @@ std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
 }
 
 bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
+    bool ret = WriteCoins(mapCoins, hashBlock);
+    mapCoins.clear();
+    return ret;
+}
+
+bool CCoinsViewDB::WriteCoins(const CCoinsMap &mapCoins, const uint256 &hashBlock) {
     CDBBatch batch(db);
     size_t count = 0;
     size_t changed = 0;
@@ -106,7 +124,7 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     batch.Erase(DB_BEST_BLOCK);
     batch.Write(DB_HEAD_BLOCKS, std::vector<uint256>{hashBlock, old_tip});
 
-    for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
+    for (CCoinsMap::const_iterator it = mapCoins.begin(); it != mapCoins.end(); it++) {
         if (it->second.flags & CCoinsCacheEntry::DIRTY) {
             CoinEntry entry(&it->first);
             if (it->second.coin.IsSpent())
@@ -116,8 +134,6 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
             changed++;
         }
         count++;
-        CCoinsMap::iterator itOld = it++;
-        mapCoins.erase(itOld);
         if (batch.SizeEstimate() > batch_size) {
             LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n", batch.SizeEstimate() * (1.0 / 1048576.0));
             db.WriteBatch(batch);
@@ -147,7 +163,124 @@ size_t CCoinsViewDB::EstimateSize() const
     return db.EstimateSize(DB_COIN, (char)(DB_COIN+1));
 }
 
-CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe) {
+CCoinsViewBackgroundFlush::CCoinsViewBackgroundFlush(CCoinsView* viewIn, CCoinsViewDB* dbIn) : CCoinsViewBacked(viewIn), db(dbIn), nWritingUsage(0), fWriting(false), fFailed(false)
+{
+}
+
+CCoinsViewBackgroundFlush::~CCoinsViewBackgroundFlush()
+{
+    Sync();
+}
+
+bool CCoinsViewBackgroundFlush::GetCoin(const COutPoint &outpoint, Coin &coin) const {
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        CCoinsMap::const_iterator it = mapWriting.find(outpoint);
+        if (it != mapWriting.end()) {
+            coin = it->second.coin;
+            return !coin.IsSpent();
+        }
+    }
+    return base->GetCoin(outpoint, coin);
+}
+
+bool CCoinsViewBackgroundFlush::HaveCoin(const COutPoint &outpoint) const {
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        CCoinsMap::const_iterator it = mapWriting.find(outpoint);
+        if (it != mapWriting.end()) {
+            return !it->second.coin.IsSpent();
+        }
+    }
+    return base->HaveCoin(outpoint);
+}
+
+uint256 CCoinsViewBackgroundFlush::GetBestBlock() const {
+    {
+        // The database has no best block until the write is done
+        std::lock_guard<std::mutex> lock(cs);
+        if (!hashWriting.IsNull()) {
+            return hashWriting;
+        }
+    }
+    return base->GetBestBlock();
+}
+
+bool CCoinsViewBackgroundFlush::BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
+    if (!Sync()) {
+        return false;
+    }
+    size_t nUsage = memusage::DynamicUsage(mapCoins);
+    for (const auto& entry : mapCoins) {
+        nUsage += entry.second.coin.DynamicMemoryUsage();
+    }
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        mapWriting.swap(mapCoins);
+        hashWriting = hashBlock;
+        nWritingUsage = nUsage;
+        fWriting = true;
+    }
+    threadWrite = std::thread(&CCoinsViewBackgroundFlush::ThreadWrite, this);
+    return true;
+}
+
+CCoinsViewCursor *CCoinsViewBackgroundFlush::Cursor() const {
+    std::unique_lock<std::mutex> lock(cs);
+    condWritten.wait(lock, [this]{ return !fWriting; });
+    return base->Cursor();
+}
+
+bool CCoinsViewBackgroundFlush::Sync() {
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        condWritten.wait(lock, [this]{ return !fWriting; });
+    }
+    if (threadWrite.joinable()) {
+        threadWrite.join();
+    }
+    std::lock_guard<std::mutex> lock(cs);
+    return !fFailed;
+}
+
+bool CCoinsViewBackgroundFlush::Failed() const {
+    std::lock_guard<std::mutex> lock(cs);
+    return fFailed;
+}
+
+size_t CCoinsViewBackgroundFlush::DynamicMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(cs);
+    return nWritingUsage;
+}
+
+void CCoinsViewBackgroundFlush::ThreadWrite() {
+    RenameThread("bitcoin-coinsflush");
+    int64_t nStart = GetTimeMillis();
+    // mapWriting and hashWriting don't change until fWriting is reset, so they are read without the lock
+    bool fOk = false;
+    try {
+        fOk = db->WriteCoins(mapWriting, hashWriting);
+    } catch (const std::exception& e) {
+        LogPrintf("Error writing to coin database: %s\n", e.what());
+    }
+    LogPrint(BCLog::COINDB, "Background flush to %s %s in %dms\n", hashWriting.ToString(), fOk ? "done" : "failed", GetTimeMillis() - nStart);
+
+    // Keep the entries of a failed write, as the database doesn't have them. Free the others after unlocking.
+    CCoinsMap mapWritten;
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        if (fOk) {
+            mapWritten.swap(mapWriting);
+            hashWriting.SetNull();
+            nWritingUsage = 0;
+        }
+        fFailed = !fOk;
+        fWriting = false;
+    }
+    condWritten.notify_all();
+}
+
+CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe, false, ParseDBOptions("blockindex")) {
 }
 
 bool CBlockTreeDB::ReadBlockFileInfo(int nFile, CBlockFileInfo &info) {
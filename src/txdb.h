@@ -10,8 +10,11 @@
 #include "dbwrapper.h"
 #include "chain.h"
 
+#include <condition_variable>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -23,6 +26,10 @@ class uint256;
 static constexpr int MAX_BLOCK_COINSDB_USAGE = 10;
 //! -dbcache default (MiB)
 static const int64_t nDefaultDbCache = 450;
+//! -dbcachekeep default (percent of the coin cache)
+static const int64_t nDefaultDbCacheKeep = 30;
+//! max. -dbcachekeep (percent of the coin cache)
+static const int64_t nMaxDbCacheKeep = 90;
 //! -dbbatchsize default (bytes)
 static const int64_t nDefaultDbBatchSize = 16 << 20;
 //! max. -dbcache (MiB)
@@ -38,6 +45,9 @@ static const int64_t nMaxBlockDBAndTxIndexCache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
 
+/** Read the LevelDB tunables of a database from -<strName>maxopenfiles, -<strName>blocksize and so on */
+CDBOptions ParseDBOptions(const std::string& strName);
+
 struct CDiskTxPos : public CDiskBlockPos
 {
     unsigned int nTxOffset; // after header
@@ -78,9 +88,60 @@ public:
     bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
     CCoinsViewCursor *Cursor() const override;
 
+    //! Write the dirty entries of mapCoins like BatchWrite, but leave the map as it is, so that it can be read meanwhile.
+    bool WriteCoins(const CCoinsMap &mapCoins, const uint256 &hashBlock);
+
     //! Attempt to update from an older database format. Returns whether an error occurred.
     bool Upgrade();
     size_t EstimateSize() const override;
+
+    const CDBWrapper& GetDB() const { return db; }
+};
+
+/**
+ * Layer between the coin database and the coins tip which writes flushed caches to the database from a background
+ * thread. Until a write is done, its entries are served from memory, so validation can carry on against a fresh cache
+ * on top. The database is marked with DB_HEAD_BLOCKS during the write, as for a synchronous one, so that a crash in
+ * the middle of it is recovered by replaying blocks.
+ */
+class CCoinsViewBackgroundFlush : public CCoinsViewBacked
+{
+private:
+    CCoinsViewDB* db;
+
+    mutable std::mutex cs;
+    mutable std::condition_variable condWritten;
+    //! Entries being written, and those of a failed write. Only changed while no write is running.
+    CCoinsMap mapWriting;
+    //! Best block of mapWriting, null once it is written
+    uint256 hashWriting;
+    //! Memory held by mapWriting
+    size_t nWritingUsage;
+    bool fWriting;
+    bool fFailed;
+    std::thread threadWrite;
+
+    void ThreadWrite();
+
+public:
+    //! Reads go to viewIn, which is backed by dbIn, and writes to dbIn
+    CCoinsViewBackgroundFlush(CCoinsView* viewIn, CCoinsViewDB* dbIn);
+    ~CCoinsViewBackgroundFlush();
+
+    bool GetCoin(const COutPoint &outpoint, Coin &coin) const override;
+    bool HaveCoin(const COutPoint &outpoint) const override;
+    uint256 GetBestBlock() const override;
+    //! Take over mapCoins and start writing it, once the previous write is done. Returns false if that one failed.
+    bool BatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) override;
+    //! Iterate over the database, once the write in progress is done
+    CCoinsViewCursor *Cursor() const override;
+
+    //! Wait until everything flushed so far is in the database. Returns false if a write failed.
+    bool Sync();
+    //! Whether the last write failed
+    bool Failed() const;
+    //! Memory held by the entries still to be written, zero once they are all in the database
+    size_t DynamicMemoryUsage() const;
 };
 
 /** Specialization of CCoinsViewCursor to iterate over a CCoinsViewDB */
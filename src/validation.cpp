@@ -43,7 +43,11 @@
 #include "warnings.h"
 
 #include <atomic>
+#include <list>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/algorithm/string/join.hpp>
@@ -65,6 +69,7 @@ CBlockIndex *pindexBestHeader = nullptr;
 CWaitableCriticalSection csBestBlock;
 CConditionVariable cvBlockChange;
 int nScriptCheckThreads = 0;
+int nPrefetchThreads = 0;
 std::atomic_bool fImporting(false);
 bool fReindex = false;
 bool fTxIndex = false;
@@ -73,6 +78,7 @@ bool fPruneMode = false;
 bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
 bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
+bool fCheckBlockReadPoW = DEFAULT_CHECK_BLOCK_READ_POW;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
 size_t nCoinCacheUsage = 5000 * 300;
 uint64_t nPruneTarget = 0;
@@ -178,6 +184,7 @@ CBlockIndex* FindForkInGlobalIndex(const CChain& chain, const CBlockLocator& loc
 }
 
 CCoinsViewDB *pcoinsdbview = nullptr;
+CCoinsViewBackgroundFlush *pcoinsflushview = nullptr;
 CCoinsViewCache *pcoinsTip = nullptr;
 CBlockTreeDB *pblocktree = nullptr;
 
@@ -1003,7 +1010,7 @@ static bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMes
     return true;
 }
 
-bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams)
+static bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams, bool fCheckPOW)
 {
     block.SetNull();
 
@@ -1021,15 +1028,21 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus:
     }
 
     // Check the header
-    if (!CheckProofOfWork(block.GetBlockHeader(), consensusParams))
+    if (fCheckPOW && !CheckProofOfWork(block.GetBlockHeader(), consensusParams))
         return error("ReadBlockFromDisk: Errors in block header at %s", pos.ToString());
 
     return true;
 }
 
+bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams)
+{
+    return ReadBlockFromDisk(block, pos, consensusParams, true);
+}
+
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
 {
-    if (!ReadBlockFromDisk(block, pindex->GetBlockPos(), consensusParams))
+    // The hash comparison below ties the block to the index entry, whose proof of work was checked when it was accepted
+    if (!ReadBlockFromDisk(block, pindex->GetBlockPos(), consensusParams, fCheckBlockReadPoW))
         return false;
     if (block.GetHash() != pindex->GetBlockHash())
         return error("ReadBlockFromDisk(CBlock&, CBlockIndex*): GetHash() doesn't match index for %s at %s",
@@ -1037,6 +1050,97 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
     return true;
 }
 
+namespace {
+
+/** Serialized blocks read by ReadRawBlockFromDisk, evicting the least recently used beyond RAW_BLOCK_CACHE_SIZE bytes */
+class CRawBlockCache
+{
+private:
+    typedef std::list<std::pair<uint256, std::shared_ptr<const std::vector<unsigned char>>>> list_type;
+
+    std::mutex cs;
+    /** Most recently used first */
+    list_type entries;
+    std::unordered_map<uint256, list_type::iterator, BlockHasher> mapEntries;
+    size_t nSize = 0;
+
+public:
+    std::shared_ptr<const std::vector<unsigned char>> Get(const uint256& hash)
+    {
+        std::lock_guard<std::mutex> lock(cs);
+        auto it = mapEntries.find(hash);
+        if (it == mapEntries.end())
+            return nullptr;
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->second;
+    }
+
+    void Put(const uint256& hash, const std::shared_ptr<const std::vector<unsigned char>>& pblock)
+    {
+        if (pblock->size() > RAW_BLOCK_CACHE_SIZE)
+            return;
+        std::lock_guard<std::mutex> lock(cs);
+        if (mapEntries.count(hash))
+            return;
+        entries.emplace_front(hash, pblock);
+        mapEntries.emplace(hash, entries.begin());
+        nSize += pblock->size();
+        while (nSize > RAW_BLOCK_CACHE_SIZE) {
+            nSize -= entries.back().second->size();
+            mapEntries.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+};
+
+CRawBlockCache rawBlockCache;
+
+} // namespace
+
+bool ReadRawBlockFromDisk(std::shared_ptr<const std::vector<unsigned char>>& pblock, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& messageStart)
+{
+    pblock = rawBlockCache.Get(pindex->GetBlockHash());
+    if (pblock)
+        return true;
+
+    // Start at the magic and size WriteBlockToDisk put before the block
+    CDiskBlockPos pos = pindex->GetBlockPos();
+    if (pos.nPos < 8)
+        return error("%s: Invalid position %s", __func__, pos.ToString());
+    pos.nPos -= 8;
+
+    CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull())
+        return error("%s: OpenBlockFile failed for %s", __func__, pos.ToString());
+
+    std::shared_ptr<std::vector<unsigned char>> pblockRead = std::make_shared<std::vector<unsigned char>>();
+    CBlockHeader header;
+    try {
+        CMessageHeader::MessageStartChars blockStart;
+        unsigned int nSize;
+        filein >> FLATDATA(blockStart) >> nSize;
+        if (memcmp(blockStart, messageStart, CMessageHeader::MESSAGE_START_SIZE))
+            return error("%s: Block magic mismatch at %s", __func__, pos.ToString());
+        if (nSize > MAX_SIZE)
+            return error("%s: Block size %u too large at %s", __func__, nSize, pos.ToString());
+        pblockRead->resize(nSize);
+        filein.read((char*)pblockRead->data(), nSize);
+
+        // The header is at most a few hundred bytes, so only those are copied to decode it
+        const char* pbegin = (const char*)pblockRead->data();
+        CDataStream ssHeader(pbegin, pbegin + std::min<size_t>(nSize, 256), SER_DISK, CLIENT_VERSION);
+        ssHeader >> header;
+    } catch (const std::exception& e) {
+        return error("%s: Deserialize or I/O error - %s at %s", __func__, e.what(), pos.ToString());
+    }
+    if (header.GetHash() != pindex->GetBlockHash())
+        return error("%s: GetHash() doesn't match index for %s at %s", __func__, pindex->ToString(), pindex->GetBlockPos().ToString());
+
+    pblock = pblockRead;
+    rawBlockCache.Put(pindex->GetBlockHash(), pblock);
+    return true;
+}
+
 CAmount GetBlockSubsidy(int nHeight, const Consensus::Params& consensusParams)
 {
     if(nHeight == 1) {
@@ -1564,6 +1668,90 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+namespace {
+
+/** Lookup of a coin spent by a block, made on the prefetch threads ahead of connecting the block */
+class CCoinPrefetch
+{
+private:
+    const CCoinsView* view;
+    COutPoint outpoint;
+    Coin* pcoin;
+
+public:
+    CCoinPrefetch() : view(nullptr), pcoin(nullptr) {}
+    CCoinPrefetch(const CCoinsView* viewIn, const COutPoint& outpointIn, Coin* pcoinIn) :
+        view(viewIn), outpoint(outpointIn), pcoin(pcoinIn) {}
+
+    bool operator()()
+    {
+        // Read errors never get here, CCoinsViewErrorCatcher aborts on them
+        if (!view->GetCoin(outpoint, *pcoin))
+            pcoin->Clear();
+        return true;
+    }
+
+    void swap(CCoinPrefetch& check)
+    {
+        std::swap(view, check.view);
+        std::swap(outpoint, check.outpoint);
+        std::swap(pcoin, check.pcoin);
+    }
+};
+
+} // namespace
+
+static CCheckQueue<CCoinPrefetch> coinprefetchqueue(16);
+
+void ThreadCoinPrefetch() {
+    RenameThread("bitcoin-prefetch");
+    coinprefetchqueue.Thread();
+}
+
+/**
+ * Read the coins spent by block that pcoinsTip doesn't have in memory from its backing view, spread over the
+ * prefetch threads, and add them to pcoinsTip. ConnectBlock then finds all of its inputs in memory, instead of
+ * waiting on the database for each of them in turn.
+ */
+void PrefetchInputs(const CBlock& block)
+{
+    if (!nPrefetchThreads)
+        return;
+
+    // Outputs of the block's own transactions are not in the database yet
+    std::unordered_set<uint256, BlockHasher> setTxids;
+    for (const auto& tx : block.vtx) {
+        setTxids.insert(tx->GetHash());
+    }
+    std::vector<COutPoint> vOutPoints;
+    for (const auto& tx : block.vtx) {
+        if (tx->IsCoinBase())
+            continue;
+        for (const CTxIn& txin : tx->vin) {
+            if (!setTxids.count(txin.prevout.hash) && !pcoinsTip->HaveCoinInCache(txin.prevout))
+                vOutPoints.push_back(txin.prevout);
+        }
+    }
+    if (vOutPoints.empty())
+        return;
+
+    std::vector<Coin> vCoins(vOutPoints.size());
+    {
+        CCheckQueueControl<CCoinPrefetch> control(&coinprefetchqueue);
+        std::vector<CCoinPrefetch> vChecks;
+        vChecks.reserve(vOutPoints.size());
+        for (size_t i = 0; i < vOutPoints.size(); i++) {
+            vChecks.emplace_back(pcoinsTip->GetBackend(), vOutPoints[i], &vCoins[i]);
+        }
+        control.Add(vChecks);
+        control.Wait();
+    }
+    for (size_t i = 0; i < vOutPoints.size(); i++) {
+        if (!vCoins[i].IsSpent())
+            pcoinsTip->CacheCoin(vOutPoints[i], std::move(vCoins[i]));
+    }
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -1913,6 +2101,9 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
     bool fDoFullFlush = false;
     int64_t nNow = 0;
     try {
+    if (pcoinsflushview && pcoinsflushview->Failed()) {
+        return AbortNode(state, "Failed to write to coin database");
+    }
     {
         LOCK(cs_LastBlockFile);
         if (fPruneMode && (fCheckForPruning || nManualPruneHeight > 0) && !fReindex) {
@@ -1944,10 +2135,13 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
         int64_t nMempoolSizeMax = gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
         int64_t cacheSize = pcoinsTip->DynamicMemoryUsage();
         int64_t nTotalSpace = nCoinCacheUsage + std::max<int64_t>(nMempoolSizeMax - nMempoolUsage, 0);
+        // A cache flushed in the background is held until it is written, while the next one fills up. Leave it its space
+        // while that write is in flight, after which the cache has all of it again.
+        int64_t nFlushSpace = nTotalSpace - (pcoinsflushview ? (int64_t)pcoinsflushview->DynamicMemoryUsage() : 0);
         // The cache is large and we're within 10% and 10 MiB of the limit, but we have time now (not in the middle of a block processing).
-        bool fCacheLarge = mode == FLUSH_STATE_PERIODIC && cacheSize > std::max((9 * nTotalSpace) / 10, nTotalSpace - MAX_BLOCK_COINSDB_USAGE * 1024 * 1024);
+        bool fCacheLarge = mode == FLUSH_STATE_PERIODIC && cacheSize > std::max((9 * nFlushSpace) / 10, nFlushSpace - MAX_BLOCK_COINSDB_USAGE * 1024 * 1024);
         // The cache is over the limit, we have to write now.
-        bool fCacheCritical = mode == FLUSH_STATE_IF_NEEDED && cacheSize > nTotalSpace;
+        bool fCacheCritical = mode == FLUSH_STATE_IF_NEEDED && cacheSize > nFlushSpace;
         // It's been a while since we wrote the block index to disk. Do this frequently, so we don't need to redownload after a crash.
         bool fPeriodicWrite = mode == FLUSH_STATE_PERIODIC && nNow > nLastWrite + (int64_t)DATABASE_WRITE_INTERVAL * 1000000;
         // It's been very long since we flushed the cache. Do this infrequently, to optimize cache usage.
@@ -1986,6 +2180,9 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
         }
         // Flush best chain related state. This can only be done if the blocks / block index write was also done.
         if (fDoFullFlush) {
+            // Unless we have to write everything, keep the hot part of the cache, so that the next blocks don't miss on all their inputs.
+            int64_t nKeepPercent = std::max<int64_t>(0, std::min(gArgs.GetArg("-dbcachekeep", nDefaultDbCacheKeep), nMaxDbCacheKeep));
+            size_t nKeepUsage = mode == FLUSH_STATE_ALWAYS ? 0 : nFlushSpace * nKeepPercent / 100;
             // Typical Coin structures on disk are around 48 bytes in size.
             // Pushing a new one to the database can cause it to be written
             // twice (once in the log, and once in the tables). This is already
@@ -1994,7 +2191,11 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
             if (!CheckDiskSpace(48 * 2 * 2 * pcoinsTip->GetCacheSize()))
                 return state.Error("out of disk space");
             // Flush the chainstate (which may refer to block index entries).
-            if (!pcoinsTip->Flush())
+            if (!pcoinsTip->FlushAndTrim(nKeepUsage))
+                return AbortNode(state, "Failed to write to coin database");
+            // Callers of a full flush expect the database to be up to date, and replaying an interrupted write must
+            // not need the blocks just pruned, so don't leave the write in the background then.
+            if ((mode == FLUSH_STATE_ALWAYS || fFlushForPrune) && pcoinsflushview && !pcoinsflushview->Sync())
                 return AbortNode(state, "Failed to write to coin database");
             nLastFlush = nNow;
         }
@@ -2143,6 +2344,7 @@ bool static DisconnectTip(CValidationState& state, const CChainParams& chainpara
 }
 
 static int64_t nTimeReadFromDisk = 0;
+static int64_t nTimePrefetch = 0;
 static int64_t nTimeConnectTotal = 0;
 static int64_t nTimeFlush = 0;
 static int64_t nTimeChainState = 0;
@@ -2238,6 +2440,10 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
     int64_t nTime2 = GetTimeMicros(); nTimeReadFromDisk += nTime2 - nTime1;
     int64_t nTime3;
     LogPrint(BCLog::BENCH, "  - Load block from disk: %.2fms [%.2fs]\n", (nTime2 - nTime1) * 0.001, nTimeReadFromDisk * 0.000001);
+    PrefetchInputs(blockConnecting);
+    int64_t nTimePrefetched = GetTimeMicros(); nTimePrefetch += nTimePrefetched - nTime2;
+    LogPrint(BCLog::BENCH, "  - Prefetch inputs: %.2fms [%.2fs]\n", (nTimePrefetched - nTime2) * 0.001, nTimePrefetch * 0.000001);
+    nTime2 = nTimePrefetched;
     {
         CCoinsViewCache view(pcoinsTip);
         bool rv = ConnectBlock(blockConnecting, state, pindexNew, view, chainparams);
@@ -3069,7 +3275,7 @@ static bool ContextualCheckBlock(const CBlock& block, CValidationState& state, c
     return true;
 }
 
-static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fCheckPOW = true)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
@@ -3088,7 +3294,7 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus()))
+        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), fCheckPOW))
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
         // Get prev block index
@@ -3116,11 +3322,55 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
 // Exposed wrapper for AcceptBlockHeader
 bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex)
 {
+    // Verify the proof of work of the headers we don't know yet in one batch, without holding cs_main.
+    // AcceptBlockHeader only rechecks the ones that did not pass, so failures are reported as before.
+    std::vector<bool> vPOWChecked(headers.size(), false);
+    {
+        std::vector<CBlockHeader> vNewHeaders;
+        std::vector<size_t> vNewPos;
+        {
+            LOCK(cs_main);
+            // Only batch headers that connect to a valid known header and pass its contextual checks, or that follow
+            // the header batched before them, stopping at the first one that doesn't. AcceptBlockHeader would
+            // reject the others before checking their proof of work, which must not cost more than that.
+            uint256 hashPrevBatched;
+            int nPrevHeight = 0;
+            for (size_t i = 0; i < headers.size(); i++) {
+                const CBlockHeader& header = headers[i];
+                const uint256 hash = header.GetHash();
+                if (mapBlockIndex.count(hash))
+                    continue;
+                if (!vNewHeaders.empty() && header.hashPrevBlock == hashPrevBatched) {
+                    if ((header.nVersion & 0x00000100) && header.height != nPrevHeight + 1)
+                        break;
+                    if (header.GetBlockTime() > GetAdjustedTime() + MAX_FUTURE_BLOCK_TIME)
+                        break;
+                } else {
+                    BlockMap::iterator mi = mapBlockIndex.find(header.hashPrevBlock);
+                    if (mi == mapBlockIndex.end() || (mi->second->nStatus & BLOCK_FAILED_MASK))
+                        break;
+                    CValidationState stateDummy;
+                    if (!ContextualCheckBlockHeader(header, stateDummy, chainparams, mi->second, GetAdjustedTime()))
+                        break;
+                    nPrevHeight = mi->second->nHeight;
+                }
+                vNewHeaders.push_back(header);
+                vNewPos.push_back(i);
+                hashPrevBatched = hash;
+                nPrevHeight++;
+            }
+        }
+        std::vector<bool> vValid = CheckProofOfWorkBatch(vNewHeaders, chainparams.GetConsensus());
+        for (size_t i = 0; i < vNewPos.size(); i++) {
+            vPOWChecked[vNewPos[i]] = vValid[i];
+        }
+    }
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); i++) {
+            const CBlockHeader& header = headers[i];
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
-            if (!AcceptBlockHeader(header, state, chainparams, &pindex)) {
+            if (!AcceptBlockHeader(header, state, chainparams, &pindex, !vPOWChecked[i])) {
                 return false;
             }
             if (ppindex) {
@@ -33,6 +33,7 @@
 class CBlockIndex;
 class CBlockTreeDB;
 class CChainParams;
+class CCoinsViewBackgroundFlush;
 class CCoinsViewDB;
 class CInv;
 class CConnman;
@@ -80,6 +81,10 @@ static const unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
 static const int MAX_SCRIPTCHECK_THREADS = 16;
 /** -par default (number of script-checking threads, 0 = auto) */
 static const int DEFAULT_SCRIPTCHECK_THREADS = 0;
+/** Maximum number of threads reading the coins spent by a block ahead of connecting it */
+static const int MAX_PREFETCH_THREADS = 32;
+/** -prefetchthreads default. Lookups wait on the disk rather than the CPU, so more threads than cores pay off. */
+static const int DEFAULT_PREFETCH_THREADS = 8;
 /** Number of blocks that can be requested at any given time from a single peer. */
 static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 500;
 /** Timeout in seconds during which a peer must stall block download progress before being disconnected. */
@@ -129,6 +134,10 @@ static const int64_t MAX_FEE_ESTIMATION_TIP_AGE = 3 * 60 * 60;
 /** Default for -permitbaremultisig */
 static const bool DEFAULT_PERMIT_BAREMULTISIG = true;
 static const bool DEFAULT_CHECKPOINTS_ENABLED = true;
+/** Default for -checkblockreadpow */
+static const bool DEFAULT_CHECK_BLOCK_READ_POW = false;
+/** Bytes of serialized blocks ReadRawBlockFromDisk keeps in memory, for the recent blocks most requests are for */
+static const size_t RAW_BLOCK_CACHE_SIZE = 16 * 1024 * 1024;
 static const bool DEFAULT_TXINDEX = false;
 static const unsigned int DEFAULT_BANSCORE_THRESHOLD = 100;
 /** Default for -persistmempool */
@@ -169,10 +178,13 @@ extern CConditionVariable cvBlockChange;
 extern std::atomic_bool fImporting;
 extern bool fReindex;
 extern int nScriptCheckThreads;
+extern int nPrefetchThreads;
 extern bool fTxIndex;
 extern bool fIsBareMultisigStd;
 extern bool fRequireStandard;
 extern bool fCheckBlockIndex;
+/** Whether ReadBlockFromDisk rechecks the proof of work of blocks already in the index */
+extern bool fCheckBlockReadPoW;
 extern bool fCheckpointsEnabled;
 extern size_t nCoinCacheUsage;
 /** A fee rate smaller than this is considered zero fee (for relaying, mining and transaction creation) */
@@ -267,6 +279,10 @@ bool LoadChainTip(const CChainParams& chainparams);
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Run an instance of the thread reading the coins spent by blocks ahead of connecting them */
+void ThreadCoinPrefetch();
+/** Read the coins spent by block that pcoinsTip doesn't have in memory into it, on the prefetch threads */
+void PrefetchInputs(const CBlock& block);
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 /** Retrieve a transaction (from memory pool, or from disk, if possible) */
@@ -392,7 +408,15 @@ void InitScriptExecutionCache();
 
 /** Functions for disk access for blocks */
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams);
+/** Read the block of an index entry. Its proof of work was checked on acceptance, so the block is only matched
+ *  against the entry's hash unless fCheckBlockReadPoW is set. */
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+/**
+ * Read the block of an index entry as it is serialized on disk, which is its network serialization with witnesses,
+ * without deserializing it. Only its header is decoded, to match it against the entry's hash. The last blocks read
+ * are kept in a least recently used cache of RAW_BLOCK_CACHE_SIZE bytes.
+ */
+bool ReadRawBlockFromDisk(std::shared_ptr<const std::vector<unsigned char>>& pblock, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& messageStart);
 
 /** Functions for validating blocks and updating the block tree */
 
@@ -443,6 +467,9 @@ extern CChain chainActive;
 /** Global variable that points to the coins database (protected by cs_main) */
 extern CCoinsViewDB *pcoinsdbview;
 
+/** Global variable that points to the layer writing flushes of pcoinsTip to pcoinsdbview in the background, if any (protected by cs_main) */
+extern CCoinsViewBackgroundFlush *pcoinsflushview;
+
 /** Global variable that points to the active CCoinsView (protected by cs_main) */
 extern CCoinsViewCache *pcoinsTip;
 